@@ -32,6 +32,7 @@ class CuraEngineConan(ConanFile):
         "enable_plugins": [True, False],
         "enable_sentry": [True, False],
         "enable_remote_plugins": [True, False],
+        "enable_gcode_compression": [True, False],
         "with_cura_resources": [True, False],
     }
     default_options = {
@@ -41,6 +42,7 @@ class CuraEngineConan(ConanFile):
         "enable_plugins": True,
         "enable_sentry": False,
         "enable_remote_plugins": False,
+        "enable_gcode_compression": False,
         "with_cura_resources": False,
     }
 
@@ -131,6 +133,8 @@ class CuraEngineConan(ConanFile):
         self.requires("fmt/10.1.1")
         self.requires("range-v3/0.12.0")
         self.requires("zlib/1.2.12")
+        if self.options.enable_gcode_compression:
+            self.requires("zstd/1.5.5")
         self.requires("openssl/3.2.0")
         self.requires("mapbox-wagyu/0.5.0@ultimaker/stable")
 
@@ -146,6 +150,7 @@ class CuraEngineConan(ConanFile):
         tc.variables["EXTENSIVE_WARNINGS"] = self.options.enable_extensive_warnings
         tc.variables["OLDER_APPLE_CLANG"] = self.settings.compiler == "apple-clang" and Version(self.settings.compiler.version) < "14"
         tc.variables["ENABLE_THREADING"] = not (self.settings.arch == "wasm" and self.settings.os == "Emscripten")
+        tc.variables["ENABLE_GCODE_COMPRESSION"] = self.options.enable_gcode_compression
         if self.options.get_safe("enable_sentry", False):
             tc.variables["ENABLE_SENTRY"] = True
             tc.variables["SENTRY_URL"] = self.conf.get("user.curaengine:sentry_url", "", check_type=str)
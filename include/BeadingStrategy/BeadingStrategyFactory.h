@@ -4,6 +4,7 @@
 #ifndef BEADING_STRATEGY_FACTORY_H
 #define BEADING_STRATEGY_FACTORY_H
 
+#include <memory>
 #include <numbers>
 
 #include "BeadingStrategy.h"
@@ -29,6 +30,37 @@ public:
         const coord_t outer_wall_offset = 0,
         const int inward_distributed_center_wall_count = 2,
         const Ratio minimum_variable_line_ratio = 0.5);
+
+    /*!
+     * Get a strategy like \ref makeStrategy would make, which caches its
+     * beadings.
+     *
+     * The same strategy is returned for the same parameters until
+     * \ref clearSharedStrategies is called, so all layers and meshes with the
+     * same wall settings share the cached beadings. The strategy may be used
+     * from multiple threads at once.
+     */
+    static std::shared_ptr<const BeadingStrategy> makeSharedStrategy(
+        const coord_t preferred_bead_width_outer = MM2INT(0.5),
+        const coord_t preferred_bead_width_inner = MM2INT(0.5),
+        const coord_t preferred_transition_length = MM2INT(0.4),
+        const double transitioning_angle = std::numbers::pi / 4.0,
+        const bool print_thin_walls = false,
+        const coord_t min_bead_width = 0,
+        const coord_t min_feature_size = 0,
+        const Ratio wall_split_middle_threshold = 0.5_r,
+        const Ratio wall_add_middle_threshold = 0.5_r,
+        const coord_t max_bead_count = 0,
+        const coord_t outer_wall_offset = 0,
+        const int inward_distributed_center_wall_count = 2,
+        const Ratio minimum_variable_line_ratio = 0.5);
+
+    /*!
+     * Forget the strategies made by \ref makeSharedStrategy, logging how well
+     * their caches did. Strategies still in use stay alive until they're no
+     * longer used.
+     */
+    static void clearSharedStrategies();
 };
 
 } // namespace cura
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CACHING_BEADING_STRATEGY_H
+#define CACHING_BEADING_STRATEGY_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "BeadingStrategy.h"
+
+namespace cura
+{
+
+/*!
+ * This is a meta-strategy that remembers the beadings computed by another
+ * beading strategy, so that computing the same beading again is only a lookup.
+ *
+ * The walls of all layers of a mesh are generated with the same settings, and
+ * many of the thicknesses that the skeletal trapezoidation asks beadings for
+ * recur, e.g. at the optimal thickness for each bead count. A cached beading is
+ * the same as the one computed by the parent strategy, so the cache doesn't
+ * change the result.
+ *
+ * The cache may be used from multiple threads at once. It holds a limited
+ * number of beadings. Once it's full, beadings that aren't in the cache yet are
+ * computed by the parent each time.
+ */
+class CachingBeadingStrategy : public BeadingStrategy
+{
+public:
+    /*!
+     * \param parent The strategy to compute the beadings with.
+     * \param max_size How many beadings to remember at most.
+     */
+    CachingBeadingStrategy(BeadingStrategyPtr parent, const size_t max_size = 1 << 16);
+
+    virtual ~CachingBeadingStrategy() override = default;
+
+    Beading compute(coord_t thickness, coord_t bead_count) const override;
+    coord_t getOptimalThickness(coord_t bead_count) const override;
+    coord_t getTransitionThickness(coord_t lower_bead_count) const override;
+    coord_t getOptimalBeadCount(coord_t thickness) const override;
+    coord_t getTransitioningLength(coord_t lower_bead_count) const override;
+    double getTransitionAnchorPos(coord_t lower_bead_count) const override;
+    std::vector<coord_t> getNonlinearThicknesses(coord_t lower_bead_count) const override;
+    std::string toString() const override;
+
+    /*!
+     * How many beadings were found in the cache.
+     */
+    size_t getHits() const;
+
+    /*!
+     * How many beadings had to be computed by the parent strategy.
+     */
+    size_t getMisses() const;
+
+protected:
+    struct KeyHash
+    {
+        size_t operator()(const std::pair<coord_t, coord_t>& key) const;
+    };
+
+    /*!
+     * A part of the cache with its own lock, so that threads looking up
+     * different beadings hardly ever wait for each other.
+     */
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::pair<coord_t, coord_t>, Beading, KeyHash> beadings; //!< The beadings by thickness and bead count.
+    };
+    static constexpr size_t shard_count_ = 16;
+
+    const BeadingStrategyPtr parent_;
+    const size_t max_shard_size_; //!< How many beadings each shard may hold.
+    mutable std::array<Shard, shard_count_> shards_;
+    mutable std::atomic<size_t> hits_{ 0 };
+    mutable std::atomic<size_t> misses_{ 0 };
+};
+
+} // namespace cura
+#endif // CACHING_BEADING_STRATEGY_H
@@ -0,0 +1,118 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#ifndef COMPACT_MESH_H
+#define COMPACT_MESH_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "geometry/Point3LL.h"
+
+namespace cura
+{
+
+class Mesh;
+
+/*!
+ * Read-only, memory-compact copy of the geometry of a finished Mesh, as used for slicing.
+ *
+ * Compared to a Mesh, this stores:
+ * - the vertex coordinates as separate X, Y and Z arrays (structure of arrays) instead of a Point3LL per vertex;
+ * - the coordinates as 32-bit offsets from the minimum of the bounding box whenever the mesh is small enough (which, in microns, is
+ *   practically always), falling back to full 64-bit coordinates otherwise;
+ * - the faces connected to each vertex as one offset array plus one index array (compressed sparse rows), instead of a vector per vertex.
+ *
+ * The Slicer and the AdaptiveLayerHeights read meshes through the accessors of this class, so the Mesh itself can be released before
+ * slicing.
+ */
+class CompactMesh
+{
+public:
+    /*!
+     * Copy the geometry of a mesh.
+     * \param mesh The mesh to copy. Its faces must already be connected, see Mesh::finish.
+     */
+    explicit CompactMesh(const Mesh& mesh);
+
+    size_t vertexCount() const
+    {
+        return vertex_face_offsets_.size() - 1;
+    }
+
+    size_t faceCount() const
+    {
+        return face_vertices_.size();
+    }
+
+    //! Get the location of a vertex.
+    Point3LL vertex(const size_t vertex_idx) const
+    {
+        if (is_32_bit_)
+        {
+            return Point3LL(origin_.x_ + x_32_[vertex_idx], origin_.y_ + y_32_[vertex_idx], origin_.z_ + z_32_[vertex_idx]);
+        }
+        return Point3LL(x_64_[vertex_idx], y_64_[vertex_idx], z_64_[vertex_idx]);
+    }
+
+    //! Get the Z coordinate of a vertex.
+    coord_t vertexZ(const size_t vertex_idx) const
+    {
+        return is_32_bit_ ? origin_.z_ + z_32_[vertex_idx] : z_64_[vertex_idx];
+    }
+
+    //! Get the index of a corner of a face. Corners are in counter-clockwise order.
+    uint32_t faceVertexIndex(const size_t face_idx, const size_t corner) const
+    {
+        return face_vertices_[face_idx][corner];
+    }
+
+    //! Get the location of a corner of a face.
+    Point3LL faceVertex(const size_t face_idx, const size_t corner) const
+    {
+        return vertex(face_vertices_[face_idx][corner]);
+    }
+
+    /*!
+     * Get the face connected to a face via one of its edges, see MeshFace::connected_face_index_.
+     * \return The connected face index, or -1 if the edge is not connected.
+     */
+    int connectedFace(const size_t face_idx, const size_t edge) const
+    {
+        return face_connections_[face_idx][edge];
+    }
+
+    //! Get the indices of all faces that have the given vertex as a corner, in increasing order.
+    std::span<const uint32_t> connectedFaces(const size_t vertex_idx) const
+    {
+        return { vertex_faces_.data() + vertex_face_offsets_[vertex_idx], vertex_faces_.data() + vertex_face_offsets_[vertex_idx + 1] };
+    }
+
+    //! Whether the coordinates are stored as 32-bit offsets.
+    bool is32Bit() const
+    {
+        return is_32_bit_;
+    }
+
+    //! The number of bytes allocated to store this geometry.
+    size_t memoryUsage() const;
+
+    //! Release all geometry, leaving an empty mesh.
+    void clear();
+
+private:
+    bool is_32_bit_; //!< Whether the coordinates are stored in the 32-bit offset arrays or in the 64-bit arrays.
+    Point3LL origin_; //!< What the 32-bit coordinates are relative to: the minimum of the bounding box of the mesh.
+    std::vector<int32_t> x_32_, y_32_, z_32_; //!< Vertex coordinates relative to origin_, if is_32_bit_.
+    std::vector<coord_t> x_64_, y_64_, z_64_; //!< Absolute vertex coordinates, if not is_32_bit_.
+    std::vector<std::array<uint32_t, 3>> face_vertices_; //!< The vertex indices of the corners of each face.
+    std::vector<std::array<int32_t, 3>> face_connections_; //!< The faces connected to each edge of each face.
+    std::vector<uint32_t> vertex_face_offsets_; //!< The faces of vertex n are vertex_faces_[vertex_face_offsets_[n] .. vertex_face_offsets_[n + 1]).
+    std::vector<uint32_t> vertex_faces_; //!< The faces connected to each vertex, concatenated.
+};
+
+} // namespace cura
+
+#endif // COMPACT_MESH_H
@@ -4,14 +4,17 @@
 #ifndef GCODE_WRITER_H
 #define GCODE_WRITER_H
 
-#include <fstream>
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include "ExtruderUse.h"
 #include "FanSpeedLayerTime.h"
 #include "GCodePathConfig.h"
 #include "LayerPlanBuffer.h"
 #include "gcodeExport.h"
+#include "utils/CompressedSink.h"
+#include "utils/FileDescriptorSink.h"
 #include "utils/NoCopy.h"
 #include "utils/gettime.h"
 
@@ -58,7 +61,14 @@ private:
     /*!
      * The gcode file to write to when using CuraEngine as command line tool.
      */
-    std::ofstream output_file;
+    std::unique_ptr<FileDescriptorSink> output_file;
+
+    /*!
+     * Compresses the g-code before it goes to \ref output_file, if the file
+     * name asks for it. Declared after the file so that it is completed before
+     * the file is closed.
+     */
+    std::unique_ptr<CompressedSink> output_compression;
 
     /*!
      * For each raft/filler layer, the extruders to be used in that layer in the order in which they are going to be used.
@@ -99,6 +109,9 @@ public:
      *
      * Used when CuraEngine is used as command line tool.
      *
+     * If the filename ends in ".gz" or ".zst", the g-code is compressed with
+     * gzip or zstd, provided that the engine is built with compression.
+     *
      * \param filename The filename of the file to which to write the gcode.
      */
     bool setTargetFile(const char* filename);
@@ -112,6 +125,13 @@ public:
      */
     void setTargetStream(std::ostream* stream);
 
+    /*!
+     * Set the target to write gcode to: a sink, which must outlive its use.
+     *
+     * \param sink The sink to write gcode to.
+     */
+    void setTargetSink(GCodeSink* sink);
+
     /*!
      * Get the total extruded volume for a specific extruder in mm^3
      *
@@ -673,8 +693,11 @@ private:
 
     /*!
      * Add the end gcode and set all temperatures to zero.
+     *
+     * This completes the output, e.g. the file.
+     * \return Whether all g-code was written, or the output is incomplete.
      */
-    void finalize();
+    bool finalize();
 
     /*!
      * Calculate for each layer the index of the vertex that is considered to be the seam
@@ -14,7 +14,9 @@ class MeshGroup;
 class ProgressStageEstimator;
 class SliceDataStorage;
 class SliceMeshStorage;
+struct SkinSolidAreas;
 class TimeKeeper;
+class WallToolPathsCache;
 
 /*!
  * Primary stage in Fused Filament Fabrication processing: Polygons are generated.
@@ -131,8 +133,9 @@ private:
     /*!
      * \brief Generate the inset polygons which form the walls.
      * \param layer_nr The layer for which to generate the insets.
+     * \param walls_cache The walls generated for other layers of the mesh.
      */
-    void processWalls(SliceMeshStorage& mesh, size_t layer_nr);
+    void processWalls(SliceMeshStorage& mesh, size_t layer_nr, WallToolPathsCache& walls_cache);
 
     /*!
      * Generate the outline of the ooze shield.
@@ -145,8 +148,9 @@ private:
      * \param mesh Input and Output parameter: fetches the outline information (see SliceLayerPart::outline) and generates the other reachable field of the \p storage
      * \param layer_nr The layer for which to generate the skin areas.
      * \param process_infill Generate infill areas
+     * \param solid_areas The solid areas around each layer of the mesh, see \ref SkinInfillAreaComputation::computeSolidAreas
      */
-    void processSkinsAndInfill(SliceMeshStorage& mesh, const LayerIndex layer_nr, bool process_infill);
+    void processSkinsAndInfill(SliceMeshStorage& mesh, const LayerIndex layer_nr, bool process_infill, const SkinSolidAreas& solid_areas);
 
     /*!
      * Generate the polygons where the draft screen should be.
@@ -64,6 +64,13 @@ public:
      */
     void setTargetStream(std::ostream* stream);
 
+    /*!
+     * Set the target to write gcode to: a sink, which must outlive its use.
+     *
+     * \param sink The sink to write gcode to.
+     */
+    void setTargetSink(GCodeSink* sink);
+
     /*!
      * Get the total extruded volume for a specific extruder in mm^3
      * 
@@ -83,8 +90,9 @@ public:
 
     /*!
      * Add the end gcode and set all temperatures to zero.
+     * \return Whether all g-code was written, or the output is incomplete.
      */
-    void finalize();
+    bool finalize();
 };
 
 }//namespace cura
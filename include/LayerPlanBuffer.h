@@ -4,7 +4,12 @@
 #ifndef LAYER_PLAN_BUFFER_H
 #define LAYER_PLAN_BUFFER_H
 
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "Preheat.h"
@@ -57,6 +62,29 @@ class LayerPlanBuffer
      */
     std::list<LayerPlan*> buffer_;
 
+    /*!
+     * A layer of which the g-code was recorded (see GCodeExport::startRecording()), but not written out yet.
+     */
+    struct RecordedLayer
+    {
+        std::string gcode; //!< The recorded g-code, replaced by its text once rendered.
+        bool rendering = false; //!< Whether some thread took up rendering this layer.
+        bool rendered = false; //!< Whether \ref gcode holds the rendered text.
+    };
+
+    /*!
+     * The layers of which the g-code was recorded but not written out yet.
+     *
+     * When there are multiple threads, the g-code of the layers popped from the buffer is only recorded on the thread that writes the
+     * g-code. The recordings are rendered to text by the threads that plan the layers, see \ref renderRecordedLayers, and written out
+     * in order by the thread writing the g-code.
+     *
+     * The front is the lowest/oldest layer.
+     */
+    std::deque<std::unique_ptr<RecordedLayer>> recorded_layers_;
+    std::mutex recorded_layers_mutex_; //!< Protects \ref recorded_layers_.
+    std::condition_variable layer_rendered_; //!< Signaled whenever one of the \ref recorded_layers_ is rendered.
+
 public:
     LayerPlanBuffer(GCodeExport& gcode)
         : gcode_(gcode)
@@ -85,6 +113,15 @@ public:
      */
     void flush();
 
+    /*!
+     * Render the recorded g-code of the layers that no other thread took up yet.
+     *
+     * Meant to be called by the threads that plan the layers, so that the
+     * text of the g-code is rendered in parallel rather than by the single
+     * thread that writes the g-code.
+     */
+    void renderRecordedLayers();
+
 private:
     /*!
      * Process all layers in the buffer
@@ -97,6 +134,36 @@ private:
      */
     LayerPlan* processBuffer();
 
+    /*!
+     * Write a layer popped from the buffer to gcode and delete it.
+     *
+     * With multiple threads, its g-code is only recorded, to be rendered to
+     * text in parallel and written out once all layers before it are.
+     *
+     * \param layer_plan The layer to write.
+     * \param gcode The exporter with which to write the layer.
+     */
+    void writeLayer(LayerPlan* layer_plan, GCodeExport& gcode);
+
+    /*!
+     * Render the recorded g-code of the oldest layer that no thread took up
+     * yet.
+     *
+     * \param lock The lock on \ref recorded_layers_mutex_. Released while
+     * rendering.
+     * \return Whether there was such a layer.
+     */
+    bool renderRecordedLayer(std::unique_lock<std::mutex>& lock);
+
+    /*!
+     * Write out the recorded layers at the front that are rendered already.
+     *
+     * \param gcode The exporter to write the rendered g-code with.
+     * \param lock The lock on \ref recorded_layers_mutex_. Released while
+     * writing.
+     */
+    void writeRenderedLayers(GCodeExport& gcode, std::unique_lock<std::mutex>& lock);
+
     /*!
      * Add the travel move to properly travel from the end location of the previous layer to the starting location of the next
      *
@@ -21,6 +21,8 @@
 #include "path_ordering.h"
 #include "settings/EnumSettings.h" //To get the seam settings.
 #include "settings/ZSeamConfig.h" //To read the seam configuration.
+#include "utils/LRUCache.h" //To remember combing distances.
+#include "utils/PathVertexGrid.h" //To find the nearest path quickly.
 #include "utils/linearAlg2D.h" //To find the angle of corners to hide seams.
 #include "utils/polygonUtils.h"
 #include "utils/views/dfs.h"
@@ -179,29 +181,6 @@ public:
             }
         }
 
-        // Add all vertices to a bucket grid so that we can find nearby endpoints quickly.
-        const coord_t snap_radius = 10_mu; // 0.01mm grid cells. Chaining only needs to consider polylines which are next to each other.
-        SparsePointGridInclusive<size_t> line_bucket_grid(snap_radius);
-        for (const auto& [i, path] : paths_ | ranges::views::enumerate)
-        {
-            if (path.converted_->empty())
-            {
-                continue;
-            }
-            if (path.is_closed_)
-            {
-                for (const Point2LL& point : *path.converted_)
-                {
-                    line_bucket_grid.insert(point, i); // Store by index so that we can also mark them down in the `picked` vector.
-                }
-            }
-            else // For polylines, only insert the endpoints. Those are the only places we can start from so the only relevant vertices to be near to.
-            {
-                line_bucket_grid.insert(path.converted_->front(), i);
-                line_bucket_grid.insert(path.converted_->back(), i);
-            }
-        }
-
         // For some Z seam types the start position can be pre-computed.
         // This is faster since we don't need to re-compute the start position at each step then.
         precompute_start &= seam_config_.type_ == EZSeamType::RANDOM || seam_config_.type_ == EZSeamType::USER_SPECIFIED || seam_config_.type_ == EZSeamType::SHARPEST_CORNER;
@@ -221,7 +200,7 @@ public:
 
         if (order_requirements_->empty())
         {
-            optimized_order = getOptimizedOrder(line_bucket_grid, snap_radius);
+            optimized_order = getOptimizedOrder();
         }
         else
         {
@@ -240,6 +219,7 @@ public:
         }
 
         combing_grid_.reset();
+        combing_distances_.clear();
     }
 
 protected:
@@ -259,6 +239,17 @@ protected:
      */
     std::unique_ptr<LocToLineGrid> combing_grid_;
 
+    /*!
+     * The most recently computed combing distances, by start and end point.
+     *
+     * The same travels get evaluated repeatedly, e.g. first to choose which
+     * end of a polyline to start at and then to compare that polyline to the
+     * other candidates. They are keyed by their points rather than by the
+     * parts they connect, since the travel between two parts depends on where
+     * on those parts it starts and ends.
+     */
+    LRUCache<std::pair<Point2LL, Point2LL>, coord_t> combing_distances_{ 4096 };
+
     /*!
      * Boundary to avoid when making travel moves.
      */
@@ -297,60 +288,107 @@ protected:
      */
     const std::unordered_multimap<Path, Path>* order_requirements_;
 
-    std::vector<OrderablePath> getOptimizedOrder(SparsePointGridInclusive<size_t> line_bucket_grid, size_t snap_radius)
+    /*!
+     * Order the paths by repeatedly going to the nearest path that isn't
+     * printed yet.
+     *
+     * The vertices where paths can start are kept in a grid, from which the
+     * printed paths are removed. Finding the nearest path then only needs to
+     * look around the current position, rather than at all paths.
+     */
+    std::vector<OrderablePath> getOptimizedOrder()
     {
         std::vector<OrderablePath> optimized_order; // To store our result in.
+        optimized_order.reserve(paths_.size());
 
-        Point2LL current_position = start_point_;
-
-        std::unordered_map<OrderablePath*, bool> picked(paths_.size()); // Fixed size boolean flag for whether each path is already in the optimized vector.
-
-        auto notPicked = [&picked](OrderablePath* c)
-        {
-            return ! picked[c];
-        };
-
-        while (optimized_order.size() < paths_.size())
+        std::vector<PathVertexGrid::Vertex> vertices;
+        for (const auto& [i, path] : paths_ | ranges::views::enumerate)
         {
-            // Use bucket grid to find paths within snap_radius
-            std::vector<OrderablePath*> nearby_candidates;
-            for (const auto i : line_bucket_grid.getNearbyVals(current_position, snap_radius))
-            {
-                nearby_candidates.push_back(&paths_[i]); // Convert bucket indexes to corresponding paths
-            }
-
-            std::vector<OrderablePath*> available_candidates;
-            available_candidates.reserve(nearby_candidates.size());
-            for (auto candidate : nearby_candidates | ranges::views::filter(notPicked))
+            if (path.converted_->empty())
             {
-                available_candidates.push_back(candidate);
+                continue;
             }
-
-            if (available_candidates.empty()) // We need to broaden our search through all candidates
+            if (path.is_closed_)
             {
-                for (auto path : paths_ | ranges::views::addressof | ranges::views::filter(notPicked))
+                for (const Point2LL& point : *path.converted_)
                 {
-                    available_candidates.push_back(path);
+                    vertices.push_back({ point, i });
                 }
             }
+            else // For polylines, only insert the endpoints. Those are the only places we can start from so the only relevant vertices to be near to.
+            {
+                vertices.push_back({ path.converted_->front(), i });
+                vertices.push_back({ path.converted_->back(), i });
+            }
+        }
+        PathVertexGrid vertex_grid(std::move(vertices), paths_.size());
 
-            auto best_candidate = findClosestPath(current_position, available_candidates);
+        Point2LL current_position = start_point_;
 
-            auto best_path = best_candidate;
-            optimized_order.push_back(*best_path);
-            picked[best_path] = true;
+        // A path's start location and distance are computed once per step, even if several of its vertices are found.
+        std::vector<size_t> evaluated_in_step(paths_.size(), std::numeric_limits<size_t>::max());
 
-            if (! best_path->converted_->empty()) // If all paths were empty, the best path is still empty. We don't upate the current position then.
+        for (size_t step = 0; ! vertex_grid.empty(); ++step)
+        {
+            size_t best_index = 0;
+            coord_t best_distance2 = std::numeric_limits<coord_t>::max();
+            bool found = false;
+            const auto consider = [&](const size_t i)
             {
-                if (best_path->is_closed_)
+                if (evaluated_in_step[i] == step)
                 {
-                    current_position = (*best_path->converted_)[best_path->start_vertex_]; // We end where we started.
+                    return;
                 }
-                else
+                evaluated_in_step[i] = step;
+                const coord_t distance2 = getStartDistance(paths_[i], current_position, best_distance2);
+                if (! found || distance2 < best_distance2 || (distance2 == best_distance2 && i < best_index)) // Ties go to the first path, as with a linear search.
                 {
-                    // Pick the other end from where we started.
-                    current_position = best_path->start_vertex_ == 0 ? best_path->converted_->back() : best_path->converted_->front();
+                    best_index = i;
+                    best_distance2 = distance2;
+                    found = true;
                 }
+            };
+
+            const coord_t snap_radius = 10_mu; // Chaining only needs to consider polylines which are next to each other.
+            for (const size_t i : vertex_grid.getNearbyPaths(current_position, snap_radius))
+            {
+                consider(i);
+            }
+            if (! found) // We need to broaden our search.
+            {
+                vertex_grid.visitNearestFirst(
+                    current_position,
+                    [&](const PathVertexGrid::Vertex& vertex)
+                    {
+                        if (getDirectDistance(vertex.point, current_position) <= best_distance2) // The start can't be closer than any vertex of the path.
+                        {
+                            consider(vertex.path);
+                        }
+                        return best_distance2;
+                    });
+            }
+
+            OrderablePath* best_path = &paths_[best_index];
+            optimized_order.push_back(*best_path);
+            vertex_grid.remove(best_index);
+
+            if (best_path->is_closed_)
+            {
+                current_position = (*best_path->converted_)[best_path->start_vertex_]; // We end where we started.
+            }
+            else
+            {
+                // Pick the other end from where we started.
+                current_position = best_path->start_vertex_ == 0 ? best_path->converted_->back() : best_path->converted_->front();
+            }
+        }
+
+        // Paths without vertices can't really be planned in. Put them at the end.
+        for (const OrderablePath& path : paths_)
+        {
+            if (path.converted_->empty())
+            {
+                optimized_order.push_back(path);
             }
         }
 
@@ -566,6 +604,50 @@ protected:
         return best_candidate->vertices_;
     }
 
+    /*!
+     * Find where to start a path when coming from a position, and how far it
+     * is to travel there.
+     *
+     * This sets the start vertex of the path, unless it was pre-computed.
+     * \param path A path with vertices.
+     * \param start_position Where the travel starts.
+     * \param best_distance2 The squared distance to the best candidate so far.
+     * Combing distances are only computed if the direct distance isn't longer.
+     * \return The squared travel distance, or a lower bound of it that is
+     * larger than \p best_distance2. In the latter case, the start vertex isn't
+     * updated.
+     */
+    coord_t getStartDistance(OrderablePath& path, const Point2LL& start_position, const coord_t best_distance2)
+    {
+        if (combing_boundary_ && ! path.is_closed_)
+        {
+            // Choosing the end of a polyline computes combing distances to both ends. Skip that if neither end can beat the best candidate.
+            const coord_t lower_bound = std::min(getDirectDistance(start_position, path.converted_->front()), getDirectDistance(start_position, path.converted_->back()));
+            if (lower_bound > best_distance2)
+            {
+                return lower_bound;
+            }
+        }
+        const bool precompute_start
+            = seam_config_.type_ == EZSeamType::RANDOM || seam_config_.type_ == EZSeamType::USER_SPECIFIED || seam_config_.type_ == EZSeamType::SHARPEST_CORNER;
+        if (! path.is_closed_ || ! precompute_start) // Find the start location unless we've already precomputed it.
+        {
+            path.start_vertex_ = findStartLocation(path, start_position);
+            if (! path.is_closed_) // Open polylines start at vertex 0 or vertex N-1. Indicate that they should be reversed if they start at N-1.
+            {
+                path.backwards_ = path.start_vertex_ > 0;
+            }
+        }
+        const Point2LL candidate_position = (*path.converted_)[path.start_vertex_];
+        coord_t distance2 = getDirectDistance(start_position, candidate_position);
+        if (distance2 <= best_distance2
+            && combing_boundary_) // If direct distance is longer than best combing distance, the combing distance can never be better, so only compute combing if necessary.
+        {
+            distance2 = getCombingDistance(start_position, candidate_position);
+        }
+        return distance2;
+    }
+
     OrderablePath* findClosestPath(Point2LL start_position, std::vector<OrderablePath*> candidate_paths)
     {
         coord_t best_distance2 = std::numeric_limits<coord_t>::max();
@@ -582,23 +664,7 @@ protected:
                 continue;
             }
 
-            const bool precompute_start
-                = seam_config_.type_ == EZSeamType::RANDOM || seam_config_.type_ == EZSeamType::USER_SPECIFIED || seam_config_.type_ == EZSeamType::SHARPEST_CORNER;
-            if (! path->is_closed_ || ! precompute_start) // Find the start location unless we've already precomputed it.
-            {
-                path->start_vertex_ = findStartLocation(*path, start_position);
-                if (! path->is_closed_) // Open polylines start at vertex 0 or vertex N-1. Indicate that they should be reversed if they start at N-1.
-                {
-                    path->backwards_ = path->start_vertex_ > 0;
-                }
-            }
-            const Point2LL candidate_position = (*path->converted_)[path->start_vertex_];
-            coord_t distance2 = getDirectDistance(start_position, candidate_position);
-            if (distance2 < best_distance2
-                && combing_boundary_) // If direct distance is longer than best combing distance, the combing distance can never be better, so only compute combing if necessary.
-            {
-                distance2 = getCombingDistance(start_position, candidate_position);
-            }
+            const coord_t distance2 = getStartDistance(*path, start_position, best_distance2);
             if (distance2 < best_distance2) // Closer than the best candidate so far.
             {
                 best_candidate = path;
@@ -677,10 +743,10 @@ protected:
         {
             // For polylines, the seam settings are not applicable. Simply choose the position closest to target_pos then.
             const coord_t back_distance
-                = (combing_boundary_ == nullptr) ? getDirectDistance(path.converted_->back(), target_pos) : getCombingDistance(path.converted_->back(), target_pos);
+                = (combing_boundary_ == nullptr) ? getDirectDistance(path.converted_->back(), target_pos) : getCombingDistance(target_pos, path.converted_->back());
             if (back_distance < getDirectDistance(path.converted_->front(), target_pos)
                 || (combing_boundary_
-                    && back_distance < getCombingDistance(path.converted_->front(), target_pos))) // Lazy or: Only compute combing distance if direct distance is closer.
+                    && back_distance < getCombingDistance(target_pos, path.converted_->front()))) // Lazy or: Only compute combing distance if direct distance is closer.
             {
                 return path.converted_->size() - 1; // Back end is closer.
             }
@@ -898,7 +964,28 @@ protected:
      */
     coord_t getCombingDistance(const Point2LL& a, const Point2LL& b)
     {
-        if (! PolygonUtils::polygonCollidesWithLineSegment(*combing_boundary_, a, b))
+        if (const coord_t* cached = combing_distances_.find({ a, b }))
+        {
+            return *cached;
+        }
+        const coord_t distance2 = computeCombingDistance(a, b);
+        combing_distances_.insert({ a, b }, distance2);
+        return distance2;
+    }
+
+    /*!
+     * Calculate the combing distance between two points, without looking it
+     * up in \ref combing_distances_.
+     */
+    coord_t computeCombingDistance(const Point2LL& a, const Point2LL& b)
+    {
+        if (combing_grid_ == nullptr)
+        {
+            constexpr coord_t grid_size = 2000; // 2mm grid cells. Smaller will use more memory, but reduce chance of unnecessary collision checks.
+            combing_grid_ = PolygonUtils::createLocToLineGrid(*combing_boundary_, grid_size);
+        }
+
+        if (! PolygonUtils::polygonCollidesWithLineSegment(a, b, *combing_grid_))
         {
             return getDirectDistance(a, b); // No collision with any line. Just compute the direct distance then.
         }
@@ -910,12 +997,6 @@ protected:
             return getDirectDistance(a, b) * 5;
         }
 
-        if (combing_grid_ == nullptr)
-        {
-            constexpr coord_t grid_size = 2000; // 2mm grid cells. Smaller will use more memory, but reduce chance of unnecessary collision checks.
-            combing_grid_ = PolygonUtils::createLocToLineGrid(*combing_boundary_, grid_size);
-        }
-
         CombPath comb_path; // Output variable.
         constexpr coord_t rounding_error = -25;
         constexpr coord_t tiny_travel_threshold = 0;
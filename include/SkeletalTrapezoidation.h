@@ -4,6 +4,7 @@
 #ifndef SKELETAL_TRAPEZOIDATION_H
 #define SKELETAL_TRAPEZOIDATION_H
 
+#include <deque>
 #include <memory> // smart pointers
 #include <unordered_map>
 #include <utility> // pair
@@ -56,8 +57,9 @@ class SkeletalTrapezoidation
     using TransitionMiddle = SkeletalTrapezoidationEdge::TransitionMiddle;
     using TransitionEnd = SkeletalTrapezoidationEdge::TransitionEnd;
 
+    //! Storage with stable addresses, which only grows and is released all at once.
     template<typename T>
-    using ptr_vector_t = std::vector<std::shared_ptr<T>>;
+    using arena_t = std::deque<T>;
 
     AngleRadians transitioning_angle_; //!< How pointy a region should be before we apply the method. Equals 180* - limit_bisector_angle
     coord_t discretization_step_size_; //!< approximate size of segments when parabolic VD edges get discretized (and vertex-vertex edges)
@@ -152,6 +154,15 @@ protected:
     std::unordered_map<vd_t::edge_type*, edge_t*> vd_edge_to_he_edge_;
     std::unordered_map<vd_t::vertex_type*, node_t*> vd_node_to_he_node_;
 
+    /*!
+     * Storage of the data attached to the edges and nodes of \ref graph_,
+     * which refer to it by pointer. It's released together with the graph.
+     */
+    arena_t<std::list<TransitionMiddle>> edge_transitions_;
+    arena_t<std::list<TransitionEnd>> edge_transition_ends_; //!< Only mapped to the half edges going upward. The ends aren't sorted.
+    arena_t<BeadingPropagation> node_beadings_;
+    arena_t<LineJunctions> edge_junctions_; //!< Junctions ordered high R to low R.
+
     /*!
      * Compute the skeletal trapezoidation decomposition of the input shape.
      *
@@ -349,7 +360,7 @@ protected:
      * returned via the output parameter.
      * \param[out] edge_transitions A list of transitions that were generated.
      */
-    void generateTransitionMids(ptr_vector_t<std::list<TransitionMiddle>>& edge_transitions);
+    void generateTransitionMids(arena_t<std::list<TransitionMiddle>>& edge_transitions);
 
     /*!
      * Removes some transition middle points.
@@ -403,12 +414,12 @@ protected:
      * Generate the endpoints of all transitions for all edges in the graph.
      * \param[out] edge_transition_ends The resulting transition endpoints.
      */
-    void generateAllTransitionEnds(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void generateAllTransitionEnds(arena_t<std::list<TransitionEnd>>& edge_transition_ends);
 
     /*!
      * Also set the rest values at nodes in between the transition ends
      */
-    void applyTransitions(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void applyTransitions(arena_t<std::list<TransitionEnd>>& edge_transition_ends);
 
     /*!
      * Create extra edges along all edges, where it needs to transition from one
@@ -431,7 +442,7 @@ protected:
      * \param[out] edge_transition_ends A list of endpoints to add the new
      * endpoints to.
      */
-    void generateTransitionEnds(edge_t& edge, coord_t mid_R, coord_t transition_lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+    void generateTransitionEnds(edge_t& edge, coord_t mid_R, coord_t transition_lower_bead_count, arena_t<std::list<TransitionEnd>>& edge_transition_ends);
 
     /*!
      * Compute a single endpoint of a transition.
@@ -461,7 +472,7 @@ protected:
         Ratio start_rest,
         Ratio end_rest,
         coord_t transition_lower_bead_count,
-        ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends);
+        arena_t<std::list<TransitionEnd>>& edge_transition_ends);
 
     /*!
      * Determines whether an edge is going downwards or upwards in the graph.
@@ -531,7 +542,7 @@ protected:
      * \param upward_quad_mids all upward halfedges of the inner skeletal edges (not directly connected to the outline) sorted on their highest [distance_to_boundary]. Higher dist
      * first.
      */
-    void propagateBeadingsUpward(std::vector<edge_t*>& upward_quad_mids, ptr_vector_t<BeadingPropagation>& node_beadings);
+    void propagateBeadingsUpward(std::vector<edge_t*>& upward_quad_mids, arena_t<BeadingPropagation>& node_beadings);
 
     /*!
      * propagate beading info from higher R nodes to lower R nodes
@@ -545,12 +556,12 @@ protected:
      * \param upward_quad_mids all upward halfedges of the inner skeletal edges (not directly connected to the outline) sorted on their highest [distance_to_boundary]. Higher dist
      * first.
      */
-    void propagateBeadingsDownward(std::vector<edge_t*>& upward_quad_mids, ptr_vector_t<BeadingPropagation>& node_beadings);
+    void propagateBeadingsDownward(std::vector<edge_t*>& upward_quad_mids, arena_t<BeadingPropagation>& node_beadings);
 
     /*!
-     * Subroutine of \ref propagateBeadingsDownward(std::vector<edge_t*>&, ptr_vector_t<BeadingPropagation>&)
+     * Subroutine of \ref propagateBeadingsDownward(std::vector<edge_t*>&, arena_t<BeadingPropagation>&)
      */
-    void propagateBeadingsDownward(edge_t* edge_to_peak, ptr_vector_t<BeadingPropagation>& node_beadings);
+    void propagateBeadingsDownward(edge_t* edge_to_peak, arena_t<BeadingPropagation>& node_beadings);
 
     /*!
      * Find a beading in between two other beadings.
@@ -593,7 +604,7 @@ protected:
      * \param node_beadings A list of all beadings for nodes.
      * \return The beading of that node.
      */
-    std::shared_ptr<BeadingPropagation> getOrCreateBeading(node_t* node, ptr_vector_t<BeadingPropagation>& node_beadings);
+    BeadingPropagation* getOrCreateBeading(node_t* node, arena_t<BeadingPropagation>& node_beadings);
 
     /*!
      * In case we cannot find the beading of a node, get a beading from the
@@ -604,13 +615,13 @@ protected:
      * \return A beading for the node, or ``nullptr`` if there is no node nearby
      * with a beading.
      */
-    std::shared_ptr<BeadingPropagation> getNearestBeading(node_t* node, coord_t max_dist);
+    BeadingPropagation* getNearestBeading(node_t* node, coord_t max_dist);
 
     /*!
      * generate junctions for each bone
      * \param edge_to_junctions junctions ordered high R to low R
      */
-    void generateJunctions(ptr_vector_t<BeadingPropagation>& node_beadings, ptr_vector_t<LineJunctions>& edge_junctions);
+    void generateJunctions(arena_t<BeadingPropagation>& node_beadings, arena_t<LineJunctions>& edge_junctions);
 
     /*!
      * Add a new toolpath segment, defined between two extrusion-juntions.
@@ -627,7 +638,7 @@ protected:
     /*!
      * connect junctions in each quad
      */
-    void connectJunctions(ptr_vector_t<LineJunctions>& edge_junctions);
+    void connectJunctions(arena_t<LineJunctions>& edge_junctions);
 
     /*!
      * Genrate small segments for local maxima where the beading would only result in a single bead
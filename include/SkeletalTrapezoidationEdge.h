@@ -5,7 +5,6 @@
 #define SKELETAL_TRAPEZOIDATION_EDGE_H
 
 #include <list>
-#include <memory> // smart pointers
 #include <vector>
 
 #include "utils/ExtrusionJunction.h"
@@ -90,49 +89,50 @@ public:
 
     bool hasTransitions(bool ignore_empty = false) const
     {
-        return transitions_.use_count() > 0 && (ignore_empty || ! transitions_.lock()->empty());
+        return transitions_ != nullptr && (ignore_empty || ! transitions_->empty());
     }
-    void setTransitions(std::shared_ptr<std::list<TransitionMiddle>>& storage)
+    void setTransitions(std::list<TransitionMiddle>* storage)
     {
         transitions_ = storage;
     }
-    std::shared_ptr<std::list<TransitionMiddle>> getTransitions()
+    std::list<TransitionMiddle>* getTransitions()
     {
-        return transitions_.lock();
+        return transitions_;
     }
 
     bool hasTransitionEnds(bool ignore_empty = false) const
     {
-        return transition_ends_.use_count() > 0 && (ignore_empty || ! transition_ends_.lock()->empty());
+        return transition_ends_ != nullptr && (ignore_empty || ! transition_ends_->empty());
     }
-    void setTransitionEnds(std::shared_ptr<std::list<TransitionEnd>>& storage)
+    void setTransitionEnds(std::list<TransitionEnd>* storage)
     {
         transition_ends_ = storage;
     }
-    std::shared_ptr<std::list<TransitionEnd>> getTransitionEnds()
+    std::list<TransitionEnd>* getTransitionEnds()
     {
-        return transition_ends_.lock();
+        return transition_ends_;
     }
 
     bool hasExtrusionJunctions(bool ignore_empty = false) const
     {
-        return extrusion_junctions_.use_count() > 0 && (ignore_empty || ! extrusion_junctions_.lock()->empty());
+        return extrusion_junctions_ != nullptr && (ignore_empty || ! extrusion_junctions_->empty());
     }
-    void setExtrusionJunctions(std::shared_ptr<LineJunctions>& storage)
+    void setExtrusionJunctions(LineJunctions* storage)
     {
         extrusion_junctions_ = storage;
     }
-    std::shared_ptr<LineJunctions> getExtrusionJunctions()
+    LineJunctions* getExtrusionJunctions()
     {
-        return extrusion_junctions_.lock();
+        return extrusion_junctions_;
     }
 
     Central is_central; //! whether the edge is significant; whether the source segments have a sharp angle; -1 is unknown
 
 private:
-    std::weak_ptr<std::list<TransitionMiddle>> transitions_;
-    std::weak_ptr<std::list<TransitionEnd>> transition_ends_;
-    std::weak_ptr<LineJunctions> extrusion_junctions_;
+    // The storage for these is owned by the SkeletalTrapezoidation that this edge's graph belongs to.
+    std::list<TransitionMiddle>* transitions_ = nullptr;
+    std::list<TransitionEnd>* transition_ends_ = nullptr;
+    LineJunctions* extrusion_junctions_ = nullptr;
 };
 
 
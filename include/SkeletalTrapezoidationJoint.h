@@ -4,8 +4,6 @@
 #ifndef SKELETAL_TRAPEZOIDATION_JOINT_H
 #define SKELETAL_TRAPEZOIDATION_JOINT_H
 
-#include <memory> // smart pointers
-
 #include "BeadingStrategy/BeadingStrategy.h"
 #include "geometry/Point2LL.h"
 
@@ -45,19 +43,19 @@ public:
 
     bool hasBeading() const
     {
-        return beading_.use_count() > 0;
+        return beading_ != nullptr;
     }
-    void setBeading(std::shared_ptr<BeadingPropagation>& storage)
+    void setBeading(BeadingPropagation* storage)
     {
         beading_ = storage;
     }
-    std::shared_ptr<BeadingPropagation> getBeading()
+    BeadingPropagation* getBeading()
     {
-        return beading_.lock();
+        return beading_;
     }
 
 private:
-    std::weak_ptr<BeadingPropagation> beading_;
+    BeadingPropagation* beading_ = nullptr; //!< Owned by the SkeletalTrapezoidation that this joint's graph belongs to.
 };
 
 } // namespace cura
@@ -14,6 +14,8 @@
 #include "settings/EnumSettings.h" //To store whether X/Y or Z distance gets priority.
 #include "settings/types/LayerIndex.h" //Part of the RadiusLayerPair.
 #include "sliceDataStorage.h"
+#include "utils/AreaSpillStore.h"
+#include "utils/ShardedAreaCache.h"
 #include "utils/Simplify.h"
 
 namespace cura
@@ -57,6 +59,23 @@ public:
      */
     void precalculate(coord_t max_layer);
 
+    /*!
+     * \brief Spill cached areas to a compact form until the caches fit in the memory limit again, if there is one.
+     *
+     * As the trees are generated from the top down, the areas of the layers above the layer that is worked on are spilled first, and then
+     * those of the layers furthest below it. Spilled areas are loaded back when they are requested again.
+     *
+     * This invalidates references to cached areas, so no other thread may use the volumes meanwhile.
+     *
+     * \param active_layer The layer that is worked on.
+     */
+    void enforceMemoryLimit(LayerIndex active_layer);
+
+    /*!
+     * \brief Log how often each cache was used and how much memory it takes.
+     */
+    void logCacheStatistics();
+
     /*!
      * \brief Provides the areas that have to be avoided by the tree's branches to prevent collision with the model on this layer.
      *
@@ -337,7 +356,7 @@ private:
      * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
      */
     template<typename KEY>
-    const std::optional<std::reference_wrapper<const Shape>> getArea(const std::unordered_map<KEY, Shape>& cache, const KEY key) const;
+    const std::optional<std::reference_wrapper<const Shape>> getArea(const ShardedAreaCache<KEY>& cache, const KEY key) const;
 
     bool checkSettingsEquality(const Settings& me, const Settings& other) const;
 
@@ -348,10 +367,31 @@ private:
      *
      * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
      */
-    LayerIndex getMaxCalculatedLayer(coord_t radius, const std::unordered_map<RadiusLayerPair, Shape>& map) const;
+    LayerIndex getMaxCalculatedLayer(coord_t radius, const ShardedAreaCache<RadiusLayerPair>& map) const;
 
     static Shape calculateMachineBorderCollision(const Shape&& machine_border);
 
+    /*!
+     * \brief Call a function with each cache and its name.
+     */
+    template<typename Function>
+    void forEachCache(Function&& function)
+    {
+        function(collision_cache_, "collision");
+        function(collision_cache_holefree_, "collision holefree");
+        function(accumulated_placeables_cache_radius_0_, "accumulated placeables");
+        function(avoidance_cache_collision_, "avoidance collision");
+        function(avoidance_cache_, "avoidance");
+        function(avoidance_cache_slow_, "avoidance slow");
+        function(avoidance_cache_to_model_, "avoidance to model");
+        function(avoidance_cache_to_model_slow_, "avoidance to model slow");
+        function(placeable_areas_cache_, "placeable areas");
+        function(avoidance_cache_hole_, "avoidance holefree");
+        function(avoidance_cache_hole_to_model_, "avoidance holefree to model");
+        function(wall_restrictions_cache_, "wall restrictions");
+        function(wall_restrictions_cache_min_, "wall restrictions min");
+    }
+
     /*!
      * \brief The maximum distance that the center point of a tree branch may move in consecutive layers if it has to avoid the model.
      */
@@ -466,58 +506,44 @@ private:
      * \brief Caches for the collision, avoidance and areas on the model where support can be placed safely
      * at given radius and layer indices.
      *
-     * These are mutable to allow modification from const function. This is
-     * generally considered OK as the functions are still logically const
-     * (ie there is no difference in behaviour for the user between
-     * calculating the values each time vs caching the results).
+     * Each cache can be used from multiple threads at once. They are frozen once precalculation is finished, after which reading the
+     * precalculated areas takes no lock.
      */
-    mutable std::unordered_map<RadiusLayerPair, Shape> collision_cache_;
-    std::unique_ptr<std::mutex> critical_collision_cache_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> collision_cache_holefree_;
-    std::unique_ptr<std::mutex> critical_collision_cache_holefree_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<LayerIndex, Shape> accumulated_placeables_cache_radius_0_;
-    std::unique_ptr<std::mutex> critical_accumulated_placeables_cache_radius_0_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_collision_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_collision_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_slow_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_slow_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_to_model_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_to_model_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_to_model_slow_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_to_model_slow_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> placeable_areas_cache_;
-    std::unique_ptr<std::mutex> critical_placeable_areas_cache_ = std::make_unique<std::mutex>();
+    ShardedAreaCache<RadiusLayerPair> collision_cache_;
+    ShardedAreaCache<RadiusLayerPair> collision_cache_holefree_;
+    ShardedAreaCache<LayerIndex> accumulated_placeables_cache_radius_0_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_collision_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_slow_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_to_model_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_to_model_slow_;
+    ShardedAreaCache<RadiusLayerPair> placeable_areas_cache_;
 
     /*!
      * \brief Caches to avoid holes smaller than the radius until which the radius is always increased, as they are free of holes. Also called safe avoidances, as they are safe
      * regarding not running into holes.
      */
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_hole_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_holefree_ = std::make_unique<std::mutex>();
-
-    mutable std::unordered_map<RadiusLayerPair, Shape> avoidance_cache_hole_to_model_;
-    std::unique_ptr<std::mutex> critical_avoidance_cache_holefree_to_model_ = std::make_unique<std::mutex>();
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_hole_;
+    ShardedAreaCache<RadiusLayerPair> avoidance_cache_hole_to_model_;
 
     /*!
      * \brief Caches to represent walls not allowed to be passed over.
      */
-    mutable std::unordered_map<RadiusLayerPair, Shape> wall_restrictions_cache_;
-    std::unique_ptr<std::mutex> critical_wall_restrictions_cache_ = std::make_unique<std::mutex>();
+    ShardedAreaCache<RadiusLayerPair> wall_restrictions_cache_;
 
     // A different cache for min_xy_dist as the maximal safe distance an influence area can be increased(guaranteed overlap of two walls in consecutive layer) is much smaller when
     // min_xy_dist is used. This causes the area of the wall restriction to be thinner and as such just using the min_xy_dist wall restriction would be slower.
-    mutable std::unordered_map<RadiusLayerPair, Shape> wall_restrictions_cache_min_;
-    std::unique_ptr<std::mutex> critical_wall_restrictions_cache_min_ = std::make_unique<std::mutex>();
+    ShardedAreaCache<RadiusLayerPair> wall_restrictions_cache_min_;
+
+    /*!
+     * \brief How many bytes the cached areas may take up before some are spilled, or 0 to keep all of them in memory.
+     */
+    size_t cache_memory_limit_ = 0;
+
+    /*!
+     * \brief Where the spilled areas are kept, if there is a memory limit.
+     */
+    std::unique_ptr<AreaSpillStore> spill_store_;
 
     std::unique_ptr<std::mutex> critical_progress_ = std::make_unique<std::mutex>();
 
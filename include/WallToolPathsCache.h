@@ -0,0 +1,89 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef CURAENGINE_WALLTOOLPATHSCACHE_H
+#define CURAENGINE_WALLTOOLPATHSCACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "geometry/Shape.h"
+#include "utils/ExtrusionLine.h"
+#include "utils/LRUCache.h"
+#include "utils/section_type.h"
+
+namespace cura
+{
+class Settings;
+
+/*!
+ * Remembers the wall toolpaths generated for recent outlines, so that layers with the same outline can reuse them.
+ *
+ * Extruded shapes often have many consecutive layers with the same outline, or the same outline shifted to another position. An outline is
+ * stored relative to the minimum corner of its bounding box, and the toolpaths are generated for that normalised outline and shifted into
+ * place. So an outline gets the same walls wherever it is, whether they come from the cache or not, and regardless of the order in which
+ * the layers are processed.
+ *
+ * The cache may be used from multiple threads at once. All walls in it are generated with the same settings, e.g. those of one mesh.
+ */
+class WallToolPathsCache
+{
+public:
+    /*!
+     * The toolpaths of the walls of an outline.
+     */
+    struct Walls
+    {
+        std::vector<VariableWidthLines> toolpaths; //!< The toolpaths, binned by inset index.
+        Shape inner_contour; //!< The area inside of the walls.
+    };
+
+    /*!
+     * \param settings The settings to generate the walls with.
+     * \param capacity How many outlines to remember at most.
+     */
+    explicit WallToolPathsCache(const Settings& settings, const size_t capacity = 64);
+
+    /*!
+     * Get the walls of an outline, as WallToolPaths would generate them.
+     *
+     * The parameters are those of WallToolPaths.
+     */
+    Walls getWalls(
+        const Shape& outline,
+        const coord_t bead_width_0,
+        const coord_t bead_width_x,
+        const size_t inset_count,
+        const coord_t wall_0_inset,
+        const int layer_idx,
+        const SectionType section_type);
+
+    size_t getHits() const;
+    size_t getMisses() const;
+
+private:
+    /*!
+     * The walls of an outline, relative to the minimum corner of its bounding box.
+     */
+    struct Entry
+    {
+        Shape outline;
+        coord_t bead_width_0;
+        coord_t bead_width_x;
+        size_t inset_count;
+        coord_t wall_0_inset;
+        SectionType section_type;
+        Walls walls;
+    };
+
+    const Settings& settings_;
+    std::mutex mutex_; //!< Guards \ref entries_.
+    LRUCache<size_t, std::shared_ptr<const Entry>> entries_; //!< The entries by hash of their outline and parameters.
+    std::atomic<size_t> hits_{ 0 };
+    std::atomic<size_t> misses_{ 0 };
+};
+
+} // namespace cura
+#endif // CURAENGINE_WALLTOOLPATHSCACHE_H
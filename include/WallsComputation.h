@@ -14,6 +14,7 @@ namespace cura
 
 class SliceLayer;
 class SliceLayerPart;
+class WallToolPathsCache;
 
 /*!
  * Function container for computing the outer walls / insets / perimeters polygons of a layer
@@ -27,8 +28,10 @@ public:
      *
      * \param settings The per-mesh settings object to get setting values from.
      * \param layer_nr The layer index that these walls are generated for.
+     * \param walls_cache Walls generated for other layers with the same
+     * settings, to reuse for parts with the same outline. Optional.
      */
-    WallsComputation(const Settings& settings, const LayerIndex layer_nr);
+    WallsComputation(const Settings& settings, const LayerIndex layer_nr, WallToolPathsCache* walls_cache = nullptr);
 
     /*!
      * \brief Generates the walls / inner area for all parts in a layer.
@@ -52,6 +55,12 @@ private:
      */
     const LayerIndex layer_nr_;
 
+    /*!
+     * \brief Where to look for walls generated before for the same outline,
+     * if anywhere.
+     */
+    WallToolPathsCache* walls_cache_;
+
     /*!
      * Generates the walls / inner area for a single layer part.
      *
@@ -59,6 +68,18 @@ private:
      */
     void generateWalls(SliceLayerPart* part, SectionType section);
 
+    /*!
+     * Generates the wall toolpaths and the inner area of a single layer part,
+     * or takes them from the cache.
+     */
+    void generateWallToolPaths(
+        SliceLayerPart* part,
+        const coord_t line_width_0,
+        const coord_t line_width_x,
+        const size_t wall_count,
+        const coord_t wall_0_inset,
+        const SectionType section_type);
+
     /*!
      * Generates the outer inset / perimeter used in spiralize mode for a single layer part. The spiral inset is
      * generated using offsets.
@@ -8,8 +8,7 @@
 #include "ArcusCommunication.h" //We're adding a subclass to this.
 #include "SliceDataStruct.h"
 #include "settings/types/LayerIndex.h"
-
-#include <sstream> //For ostringstream.
+#include "utils/GCodeSink.h"
 
 namespace cura
 {
@@ -49,7 +48,7 @@ public:
     Arcus::Socket* socket; //!< Socket to send data to.
     size_t object_count; //!< Number of objects that need to be sliced.
     std::string temp_gcode_file; //!< Temporary buffer for the g-code.
-    std::ostringstream gcode_output_stream; //!< The stream to write g-code to.
+    MemorySink gcode_output; //!< Collects the g-code until it is sent. Its memory is reused for every chunk.
 
     SliceDataStruct<cura::proto::Layer> sliced_layers;
     SliceDataStruct<cura::proto::LayerOptimized> optimized_layers;
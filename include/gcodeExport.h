@@ -19,6 +19,7 @@
 #include "settings/types/Velocity.h"
 #include "timeEstimate.h"
 #include "utils/AABB3D.h" //To track the used build volume for the Griffin header.
+#include "utils/GCodeBuffer.h"
 #include "utils/NoCopy.h"
 
 namespace cura
@@ -117,7 +118,7 @@ private:
     std::string machine_name_;
     std::string slice_uuid_; //!< The UUID of the current slice.
 
-    std::ostream* output_stream_;
+    GCodeBuffer output_; //!< Formats the g-code and writes it to the output stream line by line.
     std::string new_line_;
 
     double current_e_value_; //!< The last E value written to gcode (in mm or mm^3)
@@ -248,6 +249,57 @@ public:
 
     void setOutputStream(std::ostream* stream);
 
+    /*!
+     * Write the g-code to a sink from now on, e.g. a file or a compressor.
+     * The sink must outlive its use by this exporter.
+     */
+    void setOutputSink(GCodeSink* sink);
+
+    /*!
+     * The sink that the g-code is written to.
+     */
+    const GCodeSink& getOutputSink() const;
+
+    /*!
+     * Write out all g-code that is still buffered, up to its final
+     * destination.
+     */
+    void flushOutput();
+
+    /*!
+     * Write out all g-code that is still buffered and complete the output,
+     * e.g. close the file. Nothing may be written after that.
+     * \return Whether all g-code reached its destination.
+     */
+    bool finishOutput();
+
+    /*!
+     * Record all g-code written from now on instead of writing it to the
+     * output stream, until stopRecording().
+     *
+     * Everything else, like the position, the E value and the print time
+     * estimates, is still updated as the g-code is written. Recording the
+     * g-code of a layer thus gives the same state as writing it, while the text
+     * of the layer can be rendered later, on another thread, with
+     * GCodeBuffer::render().
+     */
+    void startRecording();
+
+    /*!
+     * Stop recording the g-code.
+     *
+     * \return The g-code recorded since startRecording(), see
+     * GCodeBuffer::render().
+     */
+    std::string stopRecording();
+
+    /*!
+     * Write text rendered from a recording to the output stream.
+     *
+     * \param gcode The rendered g-code.
+     */
+    void writeRendered(const std::string_view gcode);
+
     bool getExtruderIsUsed(const int extruder_nr) const; //!< return whether the extruder has been used throughout printing all meshgroup up till now
 
     Point2LL getGcodePos(const coord_t x, const coord_t y, const int extruder_train) const;
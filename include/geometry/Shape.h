@@ -4,6 +4,10 @@
 #ifndef GEOMETRY_SHAPE_H
 #define GEOMETRY_SHAPE_H
 
+#include <concepts>
+#include <ranges>
+#include <vector>
+
 #include "geometry/LinesSet.h"
 #include "geometry/Polygon.h"
 #include "settings/types/Angle.h"
@@ -75,6 +79,40 @@ public:
 
     [[nodiscard]] Shape intersection(const Shape& other) const;
 
+    /*!
+     * Union any number of shapes at once.
+     *
+     * All shapes are handed to a single clipper execution, which is much faster than unioning them one by one, because then the growing
+     * result is clipped over and over again.
+     *
+     * \param shapes The shapes to union. Null pointers are not allowed.
+     * \param fill_type The fill rule to apply to all shapes together.
+     */
+    [[nodiscard]] static Shape unionAll(const std::vector<const Shape*>& shapes, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero);
+
+    template<std::ranges::range ShapeRange>
+    requires std::convertible_to<std::ranges::range_reference_t<const ShapeRange>, const Shape&>
+    [[nodiscard]] static Shape unionAll(const ShapeRange& shapes, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero)
+    {
+        return unionAll(toPointers(shapes), fill_type);
+    }
+
+    /*!
+     * Subtract any number of shapes at once.
+     *
+     * This gives the same result as subtracting the shapes one by one, but the result is only clipped once, rather than once per shape.
+     *
+     * \param others The shapes to subtract. Null pointers are not allowed.
+     */
+    [[nodiscard]] Shape differenceAll(const std::vector<const Shape*>& others) const;
+
+    template<std::ranges::range ShapeRange>
+    requires std::convertible_to<std::ranges::range_reference_t<const ShapeRange>, const Shape&>
+    [[nodiscard]] Shape differenceAll(const ShapeRange& others) const
+    {
+        return differenceAll(toPointers(others));
+    }
+
     /*!
      *  @brief Overridden definition of LinesSet<Polygon>::offset()
      *  @note The behavior of this method is exactly the same, but it just exists because it allows
@@ -265,6 +303,17 @@ public:
 #endif
 
 private:
+    template<std::ranges::range ShapeRange>
+    static std::vector<const Shape*> toPointers(const ShapeRange& shapes)
+    {
+        std::vector<const Shape*> pointers;
+        for (const Shape& shape : shapes)
+        {
+            pointers.push_back(&shape);
+        }
+        return pointers;
+    }
+
     /*!
      * recursive part of \ref Polygons::removeEmptyHoles and \ref Polygons::getEmptyHoles
      * \param node The node of the polygons part to process
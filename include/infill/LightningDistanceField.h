@@ -4,6 +4,8 @@
 #ifndef LIGHTNING_DISTANCE_FIELD_H
 #define LIGHTNING_DISTANCE_FIELD_H
 
+#include <list>
+
 #include "../utils/SquareGrid.h" //Tracking for each location the distance to overhang.
 #include "geometry/Polygon.h" //Using outlines to fill and tracking overhang.
 
@@ -57,6 +57,14 @@ public:
     const LightningLayer& getTreesForLayer(const size_t& layer_id) const;
 
 protected:
+    /*!
+     * Calculate the area to fill with infill on each layer, i.e. the infill
+     * areas of the mesh without the infill walls.
+     *
+     * The layers are computed in parallel.
+     */
+    std::vector<Shape> generateInfillOutlines(const SliceMeshStorage& mesh) const;
+
     /*!
      * Calculate the overhangs above the infill areas that need to be supported
      * by infill.
@@ -64,13 +72,28 @@ protected:
      * Normally, overhangs are only generated for the outside of the model and
      * only when support is generated. For this pattern, we also need to
      * generate overhang areas for the inside of the model.
+     * \param infill_outlines For each layer, the area to fill with infill.
      */
-    void generateInitialInternalOverhangs(const SliceMeshStorage& mesh);
+    void generateInitialInternalOverhangs(const std::vector<Shape>& infill_outlines);
 
     /*!
      * Calculate the tree structure of all layers.
+     * \param infill_outlines For each layer, the area to fill with infill.
+     */
+    void generateTrees(const std::vector<Shape>& infill_outlines);
+
+    /*!
+     * Grow the trees of a single layer, starting from the trees propagated
+     * from the layer above.
+     *
+     * Islands of the infill area which are too far apart to affect each other's
+     * trees are grown in parallel.
+     * \param layer The trees of the layer, to be extended.
+     * \param overhang The overhang of the layer, to be supported by the trees.
+     * \param outlines The area to fill with infill on the layer.
+     * \param outlines_locator A grid to find nearby parts of the outlines.
      */
-    void generateTrees(const SliceMeshStorage& mesh);
+    void generateLayerTrees(LightningLayer& layer, const Shape& overhang, const Shape& outlines, const LocToLineGrid& outlines_locator) const;
 
     /*!
      * How far each piece of infill can support skin in the layer above.
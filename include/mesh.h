@@ -13,19 +13,17 @@ namespace cura
 /*!
 Vertex type to be used in a Mesh.
 
-Keeps track of which faces connect to it.
+The faces connected to each vertex are not tracked per vertex, to save memory. See CompactMesh::connectedFaces for that.
 */
 class MeshVertex
 {
 public:
     Point3LL p_; //!< location of the vertex
-    std::vector<uint32_t> connected_faces_; //!< list of the indices of connected faces
 
     MeshVertex(Point3LL p)
         : p_(p)
     {
-        connected_faces_.reserve(8);
-    } //!< doesn't set connected_faces
+    }
 };
 
 /*! A MeshFace is a 3 dimensional model triangle with 3 points. These points are already converted to integers
@@ -77,9 +75,20 @@ public:
     Mesh(Settings& parent);
     Mesh();
 
-    void addFace(Point3LL& v0, Point3LL& v1, Point3LL& v2); //!< add a face to the mesh without settings it's connected_faces.
+    void addFace(Point3LL& v0, Point3LL& v1, Point3LL& v2); //!< add a face to the mesh without settings it's connected_face_index.
+
+    /*!
+     * Add many faces at once, welding their vertices on the thread pool.
+     *
+     * The result is the same as calling \ref addFace for every consecutive triplet of \p corners, but the vertices are merged with a parallel
+     * sort of their melding cells instead of through the serial vertex hash map. Since that map is not filled, the mesh should be finished
+     * with \ref finish afterwards rather than receive more faces through \ref addFace.
+     *
+     * \param corners The corners of the faces, three per face, counter-clockwise.
+     */
+    void addFaces(const std::vector<Point3LL>& corners);
     void clear(); //!< clears all data
-    void finish(); //!< complete the model : set the connected_face_index fields of the faces.
+    void finish(); //!< complete the model : set the connected_face_index fields of the faces, using the thread pool.
 
     Point3LL min() const; //!< min (in x,y and z) vertex of the bounding box
     Point3LL max() const; //!< max (in x,y and z) vertex of the bounding box
@@ -123,9 +132,28 @@ public:
      */
     bool canInterlock() const;
 
+    /*!
+     * Get the number of face edges for which \ref finish could not find exactly one unambiguous neighbouring face.
+     *
+     * This counts edges without any other face, edges shared by an even number of other faces and edges where the neighbour could not be
+     * decided. Each face that has such an edge is reported once for that edge.
+     */
+    size_t getDisconnectedEdgeCount() const
+    {
+        return disconnected_edge_count_;
+    }
+
+    /*!
+     * Get the number of times \ref finish found a face lying exactly on top of one of its neighbours around an edge.
+     */
+    size_t getOverlappingFaceCount() const
+    {
+        return overlapping_face_count_;
+    }
+
 private:
-    mutable bool has_disconnected_faces; //!< Whether it has been logged that this mesh contains disconnected faces
-    mutable bool has_overlapping_faces; //!< Whether it has been logged that this mesh contains overlapping faces
+    size_t disconnected_edge_count_ = 0; //!< Number of face edges without a unique neighbouring face, counted by finish()
+    size_t overlapping_face_count_ = 0; //!< Number of overlapping face pairs around an edge, counted by finish()
     int findIndexOfVertex(const Point3LL& v); //!< find index of vertex close to the given point, or create a new vertex and return its index.
 
     /*!
@@ -137,9 +165,19 @@ private:
      * \param idx1 the second vertex index
      * \param notFaceIdx the index of a face which shouldn't be returned
      * \param notFaceVertexIdx should be the third vertex of face \p notFaceIdx.
+     * \param edge_faces All faces that contain both \p idx0 and \p idx1 (including \p notFaceIdx), in increasing order.
+     * \param[out] disconnected_edges Incremented if no unique connected face could be found.
+     * \param[out] overlapping_faces Incremented for every candidate face that overlaps face \p notFaceIdx.
      * \return the face index of a face sharing the edge from \p idx0 to \p idx1
      */
-    int getFaceIdxWithPoints(int idx0, int idx1, int notFaceIdx, int notFaceVertexIdx) const;
+    int getFaceIdxWithPoints(
+        int idx0,
+        int idx1,
+        int notFaceIdx,
+        int notFaceVertexIdx,
+        const std::vector<int>& edge_faces,
+        size_t& disconnected_edges,
+        size_t& overlapping_faces) const;
 };
 
 } // namespace cura
@@ -11,6 +11,7 @@
 #include "geometry/Polygon.h"
 #include "geometry/SingleShape.h"
 #include "settings/types/LayerIndex.h" // To store the layer on which we comb.
+#include "utils/AABB.h"
 #include "utils/polygonUtils.h"
 
 namespace cura
@@ -47,6 +48,57 @@ class Comb
     friend class LinePolygonsCrossings;
 
 private:
+    /*!
+     * Lookups into the parts of an inside boundary.
+     *
+     * These are the same for every travel on the layer, so they are computed once when the Comb is created, instead of searching through the
+     * parts view and assembling the part again for every travel.
+     */
+    class PartIndex
+    {
+    public:
+        /*!
+         * A part of the inside boundary, together with what is needed to comb within it.
+         */
+        struct Part
+        {
+            SingleShape shape_; //!< The polygons of the part, its outline first.
+            std::vector<AABB> polygon_boxes_; //!< The bounding box of each polygon in \ref Part::shape_.
+        };
+
+        /*!
+         * Index the parts of an inside boundary.
+         * \param parts_view The parts view onto the inside boundary, which must outlive this index.
+         */
+        explicit PartIndex(const PartsView& parts_view);
+
+        /*!
+         * Get the index of the part of which the polygon with index \p poly_idx is part, like PartsView::getPartContaining, but in constant time.
+         *
+         * \param poly_idx The index of the polygon in the boundary.
+         * \param boundary_poly_idx Optional output parameter: The index of the outline polygon of the part in the boundary.
+         * \return The index of the part, or NO_INDEX if the polygon isn't in any part.
+         */
+        size_t getPartContaining(const size_t poly_idx, size_t* boundary_poly_idx = nullptr) const;
+
+        /*!
+         * Get a part, already assembled.
+         * \param part_idx The index of the part, or NO_INDEX to get an empty part.
+         */
+        const Part& getPart(const size_t part_idx) const;
+
+        /*!
+         * Check whether the polygon with index \p poly_idx is in the part with index \p part_idx.
+         */
+        bool isInPart(const size_t poly_idx, const size_t part_idx) const;
+
+    private:
+        const PartsView& parts_view_; //!< The parts view this index is computed from.
+        std::vector<size_t> part_of_polygon_; //!< For each polygon in the boundary, the index of the part it is in, or NO_INDEX.
+        std::vector<Part> parts_; //!< Each part, assembled from the polygons listed in the parts view.
+        Part empty_part_; //!< What to return for parts which don't exist.
+    };
+
     /*!
      * A crossing from the inside boundary to the outside boundary.
      *
@@ -58,7 +110,7 @@ private:
         bool dest_is_inside_; //!< Whether the startPoint or endPoint is inside the inside boundary
         Point2LL in_or_mid_; //!< The point on the inside boundary, or in between the inside and outside boundary if the start/end point isn't inside the inside boudary
         Point2LL out_; //!< The point on the outside boundary
-        SingleShape dest_part_; //!< The assembled inside-boundary SingleShape in which the dest_point lies. (will only be initialized when Crossing::dest_is_inside holds)
+        const PartIndex::Part* dest_part_{ nullptr }; //!< The inside-boundary part in which the dest_point lies. (will only be initialized when Crossing::dest_is_inside holds)
         std::optional<const Polygon*> dest_crossing_poly_; //!< The polygon of the part in which dest_point lies, which will be crossed (often will be the outside polygon)
         const Shape& boundary_inside_; //!< The inside boundary as in \ref Comb::boundary_inside
         const LocToLineGrid& inside_loc_to_line_; //!< The loc to line grid \ref Comb::inside_loc_to_line
@@ -83,10 +135,10 @@ private:
         /*!
          * Find the not-outside location (Combing::in_or_mid) of the crossing between to the outside boundary
          *
-         * \param partsView_inside Structured indices onto Comb::boundary_inside which shows which polygons belong to which part.
+         * \param parts_inside The parts of Comb::boundary_inside, showing which polygons belong to which part.
          * \param close_to[in] Try to get a crossing close to this point
          */
-        void findCrossingInOrMid(const PartsView& partsView_inside, const Point2LL close_to);
+        void findCrossingInOrMid(const PartIndex& parts_inside, const Point2LL close_to);
 
         /*!
          * Find the outside location (Combing::out)
@@ -140,12 +192,16 @@ private:
     Shape boundary_inside_optimal_; //!< The boundary within which to comb. (Will be reordered by the partsView_inside_optimal)
     const PartsView parts_view_inside_minimum_; //!< Structured indices onto boundary_inside_minimum which shows which polygons belong to which part.
     const PartsView parts_view_inside_optimal_; //!< Structured indices onto boundary_inside_optimal which shows which polygons belong to which part.
+    const PartIndex parts_inside_minimum_; //!< Lookups into the parts of boundary_inside_minimum, shared by all travels on this layer.
+    const PartIndex parts_inside_optimal_; //!< Lookups into the parts of boundary_inside_optimal, shared by all travels on this layer.
+    const std::vector<AABB> polygon_boxes_inside_optimal_; //!< The bounding box of each polygon in boundary_inside_optimal.
     std::unique_ptr<LocToLineGrid> inside_loc_to_line_minimum_; //!< The SparsePointGridInclusive mapping locations to line segments of the inner boundary.
     std::unique_ptr<LocToLineGrid> inside_loc_to_line_optimal_; //!< The SparsePointGridInclusive mapping locations to line segments of the inner boundary.
     std::unordered_map<size_t, Shape> boundary_outside_; //!< The boundary outside of which to stay to avoid collision with other layer parts. This is a pointer cause we only
                                                          //!< compute it when we move outside the boundary (so not when there is only a single part in the layer)
     std::unordered_map<size_t, Shape> model_boundary_; //!< The boundary of the model itself
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>> outside_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the outside boundary.
+    std::unordered_map<size_t, std::vector<AABB>> outside_polygon_boxes_; //!< The bounding box of each polygon in the outside boundary.
     std::unordered_map<size_t, std::unique_ptr<LocToLineGrid>>
         model_boundary_loc_to_line_; //!< The SparsePointGridInclusive mapping locations to line segments of the model boundary
     coord_t move_inside_distance_; //!< When using comb_boundary_inside_minimum for combing it tries to move points inside by this amount after calculating the path to move it from
@@ -156,6 +212,11 @@ private:
      */
     LocToLineGrid& getOutsideLocToLine(const ExtruderTrain& train);
 
+    /*!
+     * Get the bounding box of each polygon in the boundary_outside. Calculate them when they haven't been calculated yet.
+     */
+    const std::vector<AABB>& getOutsidePolygonBoxes(const ExtruderTrain& train);
+
     /*!
      * Get the boundary_outside, which is an offset from the outlines of all meshes in the layer. Calculate it when it hasn't been calculated yet.
      */
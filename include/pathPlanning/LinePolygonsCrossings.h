@@ -7,6 +7,7 @@
 #include "CombPath.h"
 #include "geometry/PointMatrix.h"
 #include "geometry/Polygon.h"
+#include "utils/AABB.h"
 #include "utils/polygonUtils.h"
 
 namespace cura
@@ -50,8 +51,17 @@ private:
 
     const Shape& boundary_; //!< The boundary not to cross during combing.
     LocToLineGrid& loc_to_line_grid_; //!< Mapping from locations to line segments of \ref LinePolygonsCrossings::boundary
+    const std::vector<AABB>* polygon_boxes_; //!< The bounding box of each polygon in \ref LinePolygonsCrossings::boundary, or nullptr to check every polygon.
     Point2LL start_point_; //!< The start point of the scanline.
     Point2LL end_point_; //!< The end point of the scanline.
+    AABB segment_box_; //!< The bounding box of the line segment from start to end point, expanded by \ref LinePolygonsCrossings::polygon_box_margin_.
+
+    /*!
+     * How far to expand the bounding box of the line segment before testing it against the bounding boxes of the polygons.
+     *
+     * The crossings are computed after rotating the points, which rounds them a little, so a polygon just touching the box may still be found to cross.
+     */
+    static constexpr coord_t polygon_box_margin_ = 10;
 
     int64_t dist_to_move_boundary_point_outside_; //!< The distance used to move outside or inside so that a boundary point doesn't intersect with the boundary anymore. Neccesary
                                                   //!< due to computational rounding problems. Use negative value for insicde combing.
@@ -78,6 +88,14 @@ private:
      */
     bool calcScanlineCrossings(bool fail_on_unavoidable_obstacles);
 
+    /*!
+     * Check whether a polygon of the boundary could cross the line segment from start to end point at all.
+     *
+     * \param poly_idx The index of the polygon in \ref LinePolygonsCrossings::boundary
+     * \return False if the bounding box of the polygon is clear of the line segment, so that its line segments don't need to be checked.
+     */
+    bool mayCross(const size_t poly_idx) const;
+
     /*!
      * Generate the basic combing path and optimize it.
      *
@@ -124,14 +142,25 @@ private:
      * \param start the starting point
      * \param end the end point
      * \param dist_to_move_boundary_point_outside Distance used to move a point from a boundary so that it doesn't intersect with it anymore. (Precision issue)
+     * \param polygon_boxes The bounding box of each polygon in \p boundary, or nullptr if they are not known.
      */
-    LinePolygonsCrossings(const Shape& boundary, LocToLineGrid& loc_to_line_grid, Point2LL& start, Point2LL& end, int64_t dist_to_move_boundary_point_outside)
+    LinePolygonsCrossings(
+        const Shape& boundary,
+        LocToLineGrid& loc_to_line_grid,
+        Point2LL& start,
+        Point2LL& end,
+        int64_t dist_to_move_boundary_point_outside,
+        const std::vector<AABB>* polygon_boxes)
         : boundary_(boundary)
         , loc_to_line_grid_(loc_to_line_grid)
+        , polygon_boxes_(polygon_boxes)
         , start_point_(start)
         , end_point_(end)
+        , segment_box_(start, start)
         , dist_to_move_boundary_point_outside_(dist_to_move_boundary_point_outside)
     {
+        segment_box_.include(end);
+        segment_box_.expand(polygon_box_margin_);
     }
 
 public:
@@ -143,6 +172,8 @@ public:
      * \param endPoint Where to end the combing move.
      * \param combPath Output parameter: the combing path generated.
      * \param fail_on_unavoidable_obstacles When moving over other parts is inavoidable, stop calculation early and return false.
+     * \param polygon_boxes Optional: the bounding box of each polygon in \p boundary (see \ref computePolygonBoxes), used to skip the polygons far
+     * away from the line segment.
      * \return Whether combing succeeded, i.e. we didn't cross any gaps/other parts
      */
     static bool comb(
@@ -153,11 +184,23 @@ public:
         CombPath& combPath,
         int64_t dist_to_move_boundary_point_outside,
         int64_t max_comb_distance_ignored,
-        bool fail_on_unavoidable_obstacles)
+        bool fail_on_unavoidable_obstacles,
+        const std::vector<AABB>* polygon_boxes = nullptr)
     {
-        LinePolygonsCrossings linePolygonsCrossings(boundary, loc_to_line_grid, startPoint, endPoint, dist_to_move_boundary_point_outside);
+        LinePolygonsCrossings linePolygonsCrossings(boundary, loc_to_line_grid, startPoint, endPoint, dist_to_move_boundary_point_outside, polygon_boxes);
         return linePolygonsCrossings.generateCombingPath(combPath, max_comb_distance_ignored, fail_on_unavoidable_obstacles);
     };
+
+    /*!
+     * Compute the bounding box of each polygon of a combing boundary.
+     *
+     * When many paths are combed within the same boundary, computing these once lets \ref LinePolygonsCrossings::comb skip the polygons which
+     * are nowhere near each path.
+     *
+     * \param boundary The boundary within which to comb.
+     * \return The bounding box of each polygon in \p boundary, in the same order.
+     */
+    static std::vector<AABB> computePolygonBoxes(const Shape& boundary);
 };
 
 } // namespace cura
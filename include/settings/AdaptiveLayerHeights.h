@@ -4,6 +4,7 @@
 #ifndef ADAPTIVELAYERHEIGHTS_H
 #define ADAPTIVELAYERHEIGHTS_H
 
+#include "CompactMesh.h"
 #include "MeshGroup.h"
 #include "utils/Coord_t.h"
 
@@ -58,8 +59,15 @@ public:
      * \param threshold Threshold to compare the tangent of the steepest slope
      * to.
      * \param meshgroup The meshgroup to process.
+     * \param mesh_geometries The geometry of each mesh of \p meshgroup, in the same order.
      */
-    AdaptiveLayerHeights(const coord_t base_layer_height, const coord_t variation, const coord_t step_size, const coord_t threshold, const MeshGroup* meshgroup);
+    AdaptiveLayerHeights(
+        const coord_t base_layer_height,
+        const coord_t variation,
+        const coord_t step_size,
+        const coord_t threshold,
+        const MeshGroup* meshgroup,
+        const std::vector<CompactMesh>& mesh_geometries);
 
 private:
     /*!
@@ -114,8 +122,9 @@ private:
     /*!
      * Calculates the slopes for each triangle in the mesh.
      * These are uses later by calculateLayers to find the steepest triangle in a potential layer.
+     * \param mesh_geometries The geometry of each mesh of the meshgroup, in the same order.
      */
-    void calculateMeshTriangleSlopes();
+    void calculateMeshTriangleSlopes(const std::vector<CompactMesh>& mesh_geometries);
 };
 
 } // namespace cura
@@ -0,0 +1,119 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef SETTINGS_SETTING_KEY_H
+#define SETTINGS_SETTING_KEY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace cura
+{
+
+/*!
+ * \brief An interned setting name.
+ *
+ * Every distinct setting name gets a small, dense, process-wide identifier the
+ * first time it is interned. Settings containers use that identifier to index
+ * their cache of parsed values, so a lookup through a key does not need to
+ * hash or compare the name again.
+ *
+ * Identifiers are never reused or released, so a key stays valid for the
+ * lifetime of the process.
+ */
+class SettingKey
+{
+public:
+    /*!
+     * \brief Intern a setting name.
+     *
+     * This is thread safe. The name is only hashed once per thread; after
+     * that a thread-local table answers the lookup.
+     * \param name The name of the setting.
+     */
+    explicit SettingKey(std::string_view name);
+
+    /*!
+     * \brief Intern a setting name given as a character array, usually a
+     * string literal.
+     *
+     * A string literal keeps its address for the lifetime of the process, so
+     * each thread remembers the keys of recently used arrays in a small table
+     * indexed by their address. On a hit, the name is only compared with the
+     * interned one, not hashed. The comparison also keeps this correct for
+     * arrays whose contents change.
+     * \param name The array holding the name, terminated by a null character
+     * or by the end of the array.
+     * \param capacity The size of the array.
+     */
+    static SettingKey fromLiteral(const char* name, size_t capacity);
+
+    /*!
+     * \brief The dense identifier of this setting name.
+     */
+    size_t id() const
+    {
+        return id_;
+    }
+
+    /*!
+     * \brief The name of the setting.
+     */
+    const std::string& name() const
+    {
+        return *name_;
+    }
+
+private:
+    SettingKey(const size_t id, const std::string* name)
+        : id_(id)
+        , name_(name)
+    {
+    }
+
+    size_t id_; //!< Index of this name in the process-wide name table.
+    const std::string* name_; //!< The interned name. Owned by the name table, which never moves its strings.
+};
+
+/*!
+ * \brief A setting name given as a template argument.
+ *
+ * Used by \ref setting_key to produce a key handle at compile time.
+ */
+template<size_t N>
+struct SettingName
+{
+    constexpr SettingName(const char (&name)[N])
+    {
+        std::copy_n(name, N, value);
+    }
+
+    constexpr std::string_view view() const
+    {
+        return std::string_view{ value, N - 1 };
+    }
+
+    char value[N];
+};
+
+/*!
+ * \brief Get the key handle of a setting name that is known at compile time.
+ *
+ * The name is interned once, on first use, and the handle is kept in a static
+ * so hot loops can look a setting up without touching the name at all:
+ * \code
+ * const coord_t line_width = settings.get<coord_t>(setting_key<"line_width">());
+ * \endcode
+ */
+template<SettingName Name>
+const SettingKey& setting_key()
+{
+    static const SettingKey key{ Name.view() };
+    return key;
+}
+
+} // namespace cura
+
+#endif // SETTINGS_SETTING_KEY_H
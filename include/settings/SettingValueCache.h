@@ -0,0 +1,212 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef SETTINGS_SETTING_VALUE_CACHE_H
+#define SETTINGS_SETTING_VALUE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace cura
+{
+
+/*!
+ * \brief Cache of parsed setting values, indexed by interned setting key.
+ *
+ * Each \ref Settings container owns one of these. Every key has a couple of
+ * slots, each holding the value of that setting parsed to one type, stamped
+ * with the type and with the cache generation it was computed in. A value
+ * resolved through a parent or through limit_to_extruder depends on other
+ * containers too, so any change to any container starts a new, process-wide
+ * generation and thereby invalidates all caches at once. Settings only change
+ * while a slice is being set up, so this costs nothing during slicing.
+ *
+ * Lookups and stores are lock-free and may happen concurrently from any
+ * number of threads. Invalidation must not race with lookups.
+ */
+class SettingValueCache
+{
+public:
+    /*!
+     * \brief Whether values of this type can be stored in the cache.
+     *
+     * Only small trivially copyable values are cached: numbers, enums and the
+     * unit types. Strings, lists and shapes are parsed on every lookup.
+     */
+    template<typename T>
+    static constexpr bool cacheable = ! std::is_reference_v<T> && std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && sizeof(T) <= sizeof(uint64_t);
+
+    SettingValueCache() = default;
+
+    /*!
+     * \brief Copying a cache gives an empty cache.
+     *
+     * The values of the original may depend on its parent, which the copy
+     * might not share.
+     */
+    SettingValueCache(const SettingValueCache&) noexcept;
+
+    /*!
+     * \brief Assigning to a cache means its container was overwritten, which
+     * invalidates all caches.
+     */
+    SettingValueCache& operator=(const SettingValueCache&) noexcept;
+
+    ~SettingValueCache();
+
+    /*!
+     * \brief Look up the cached value of a setting.
+     * \param key_id The interned identifier of the setting.
+     * \param value Output parameter, only written when the value was cached.
+     * \return Whether a value of this type was cached in the current
+     * generation.
+     */
+    template<typename T>
+    bool find(const size_t key_id, T& value) const
+    {
+        const Slot* slot = findSlot(key_id, typeId<T>());
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence & 1) // Being written right now.
+        {
+            return false;
+        }
+        const uint64_t tag = slot->tag.load(std::memory_order_relaxed);
+        const uint64_t bits = slot->bits.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != sequence || tag != makeTag(generation(), typeId<T>()))
+        {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(&value), &bits, sizeof(T)); // T is trivially copyable, but may have a non-trivial default constructor.
+        return true;
+    }
+
+    /*!
+     * \brief The current cache generation.
+     *
+     * Get this before computing a value to store, and pass it on to
+     * \ref store.
+     */
+    static uint64_t generation()
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /*!
+     * \brief Remember the parsed value of a setting.
+     *
+     * The value is stamped with the generation in which it was computed. If
+     * the caches were invalidated meanwhile, the value may be stale, so it is
+     * not stored at all. If another thread is storing into the same slot at
+     * the same time, this silently gives up too. The value will be parsed
+     * again next time.
+     * \param key_id The interned identifier of the setting.
+     * \param value The value to store.
+     * \param computed_generation The \ref generation from before the value was
+     * computed.
+     */
+    template<typename T>
+    void store(const size_t key_id, const T& value, const uint64_t computed_generation)
+    {
+        if (generation() != computed_generation)
+        {
+            return;
+        }
+        Slot* slot = getSlot(key_id, typeId<T>());
+        if (slot == nullptr)
+        {
+            return;
+        }
+        uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) || ! slot->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        // Stamped with the generation it was computed in, not the current one, so that an invalidation racing with this store still makes it stale.
+        slot->tag.store(makeTag(computed_generation, typeId<T>()), std::memory_order_relaxed);
+        slot->bits.store(bits, std::memory_order_relaxed);
+        slot->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Invalidate the cached values of every settings container.
+     */
+    static void invalidateAll();
+
+private:
+    static constexpr size_t ways = 2; //!< Number of differently typed values kept per key.
+    static constexpr size_t chunk_keys = 64; //!< Number of keys whose slots are allocated together.
+    static constexpr size_t max_chunks = 64; //!< Keys beyond chunk_keys * max_chunks are never cached.
+    static constexpr uint32_t max_type_id = 255; //!< Type identifiers must fit in the low byte of a tag.
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{ 0 }; //!< Odd while a value is being written.
+        std::atomic<uint64_t> tag{ 0 }; //!< Generation and type of the value. Zero if never written.
+        std::atomic<uint64_t> bits{ 0 }; //!< The value itself.
+    };
+
+    struct Chunk
+    {
+        std::array<Slot, chunk_keys * ways> slots;
+    };
+
+    /*!
+     * Lazily allocated slot storage. Chunks are only freed with the cache.
+     */
+    std::array<std::atomic<Chunk*>, max_chunks> chunks_{};
+
+    /*!
+     * The current cache generation. Slots stamped with an older generation
+     * are stale.
+     */
+    static std::atomic<uint64_t> generation_;
+
+    static uint32_t nextTypeId();
+
+    template<typename T>
+    static uint32_t typeId()
+    {
+        static const uint32_t type_id = nextTypeId();
+        return type_id;
+    }
+
+    static uint64_t makeTag(const uint64_t generation, const uint32_t type_id)
+    {
+        return (generation << 8) | type_id;
+    }
+
+    const Slot* findSlot(const size_t key_id, const uint32_t type_id) const
+    {
+        if (key_id >= chunk_keys * max_chunks || type_id > max_type_id)
+        {
+            return nullptr;
+        }
+        const Chunk* chunk = chunks_[key_id / chunk_keys].load(std::memory_order_acquire);
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+        return &chunk->slots[(key_id % chunk_keys) * ways + type_id % ways];
+    }
+
+    /*!
+     * Get the slot for a key and type, allocating its chunk if necessary.
+     * \return The slot, or nullptr if this key or type can't be cached.
+     */
+    Slot* getSlot(const size_t key_id, const uint32_t type_id);
+};
+
+} // namespace cura
+
+#endif // SETTINGS_SETTING_VALUE_CACHE_H
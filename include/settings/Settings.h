@@ -18,6 +18,9 @@
 #include <unordered_map>
 #include <vector>
 
+#include "settings/SettingKey.h"
+#include "settings/SettingValueCache.h"
+
 namespace cura
 {
 
@@ -61,11 +64,68 @@ public:
      *     settings.
      *  4. If a setting is not known at all, an error is returned and the
      *     application is closed with an error value of 2.
+     *
+     * Numbers, enums and other small values are parsed only once. The parsed
+     * value is cached until the next time any settings container changes.
+     * \param key The key of the setting to get.
+     * \return The setting's value, cast to the desired type.
+     */
+    template<typename A>
+    A get(const std::string& key) const
+    {
+        if constexpr (SettingValueCache::cacheable<A>)
+        {
+            return get<A>(SettingKey(key));
+        }
+        else
+        {
+            return getUncached<A>(key);
+        }
+    }
+
+    /*!
+     * \brief Get the value of a setting named by a string literal.
+     *
+     * This is the same as getting it by name, but the name is resolved to its
+     * key through the address of the literal, without hashing the name or
+     * constructing a string. See \ref SettingKey::fromLiteral.
+     * \param key The name of the setting.
+     * \return The setting's value, cast to the desired type.
+     */
+    template<typename A, size_t N>
+    A get(const char (&key)[N]) const
+    {
+        return get<A>(SettingKey::fromLiteral(key, N));
+    }
+
+    /*!
+     * \brief Get the value of a setting by its interned key.
+     *
+     * This is the same as getting it by name, but skips looking up the name.
+     * Use \ref setting_key to get a key for a name that is known at compile
+     * time.
      * \param key The key of the setting to get.
      * \return The setting's value, cast to the desired type.
      */
     template<typename A>
-    A get(const std::string& key) const;
+    A get(const SettingKey& key) const
+    {
+        if constexpr (SettingValueCache::cacheable<A>)
+        {
+            A value;
+            if (! value_cache.find(key.id(), value))
+            {
+                const uint64_t generation = SettingValueCache::generation();
+                value = getUncached<A>(key.name());
+                value_cache.store(key.id(), value, generation);
+            }
+            return value;
+        }
+        else
+        {
+            return getUncached<A>(key.name());
+        }
+    }
 
     /*!
      * \brief Get a string containing all settings in this container.
@@ -96,6 +156,15 @@ public:
      */
     void setParent(Settings* new_parent);
 
+    /*!
+     * \brief Drop the cached values of all settings containers.
+     *
+     * Adding a setting or changing a parent does this automatically. Call it
+     * after changing anything else that settings are resolved through, such
+     * as the scene's limit_to_extruder table.
+     */
+    static void invalidateCachedValues();
+
     std::unordered_map<std::string, std::string> getFlattendSettings() const;
 
     std::vector<std::string> getKeys() const;
@@ -112,6 +181,19 @@ private:
      */
     std::unordered_map<std::string, std::string> settings;
 
+    /*!
+     * \brief Values of settings that were already parsed, per type.
+     */
+    mutable SettingValueCache value_cache;
+
+    /*!
+     * \brief Look up and parse a setting, without using the value cache.
+     * \param key The key of the setting to get.
+     * \return The setting's value, cast to the desired type.
+     */
+    template<typename A>
+    A getUncached(const std::string& key) const;
+
     /*!
      * \brief Get the value of a setting, but without looking at the limiting to
      * extruder.
@@ -4,17 +4,31 @@
 #ifndef SKIN_H
 #define SKIN_H
 
+#include <vector>
+
+#include "geometry/Shape.h"
 #include "settings/types/LayerIndex.h"
 #include "utils/Coord_t.h"
 
 namespace cura
 {
 
-class Shape;
 class SkinPart;
 class SliceLayerPart;
 class SliceMeshStorage;
 
+/*!
+ * The areas of a mesh that are solid in all the layers of top skin above and of bottom skin below each layer.
+ *
+ * Neighbouring layers mostly look at the same layers for their skin, so these are computed once for the whole mesh instead of separately for
+ * every part on every layer. Areas smaller than the minimum infill area are already removed.
+ */
+struct SkinSolidAreas
+{
+    std::vector<Shape> above; //!< Per layer, the area that is solid in all of the top_layers layers above it. Empty if not precomputed.
+    std::vector<Shape> below; //!< Per layer, the area that is solid in all of the bottom_layers layers below it. Empty if not precomputed.
+};
+
 /*!
  * Class containing all skin and infill area computation functions
  */
@@ -30,14 +44,28 @@ public:
      * stored and where the skin insets and fill areas (output) are stored.
      * \param process_infill Whether to process infill, i.e. whether there's a
      * positive infill density or there are infill meshes modifying this mesh.
+     * \param solid_areas The solid areas of the mesh as computed by
+     * \ref computeSolidAreas, or nullptr to compute them for each part.
      */
-    SkinInfillAreaComputation(const LayerIndex& layer_nr, SliceMeshStorage& mesh, bool process_infill);
+    SkinInfillAreaComputation(const LayerIndex& layer_nr, SliceMeshStorage& mesh, bool process_infill, const SkinSolidAreas* solid_areas = nullptr);
 
     /*!
      * Generate the skin areas and its insets.
      */
     void generateSkinsAndInfill();
 
+    /*!
+     * \brief Compute the areas that are solid in all layers of top and bottom
+     * skin around each layer of a mesh.
+     *
+     * This is only worthwhile if there are multiple layers of skin to
+     * intersect. Otherwise the areas are left empty, and each part looks up the
+     * single layer it needs.
+     *
+     * \param mesh The mesh to compute the solid areas of.
+     */
+    static SkinSolidAreas computeSolidAreas(const SliceMeshStorage& mesh);
+
     /*!
      * \brief Combines the infill of multiple layers for a specified mesh.
      *
@@ -171,6 +199,7 @@ protected:
     size_t skin_inset_count_; //!< The number of perimeters to surround the skin
     bool no_small_gaps_heuristic_; //!< A heuristic which assumes there will be no small gaps between bottom and top skin with a z size smaller than the skin size itself
     bool process_infill_; //!< Whether to process infill, i.e. whether there's a positive infill density or there are infill meshes modifying this mesh.
+    const SkinSolidAreas* solid_areas_; //!< The precomputed solid areas of the mesh, if any.
 
     coord_t top_skin_preshrink_; //!< The top skin removal width, to remove thin strips of skin along nearly-vertical walls.
     coord_t bottom_skin_preshrink_; //!< The bottom skin removal width, to remove thin strips of skin along nearly-vertical walls.
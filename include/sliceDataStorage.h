@@ -4,8 +4,10 @@
 #ifndef SLICE_DATA_STORAGE_H
 #define SLICE_DATA_STORAGE_H
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include "PrimeTower.h"
@@ -25,6 +27,7 @@
 #include "settings/types/LayerIndex.h"
 #include "utils/AABB.h"
 #include "utils/AABB3D.h"
+#include "utils/LRUCache.h"
 #include "utils/NoCopy.h"
 
 // libArachne
@@ -409,6 +412,11 @@ public:
     /*!
      * Get all outlines within a given layer.
      *
+     * The outlines are remembered for the most recently requested layers, so
+     * asking for the same outlines again is cheap. When the data that the
+     * outlines are made of changes, \ref invalidateLayerOutlines must be
+     * called.
+     *
      * \param layer_nr The index of the layer for which to get the outlines
      * (negative layer numbers indicate the raft).
      * \param include_support Whether to include support in the outline.
@@ -425,6 +433,18 @@ public:
         const int extruder_nr = -1,
         const bool include_models = true) const;
 
+    /*!
+     * Forget the remembered layer outlines.
+     *
+     * This must be called after changing the layer parts of the meshes, the
+     * support, the prime tower or the raft, and must not be called while other
+     * threads are getting layer outlines.
+     */
+    void invalidateLayerOutlines();
+
+    size_t getLayerOutlinesHits() const;
+    size_t getLayerOutlinesMisses() const;
+
     /*!
      * Get the extruders used.
      *
@@ -458,6 +478,47 @@ public:
     Shape getMachineBorder(int extruder_nr = -1) const;
 
 private:
+    /*!
+     * The parameters of \ref getLayerOutlines, which together identify the
+     * outlines it returns.
+     */
+    struct LayerOutlinesKey
+    {
+        LayerIndex layer_nr;
+        bool include_support;
+        bool include_prime_tower;
+        bool external_polys_only;
+        int extruder_nr;
+        bool include_models;
+
+        bool operator==(const LayerOutlinesKey& other) const = default;
+    };
+
+    struct LayerOutlinesKeyHash
+    {
+        size_t operator()(const LayerOutlinesKey& key) const
+        {
+            const size_t flags = (key.include_support ? 1 : 0) | (key.include_prime_tower ? 2 : 0) | (key.external_polys_only ? 4 : 0) | (key.include_models ? 8 : 0);
+            return std::hash<LayerIndex>()(key.layer_nr) * 31 * 31 + std::hash<int>()(key.extruder_nr) * 31 + flags;
+        }
+    };
+
+    mutable std::mutex layer_outlines_mutex_; //!< Guards \ref layer_outlines_cache_.
+    mutable LRUCache<LayerOutlinesKey, std::shared_ptr<const Shape>, LayerOutlinesKeyHash> layer_outlines_cache_{ 256 }; //!< The most recently requested layer outlines.
+    mutable std::atomic<size_t> layer_outlines_hits_{ 0 };
+    mutable std::atomic<size_t> layer_outlines_misses_{ 0 };
+
+    /*!
+     * Compute the outlines within a given layer, see \ref getLayerOutlines.
+     */
+    Shape computeLayerOutlines(
+        const LayerIndex layer_nr,
+        const bool include_support,
+        const bool include_prime_tower,
+        const bool external_polys_only,
+        const int extruder_nr,
+        const bool include_models) const;
+
     /*!
      * Construct the retraction_wipe_config_per_extruder
      */
@@ -6,6 +6,7 @@
 
 #include <optional>
 #include <queue>
+#include <span>
 #include <unordered_map>
 
 #include "geometry/LinesSet.h"
@@ -22,8 +23,8 @@ namespace cura
 {
 
 class AdaptiveLayer;
+class CompactMesh;
 class Mesh;
-class MeshVertex;
 
 class SlicerSegment
 {
@@ -33,8 +34,8 @@ public:
     // The index of the other face connected via the edge that created end
     int endOtherFaceIdx = -1;
     // If end corresponds to a vertex of the mesh, then this is populated
-    // with the vertex that it ended on.
-    const MeshVertex* endVertex = nullptr;
+    // with the faces connected to the vertex that it ended on.
+    std::span<const uint32_t> endVertexFaces;
     bool addedToPolygon = false;
 };
 
@@ -488,8 +489,35 @@ public:
 
     Slicer(Mesh* mesh, const coord_t thickness, const size_t slice_layer_count, bool use_variable_layer_heights, std::vector<AdaptiveLayer>* adaptive_layers);
 
+    /*!
+     * Slice a mesh from a compact copy of its geometry.
+     *
+     * The vertices and faces of \p mesh are not used, so they may already have been released. Its settings are.
+     * \param mesh The mesh to slice.
+     * \param geometry The geometry of \p mesh.
+     */
+    Slicer(
+        Mesh* mesh,
+        const CompactMesh& geometry,
+        const coord_t thickness,
+        const size_t slice_layer_count,
+        bool use_variable_layer_heights,
+        std::vector<AdaptiveLayer>* adaptive_layers);
+
 
 private:
+    /*!
+     * \brief For every layer, the indices of the faces whose Z range contains the layer height.
+     *
+     * Stored as one contiguous array of face indices, with per-layer offsets into that array (CSR layout), so that each layer only
+     * visits the faces it actually intersects instead of the whole mesh.
+     */
+    struct LayerFaceIndex
+    {
+        std::vector<size_t> layer_offsets; //!< Faces of layer n are face_indices[layer_offsets[n] .. layer_offsets[n + 1]). Size is the layer count + 1.
+        std::vector<uint32_t> face_indices; //!< Face indices for all layers, in ascending order within each layer.
+    };
+
     /*!
      * \brief Linear interpolation between coordinates of a line.
      *
@@ -519,10 +547,20 @@ private:
     static SlicerSegment project2D(const Point3LL& p0, const Point3LL& p1, const Point3LL& p2, const coord_t z);
 
     /*! Creates an array of "z bounding boxes" for each face.
-     * \param[in] mesh The mesh which is analyzed.
+     * \param[in] geometry The mesh which is analyzed.
      * \return z heights aka z bounding boxes of the faces.
      */
-    static std::vector<std::pair<int32_t, int32_t>> buildZHeightsForFaces(const Mesh& mesh);
+    static std::vector<std::pair<int32_t, int32_t>> buildZHeightsForFaces(const CompactMesh& geometry);
+
+    /*! Assigns every face to the layers its z bounding box spans.
+     *
+     * Each face is located in the (sorted) layer heights with a binary search, so building the index costs O(faces * log(layers)) plus the
+     * number of face-layer intersections, instead of testing every face against every layer.
+     * \param[in] zbboxes The z part of the bounding boxes of the faces of the mesh.
+     * \param[in] layers The layers, with their z values already set.
+     * \return The faces to process for each layer.
+     */
+    static LayerFaceIndex buildLayerFaceIndex(const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const std::vector<SlicerLayer>& layers);
 
     /*! Creates the polygons in layers.
      * \param[in] mesh The mesh which is analyzed.
@@ -550,13 +588,12 @@ private:
         const std::vector<AdaptiveLayer>* adaptive_layers);
 
     /*! Creates the segments and write them into the layers.
-     * \param[in] mesh The mesh which is analyzed.
-     * \param[in] zbboxes The z part of the bounding boxes of the faces of the mesh.
+     * \param[in] geometry The mesh which is analyzed.
+     * \param[in] layer_faces The faces intersecting each layer, see \ref buildLayerFaceIndex.
      * \param[in] slicing_tolderance Slicing tolerance in order to figure out what happens when vertices are exactly on the slicing boundary.
      * \param[in, out] layers The segments are created here.
      */
-    static void
-        buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
+    static void buildSegments(const CompactMesh& geometry, const LayerFaceIndex& layer_faces, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers);
 };
 
 } // namespace cura
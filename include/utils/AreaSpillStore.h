@@ -0,0 +1,117 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_AREA_SPILL_STORE_H
+#define UTILS_AREA_SPILL_STORE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry/Shape.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Keeps areas that aren't needed for a while in a compact serialised form, to save memory.
+ *
+ * The coordinates of an area are stored as variable-length differences between consecutive points, which usually takes a fraction of the
+ * memory of the area itself. The serialised areas are either kept in memory or written to a temporary file, which is removed when the store
+ * is destroyed.
+ *
+ * The store may be used from multiple threads at once.
+ */
+class AreaSpillStore
+{
+public:
+    /*!
+     * \param to_file Whether to write the areas to a temporary file rather than keeping them in memory. If no temporary file can be created,
+     * they are kept in memory.
+     */
+    explicit AreaSpillStore(const bool to_file);
+
+    AreaSpillStore(const AreaSpillStore&) = delete;
+    AreaSpillStore& operator=(const AreaSpillStore&) = delete;
+
+    /*!
+     * \brief Store an area.
+     * \return The identifier to load the area with.
+     */
+    size_t store(const Shape& area);
+
+    /*!
+     * \brief Load a stored area, and remove it from the store.
+     * \param id The identifier that \ref store returned for the area.
+     */
+    Shape load(const size_t id);
+
+    /*!
+     * \brief Remove a stored area without loading it.
+     */
+    void discard(const size_t id);
+
+    /*!
+     * \brief How many bytes the stored areas take up, in memory or on disk.
+     */
+    size_t getBytes() const;
+
+    /*!
+     * \brief How far the temporary file is in use, including the space of removed areas that isn't reused yet.
+     */
+    uint64_t getFileSize() const;
+
+    /*!
+     * \brief Serialise an area to its compact form.
+     */
+    static std::vector<uint8_t> encode(const Shape& area);
+
+    /*!
+     * \brief Restore an area from its compact form.
+     */
+    static Shape decode(const std::vector<uint8_t>& data);
+
+private:
+    struct Record
+    {
+        std::vector<uint8_t> data; //!< The serialised area, if it is kept in memory.
+        bool in_file; //!< Whether the serialised area was written to the file instead.
+        uint64_t offset; //!< Where the serialised area starts in the file.
+        size_t size; //!< The size of the serialised area.
+    };
+
+    /*!
+     * \brief Find space in the file for an area of \p size bytes, reusing the space of removed areas if possible.
+     * \return Where to write the area.
+     */
+    uint64_t allocate(const size_t size);
+
+    /*!
+     * \brief Make the space of a removed area available again.
+     */
+    void release(uint64_t offset, const size_t size);
+
+    struct FileCloser
+    {
+        void operator()(std::FILE* file) const
+        {
+            std::fclose(file);
+        }
+    };
+
+    mutable std::mutex mutex_; //!< Guards all members below.
+    std::unique_ptr<std::FILE, FileCloser> file_; //!< The temporary file, or nullptr to keep the areas in memory.
+    uint64_t file_end_ = 0; //!< The end of the used part of the file.
+    std::map<uint64_t, uint64_t> free_ranges_; //!< The unused ranges before \ref file_end_, by offset, with their size. Never adjacent.
+    std::unordered_map<size_t, Record> records_; //!< The stored areas by their identifier.
+    size_t next_id_ = 0;
+    size_t bytes_ = 0;
+};
+
+} // namespace cura
+
+#endif // UTILS_AREA_SPILL_STORE_H
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_COMPRESSED_SINK_H
+#define UTILS_COMPRESSED_SINK_H
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "utils/GCodeSink.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Compresses the g-code while it is written, and passes the compressed data on to another sink.
+ *
+ * Only available when built with ENABLE_GCODE_COMPRESSION, see isSupported().
+ *
+ * Flushing the sink makes the compressor emit all the data written so far, so it can be decompressed up to there. The output is a single
+ * gzip member or zstd frame, which is completed once by finish() (or the destructor).
+ */
+class CompressedSink : public GCodeSink
+{
+public:
+    enum class Format
+    {
+        GZIP,
+        ZSTD,
+    };
+
+    /*!
+     * \brief The compression format that the extension of a file name asks for.
+     * \param filename The name of the file, e.g. "print.gcode.gz".
+     * \return GZIP for ".gz", ZSTD for ".zst", or nothing for any other extension.
+     */
+    static std::optional<Format> formatForFile(const std::string& filename);
+
+    /*!
+     * \brief Whether this build of the engine can compress in a format.
+     */
+    static bool isSupported(const Format format);
+
+    /*!
+     * \param format The compression format. Must be supported.
+     * \param destination The sink to write the compressed data to. Must outlive this sink.
+     */
+    CompressedSink(const Format format, GCodeSink& destination);
+
+    /*!
+     * Completes the compressed data, if finish() wasn't called.
+     */
+    ~CompressedSink() override;
+
+    /*!
+     * \brief Emit everything compressed so far, and flush the destination.
+     */
+    void flush() override;
+
+    /*!
+     * \brief Complete the gzip member or zstd frame, and finish the destination.
+     *
+     * Only the first call completes the compressed data. Nothing may be written after that.
+     * \return Whether all g-code was compressed and reached the destination.
+     */
+    bool finish() override;
+
+    /*!
+     * \brief Whether the compression or the destination failed.
+     */
+    bool hasFailed() const override;
+
+protected:
+    void writeData(const std::string_view data) override;
+
+private:
+    class Compressor;
+    class GzipCompressor;
+    class ZstdCompressor;
+
+    std::unique_ptr<Compressor> compressor_; //!< The state of the compression library.
+    GCodeSink& destination_; //!< Where the compressed data goes.
+    bool has_unflushed_data_ = false; //!< Whether data was compressed since the last flush.
+    bool finished_ = false; //!< Whether the compressed data was completed.
+};
+
+} // namespace cura
+
+#endif // UTILS_COMPRESSED_SINK_H
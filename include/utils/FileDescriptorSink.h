@@ -0,0 +1,79 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_FILE_DESCRIPTOR_SINK_H
+#define UTILS_FILE_DESCRIPTOR_SINK_H
+
+#include <memory>
+#include <string>
+
+#include "utils/GCodeSink.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Writes g-code to a file with plain system calls, in large blocks.
+ *
+ * The g-code is gathered in a large buffer, which is written to the file descriptor in one call once it's full. Bypassing the buffering
+ * of the standard streams, a single copy of the data is made before it goes to the operating system.
+ */
+class FileDescriptorSink : public GCodeSink
+{
+public:
+    static constexpr size_t default_buffer_size = 1 << 20; //!< Large enough to make the cost of the system calls negligible.
+
+    /*!
+     * \param buffer_size The number of bytes gathered before they are written to the file.
+     */
+    explicit FileDescriptorSink(const size_t buffer_size = default_buffer_size);
+
+    /*!
+     * Writes out the buffered data and closes the file.
+     */
+    ~FileDescriptorSink() override;
+
+    /*!
+     * \brief Create or truncate a file to write to.
+     * \param filename The path of the file.
+     * \return Whether the file could be opened.
+     */
+    bool open(const std::string& filename);
+
+    /*!
+     * \brief Write out the buffered data and close the file.
+     * \return Whether all data written to this sink reached the file.
+     */
+    bool close();
+
+    /*!
+     * \brief Write the buffered data to the file.
+     */
+    void flush() override;
+
+    /*!
+     * \brief Write out the buffered data and close the file.
+     * \return Whether all data written to this sink reached the file.
+     */
+    bool finish() override;
+
+protected:
+    void writeData(const std::string_view data) override;
+
+private:
+    int fd_ = -1; //!< The file written to, or -1 if none is open.
+    std::unique_ptr<char[]> buffer_; //!< The data that isn't written to the file yet.
+    size_t buffer_size_; //!< The capacity of the buffer.
+    size_t buffered_ = 0; //!< The number of bytes in the buffer.
+
+    /*!
+     * \brief Write data to the file right away, retrying partial writes.
+     *
+     * If writing fails, or no file is open, the sink is marked as failed and nothing more is written.
+     */
+    void writeToFile(const char* data, size_t size);
+};
+
+} // namespace cura
+
+#endif // UTILS_FILE_DESCRIPTOR_SINK_H
@@ -0,0 +1,271 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_GCODE_BUFFER_H
+#define UTILS_GCODE_BUFFER_H
+
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "utils/GCodeSink.h"
+#include "utils/string.h" // MMtoStream, PrecisionedDouble
+
+namespace cura
+{
+
+/*!
+ * \brief Formats g-code lines without going through the formatting machinery of std::ostream.
+ *
+ * Numbers are formatted with std::to_chars into a reusable line buffer, which is handed to the target sink in one write once the line
+ * is complete (i.e. whenever the buffered text ends with a line feed). Apart from that, the output is byte for byte what the same sequence
+ * of `operator<<` calls would produce on a stream set to `std::fixed`:
+ *  - integers as with `std::ostream`,
+ *  - floating point numbers with 6 decimals (`std::fixed`),
+ *  - MMtoStream and PrecisionedDouble as their own stream operators do.
+ * Other types are formatted by their stream operators.
+ *
+ * The output can also be recorded instead of written, see startRecording(). Recording only stores the values in a compact binary form,
+ * so that the costly formatting can be done later, on another thread, by render().
+ */
+class GCodeBuffer
+{
+public:
+    GCodeBuffer();
+
+    /*!
+     * \brief Writes any pending text to the current sink and writes to a stream from now on.
+     */
+    void setStream(std::ostream* stream);
+
+    /*!
+     * \brief Writes any pending text to the current sink and sets the sink to write to from now on.
+     * \param sink The sink to write to. Must outlive its use by this buffer.
+     */
+    void setSink(GCodeSink* sink);
+
+    /*!
+     * \brief The sink written to.
+     */
+    GCodeSink* getSink() const
+    {
+        return sink_;
+    }
+
+    /*!
+     * \brief Writes the pending text, even if the last line is incomplete.
+     */
+    void flush()
+    {
+        if (! line_.empty())
+        {
+            sink_->write(line_);
+            line_.clear();
+        }
+    }
+
+    /*!
+     * \brief Writes text to the sink right away, after any pending text.
+     */
+    void write(const std::string_view text)
+    {
+        flush();
+        sink_->write(text);
+    }
+
+    /*!
+     * \brief Writes the pending text, then records all output until stopRecording() instead of writing it to the sink.
+     */
+    void startRecording();
+
+    /*!
+     * \brief Stops recording.
+     * \return Everything output since startRecording(), to be turned into text by render().
+     */
+    std::string stopRecording();
+
+    /*!
+     * \brief Formats recorded output.
+     *
+     * Doesn't depend on the state of any buffer, so any number of recordings can be rendered concurrently.
+     * \param recording The output recorded by a buffer, see stopRecording().
+     * \return The text that the buffer would have written if it hadn't been recording.
+     */
+    static std::string render(const std::string_view recording);
+
+    GCodeBuffer& operator<<(const char character)
+    {
+        appendText(std::string_view(&character, 1));
+        return *this;
+    }
+
+    GCodeBuffer& operator<<(const std::string_view text)
+    {
+        appendText(text);
+        return *this;
+    }
+
+    GCodeBuffer& operator<<(const char* text)
+    {
+        return *this << std::string_view(text);
+    }
+
+    GCodeBuffer& operator<<(const std::string& text)
+    {
+        return *this << std::string_view(text);
+    }
+
+    template<std::integral T>
+    requires(! std::same_as<T, char> && ! std::same_as<T, signed char> && ! std::same_as<T, unsigned char> && ! std::same_as<T, bool>)
+    GCodeBuffer& operator<<(const T& value)
+    {
+        if (recording_)
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                record(Token::SIGNED, static_cast<int64_t>(value));
+            }
+            else
+            {
+                record(Token::UNSIGNED, static_cast<uint64_t>(value));
+            }
+            return *this;
+        }
+        char buffer[24];
+        const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        line_.append(buffer, result.ptr);
+        return *this;
+    }
+
+    GCodeBuffer& operator<<(const double value)
+    {
+        if (recording_)
+        {
+            record(Token::DOUBLE, value);
+            return *this;
+        }
+        appendDouble(line_, value);
+        return *this;
+    }
+
+    GCodeBuffer& operator<<(const MMtoStream coord)
+    {
+        const auto value = static_cast<int32_t>(coord.value); // Narrowed just like writeInt2mm does.
+        if (recording_)
+        {
+            record(Token::MM, value);
+            return *this;
+        }
+        appendMM(line_, value);
+        return *this;
+    }
+
+    GCodeBuffer& operator<<(const PrecisionedDouble value)
+    {
+        if (recording_)
+        {
+            char bytes[1 + sizeof(uint8_t) + sizeof(double)];
+            bytes[0] = static_cast<char>(Token::PRECISIONED_DOUBLE);
+            bytes[1] = static_cast<char>(value.precision);
+            std::memcpy(bytes + 2, &value.value, sizeof(double));
+            recorded_.append(bytes, sizeof(bytes));
+            return *this;
+        }
+        appendPrecisionedDouble(line_, value.precision, value.value);
+        return *this;
+    }
+
+    /*!
+     * \brief Anything else is formatted by its stream operator, on a stream set up like the target stream.
+     */
+    template<typename T>
+    GCodeBuffer& operator<<(const T& value)
+    {
+        fallback_stream_.str(std::string());
+        fallback_stream_ << value;
+        return *this << fallback_stream_.view();
+    }
+
+private:
+    /*!
+     * \brief The kinds of values in a recording. Each is stored as its tag byte followed by the raw bytes of the value.
+     */
+    enum class Token : char
+    {
+        SHORT_TEXT, //!< Followed by the length as uint8_t and the characters.
+        TEXT, //!< Followed by the length as uint32_t and the characters.
+        SIGNED, //!< An int64_t.
+        UNSIGNED, //!< A uint64_t.
+        DOUBLE, //!< A double, formatted as by std::fixed.
+        MM, //!< An int32_t coordinate in microns, formatted as by writeInt2mm.
+        PRECISIONED_DOUBLE, //!< The precision as uint8_t and the double, formatted as by writeDoubleToStream.
+    };
+
+    std::unique_ptr<StreamSink> stream_sink_; //!< Wraps the stream given to setStream(), if any.
+    GCodeSink* sink_; //!< The sink to write the lines to.
+    std::string line_; //!< Text that wasn't written yet. Its capacity is reused for the next lines.
+    std::ostringstream fallback_stream_; //!< Formats types without a dedicated overload.
+    bool recording_ = false; //!< Whether the output is recorded rather than written.
+    std::string recorded_; //!< The output recorded since startRecording().
+
+    void appendText(const std::string_view text)
+    {
+        if (recording_)
+        {
+            if (text.size() <= std::numeric_limits<uint8_t>::max())
+            {
+                record(Token::SHORT_TEXT, static_cast<uint8_t>(text.size()));
+            }
+            else
+            {
+                record(Token::TEXT, static_cast<uint32_t>(text.size()));
+            }
+            recorded_.append(text);
+            return;
+        }
+        line_.append(text);
+        if (! text.empty() && text.back() == '\n')
+        {
+            flush();
+        }
+    }
+
+    template<typename T>
+    void record(const Token token, const T value)
+    {
+        char bytes[1 + sizeof(T)];
+        bytes[0] = static_cast<char>(token);
+        std::memcpy(bytes + 1, &value, sizeof(T));
+        recorded_.append(bytes, sizeof(bytes));
+    }
+
+    /*!
+     * \brief Appends a micron value in millimetres, without trailing zeros.
+     *
+     * Same output as writeInt2mm.
+     */
+    static void appendMM(std::string& text, const int32_t coord);
+
+    /*!
+     * \brief Appends a double with \p precision decimals, stripped of trailing zeros.
+     *
+     * Same output as writeDoubleToStream.
+     */
+    static void appendPrecisionedDouble(std::string& text, const uint8_t precision, const double value);
+
+    /*!
+     * \brief Appends a double with 6 decimals, as a stream set to std::fixed does.
+     */
+    static void appendDouble(std::string& text, const double value);
+};
+
+} // namespace cura
+
+#endif // UTILS_GCODE_BUFFER_H
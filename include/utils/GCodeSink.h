@@ -0,0 +1,158 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_GCODE_SINK_H
+#define UTILS_GCODE_SINK_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "utils/NoCopy.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Destination of the g-code text, e.g. a file, the front-end or a compressor in front of either.
+ *
+ * Every sink counts the bytes written to it, so that the size of the output can be reported.
+ */
+class GCodeSink : public NoCopy
+{
+public:
+    virtual ~GCodeSink() = default;
+
+    /*!
+     * \brief Write a chunk of g-code.
+     */
+    void write(const std::string_view data)
+    {
+        bytes_written_ += data.size();
+        writeData(data);
+    }
+
+    /*!
+     * \brief Push the g-code written so far through to its final destination, e.g. the disk.
+     */
+    virtual void flush()
+    {
+    }
+
+    /*!
+     * \brief Complete the output after the last g-code is written, e.g. end the compressed stream and close the file.
+     *
+     * Sinks that stay usable afterwards, like streams, just flush.
+     * \return Whether all g-code written to this sink reached its destination.
+     */
+    virtual bool finish()
+    {
+        flush();
+        return ! hasFailed();
+    }
+
+    /*!
+     * \brief Whether writing to the destination failed, so that (some of) the g-code is lost.
+     */
+    virtual bool hasFailed() const
+    {
+        return failed_;
+    }
+
+    /*!
+     * \brief The number of bytes written to this sink.
+     */
+    size_t getBytesWritten() const
+    {
+        return bytes_written_;
+    }
+
+protected:
+    /*!
+     * \brief Store or pass on a chunk of g-code.
+     */
+    virtual void writeData(const std::string_view data) = 0;
+
+    /*!
+     * \brief Remember that the g-code could not be written, so that it can be reported once the output is finished.
+     */
+    void markFailed()
+    {
+        failed_ = true;
+    }
+
+private:
+    size_t bytes_written_ = 0; //!< Bytes written to this sink since its construction.
+    bool failed_ = false; //!< Whether writing to the destination failed.
+};
+
+/*!
+ * \brief Writes the g-code to a standard output stream.
+ */
+class StreamSink : public GCodeSink
+{
+public:
+    explicit StreamSink(std::ostream* stream)
+        : stream_(stream)
+    {
+    }
+
+    void flush() override
+    {
+        if (! stream_->flush())
+        {
+            markFailed();
+        }
+    }
+
+protected:
+    void writeData(const std::string_view data) override
+    {
+        if (! stream_->write(data.data(), static_cast<std::streamsize>(data.size())))
+        {
+            markFailed();
+        }
+    }
+
+private:
+    std::ostream* stream_; //!< The stream to write to.
+};
+
+/*!
+ * \brief Collects the g-code in memory, to be sent off in chunks, like to the front-end over the socket.
+ *
+ * Taking out the data by clear() keeps the memory of the sink, so it is reused for every chunk.
+ */
+class MemorySink : public GCodeSink
+{
+public:
+    /*!
+     * \brief The g-code written since the last clear().
+     */
+    std::string_view view() const
+    {
+        return buffer_;
+    }
+
+    /*!
+     * \brief Discard the collected g-code, once it is sent off.
+     */
+    void clear()
+    {
+        buffer_.clear();
+    }
+
+protected:
+    void writeData(const std::string_view data) override
+    {
+        buffer_.append(data);
+    }
+
+private:
+    std::string buffer_; //!< The collected g-code.
+};
+
+} // namespace cura
+
+#endif // UTILS_GCODE_SINK_H
@@ -7,6 +7,7 @@
 
 #include <list>
 #include <cassert>
+#include <memory_resource>
 
 
 
@@ -24,8 +25,24 @@ class HalfEdgeGraph
 public:
     using edge_t = derived_edge_t;
     using node_t = derived_node_t;
-    std::list<edge_t> edges;
-    std::list<node_t> nodes;
+
+    HalfEdgeGraph() = default;
+
+    // The edges and nodes point to each other and are allocated in the arena of this graph, so they can't be copied to another graph.
+    HalfEdgeGraph(const HalfEdgeGraph&) = delete;
+    HalfEdgeGraph& operator=(const HalfEdgeGraph&) = delete;
+
+private:
+    /*!
+     * Where the edges and nodes are allocated, in large blocks rather than one
+     * by one. Memory of removed edges and nodes is only given back when the
+     * whole graph is destroyed. Declared before the lists so it outlives them.
+     */
+    std::pmr::monotonic_buffer_resource arena_;
+
+public:
+    std::pmr::list<edge_t> edges{ &arena_ };
+    std::pmr::list<node_t> nodes{ &arena_ };
 };
 
 } // namespace cura
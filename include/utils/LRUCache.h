@@ -0,0 +1,98 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_LRU_CACHE_H
+#define UTILS_LRU_CACHE_H
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace cura
+{
+
+/*!
+ * \brief A map of limited size, which forgets the least recently used entry when it is full.
+ *
+ * \tparam Key The type of the keys. Must be hashable with \p Hash.
+ * \tparam Value The type of the values.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache
+{
+public:
+    /*!
+     * \param capacity The maximum number of entries to keep.
+     */
+    explicit LRUCache(const size_t capacity)
+        : capacity_(capacity)
+    {
+        assert(capacity_ > 0);
+    }
+
+    // The index refers into the list of entries, so a copy would refer into the wrong list. Moving keeps those references valid.
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+    LRUCache(LRUCache&&) noexcept = default;
+    LRUCache& operator=(LRUCache&&) noexcept = default;
+
+    /*!
+     * \brief Look up a value, and mark it as the most recently used.
+     * \return The value, or nullptr if it isn't in the cache. The pointer stays valid until the next insertion.
+     */
+    const Value* find(const Key& key)
+    {
+        const auto found = index_.find(key);
+        if (found == index_.end())
+        {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return &found->second->second;
+    }
+
+    /*!
+     * \brief Store a value, replacing any value stored before for the same key.
+     */
+    void insert(const Key& key, Value value)
+    {
+        const auto found = index_.find(key);
+        if (found != index_.end())
+        {
+            found->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return;
+        }
+        if (index_.size() >= capacity_)
+        {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_.emplace(key, entries_.begin());
+    }
+
+    size_t size() const
+    {
+        return index_.size();
+    }
+
+    void clear()
+    {
+        index_.clear();
+        entries_.clear();
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    size_t capacity_; //!< The maximum number of entries.
+    Entries entries_; //!< The entries, from the most to the least recently used.
+    std::unordered_map<Key, typename Entries::iterator, Hash> index_; //!< Where to find each key in \ref entries_.
+};
+
+} // namespace cura
+
+#endif // UTILS_LRU_CACHE_H
@@ -0,0 +1,33 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_LAYER_WINDOW_INTERSECTION_H
+#define UTILS_LAYER_WINDOW_INTERSECTION_H
+
+#include <vector>
+
+#include "geometry/Shape.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Intersect the areas of every run of \p window_size consecutive layers.
+ *
+ * Intersecting each window on its own takes \p window_size - 1 intersections per layer, most of which are the same for neighbouring
+ * windows. Instead, the layers are divided in blocks of \p window_size layers. Within each block the running intersections from the start of
+ * the block and towards the end of the block are computed. Every window then covers the end of one block and the start of the next, so it
+ * takes one more intersection of those, making it about three intersections per layer whatever the size of the window.
+ *
+ * The blocks and the windows are computed in parallel.
+ *
+ * \param layer_areas The area of each layer.
+ * \param window_size The number of layers to intersect for each window.
+ * \return For each layer, the intersection of the areas of that layer and the \p window_size - 1 layers after it. Windows that would go past
+ * the last layer are empty, as there is nothing above the last layer. If \p window_size is 0, all windows are empty.
+ */
+std::vector<Shape> intersectLayerWindows(const std::vector<Shape>& layer_areas, const size_t window_size);
+
+} // namespace cura
+
+#endif // UTILS_LAYER_WINDOW_INTERSECTION_H
@@ -0,0 +1,195 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_PATH_VERTEX_GRID_H
+#define UTILS_PATH_VERTEX_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "geometry/Point2LL.h"
+
+namespace cura
+{
+
+/*!
+ * \brief Spatial index of the vertices where paths may start, for finding the nearest path that isn't used yet.
+ *
+ * The vertices are sorted into a fixed grid, sized to hold a few vertices per cell. Paths are removed from the grid once they're used. The
+ * vertices of removed paths are dropped from their cells the next time those cells are visited, so a search only ever looks at cells and
+ * vertices that are still relevant.
+ *
+ * Searches for the nearest path visit the cells in rings of growing size around the query point, until no unvisited cell can hold a
+ * closer vertex. Once a ring would hold more cells than are left with vertices in them, the remaining non-empty cells are visited instead.
+ * So the search never costs more than going over what is left, like a linear search would.
+ */
+class PathVertexGrid
+{
+public:
+    struct Vertex
+    {
+        Point2LL point; //!< Where the path could start.
+        size_t path; //!< The index of the path.
+    };
+
+    /*!
+     * \param vertices The vertices of all paths.
+     * \param path_count The number of paths, i.e. one more than the highest path index.
+     */
+    PathVertexGrid(std::vector<Vertex> vertices, const size_t path_count);
+
+    /*!
+     * \brief Whether all paths with vertices have been removed.
+     */
+    bool empty() const
+    {
+        return remaining_paths_ == 0;
+    }
+
+    /*!
+     * \brief Remove a path, so that it is no longer found.
+     */
+    void remove(const size_t path);
+
+    /*!
+     * \brief Get the paths with a vertex within a radius around a point.
+     * \return The indices of the paths, in increasing order and without duplicates.
+     */
+    std::vector<size_t> getNearbyPaths(const Point2LL& query_point, const coord_t radius);
+
+    /*!
+     * \brief Visit the vertices of the remaining paths, roughly from near to far, until no closer vertices can be found.
+     *
+     * The visitor decides which vertex is the best match. It is called as `coord_t visit(const Vertex&)` and returns the squared distance of
+     * the best match so far, or the maximum coord_t if there is none yet. The search stops once all vertices nearer than that distance
+     * were visited. Vertices may be visited more than once.
+     */
+    template<typename Visitor>
+    void visitNearestFirst(const Point2LL& query_point, Visitor&& visit)
+    {
+        coord_t best_distance2 = std::numeric_limits<coord_t>::max();
+        const auto visit_cell = [this, &visit, &best_distance2](const size_t cell)
+        {
+            forRemainingVertices(
+                cell,
+                [&visit, &best_distance2](const Vertex& vertex)
+                {
+                    best_distance2 = std::min(best_distance2, visit(vertex));
+                });
+        };
+
+        if (! inside(query_point))
+        {
+            visitAllCells(visit_cell);
+            return;
+        }
+
+        const coord_t query_column = (query_point.X - min_.X) / cell_size_;
+        const coord_t query_row = (query_point.Y - min_.Y) / cell_size_;
+        const coord_t max_ring = std::max({ query_column, column_count_ - 1 - query_column, query_row, row_count_ - 1 - query_row });
+        for (coord_t ring = 0; ring <= max_ring; ++ring)
+        {
+            const size_t ring_cell_count = ring == 0 ? 1 : 8 * static_cast<size_t>(ring);
+            if (ring_cell_count > non_empty_cells_.size())
+            {
+                visitAllCells(visit_cell);
+                return;
+            }
+
+            const coord_t min_row = std::max(coord_t(0), query_row - ring);
+            const coord_t max_row = std::min(row_count_ - 1, query_row + ring);
+            for (coord_t row = min_row; row <= max_row; ++row)
+            {
+                const bool is_edge_row = row == query_row - ring || row == query_row + ring;
+                const coord_t column_step = is_edge_row ? 1 : 2 * ring; // Only the outline of the ring, the inside was visited before.
+                for (coord_t column = query_column - ring; column <= query_column + ring; column += std::max(coord_t(1), column_step))
+                {
+                    if (column >= 0 && column < column_count_)
+                    {
+                        visit_cell(static_cast<size_t>(row * column_count_ + column));
+                    }
+                }
+            }
+
+            // All vertices outside the rings visited so far are at least this far away.
+            const coord_t searched_radius = ring * cell_size_;
+            if (best_distance2 < searched_radius * searched_radius)
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    Point2LL min_; //!< The minimum corner of the bounding box of the vertices.
+    Point2LL max_; //!< The maximum corner of the bounding box of the vertices.
+    coord_t cell_size_;
+    coord_t column_count_;
+    coord_t row_count_;
+
+    std::vector<Vertex> vertices_; //!< The vertices, sorted by cell.
+    std::vector<size_t> cell_begin_; //!< For each cell, where its vertices start in \ref vertices_.
+    std::vector<size_t> cell_size_left_; //!< For each cell, how many of its vertices may still belong to remaining paths.
+    std::vector<size_t> non_empty_cells_; //!< The cells with vertices that may still belong to remaining paths, in no particular order.
+    std::vector<size_t> non_empty_position_; //!< For each cell, where it is in \ref non_empty_cells_.
+    std::vector<bool> removed_; //!< For each path, whether it was removed.
+    size_t remaining_paths_ = 0; //!< The number of paths with vertices that weren't removed yet.
+
+    bool inside(const Point2LL& point) const
+    {
+        return point.X >= min_.X && point.X <= max_.X && point.Y >= min_.Y && point.Y <= max_.Y;
+    }
+
+    /*!
+     * Call a function for each vertex in a cell that belongs to a remaining path, and drop the vertices of removed paths from the cell.
+     */
+    template<typename Function>
+    void forRemainingVertices(const size_t cell, Function&& function)
+    {
+        size_t& size = cell_size_left_[cell];
+        if (size == 0)
+        {
+            return;
+        }
+        Vertex* cell_vertices = vertices_.data() + cell_begin_[cell];
+        for (size_t i = 0; i < size;)
+        {
+            if (removed_[cell_vertices[i].path])
+            {
+                std::swap(cell_vertices[i], cell_vertices[size - 1]);
+                --size;
+                continue;
+            }
+            function(cell_vertices[i]);
+            ++i;
+        }
+        if (size == 0)
+        {
+            dropCell(cell);
+        }
+    }
+
+    /*!
+     * Call a function for each cell that may still hold vertices of remaining paths.
+     */
+    template<typename Function>
+    void visitAllCells(Function&& visit_cell)
+    {
+        // Backwards, since visiting a cell may drop it from the list by moving the last cell into its place.
+        for (size_t i = non_empty_cells_.size(); i > 0; --i)
+        {
+            visit_cell(non_empty_cells_[i - 1]);
+        }
+    }
+
+    /*!
+     * Take a cell out of the list of non-empty cells.
+     */
+    void dropCell(const size_t cell);
+};
+
+} // namespace cura
+
+#endif // UTILS_PATH_VERTEX_GRID_H
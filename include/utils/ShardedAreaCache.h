@@ -0,0 +1,400 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#ifndef UTILS_SHARDED_AREA_CACHE_H
+#define UTILS_SHARDED_AREA_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "geometry/Polygon.h"
+#include "geometry/Shape.h"
+#include "utils/AreaSpillStore.h"
+#include "utils/math.h"
+
+namespace cura
+{
+
+/*!
+ * \brief A map from keys to areas, which many threads can read from and add to at once.
+ *
+ * The areas are spread over a number of shards, each with its own lock, so threads adding areas for different keys hardly ever wait for each other,
+ * and threads that only read never wait for each other.
+ *
+ * Once all areas that are known to be needed have been added, the cache can be frozen. Reading the areas that were added before that takes no lock
+ * at all. Areas added later on go to a separate map with a lock of its own.
+ *
+ * Areas are never replaced. Unless they are spilled, they are never removed either, so a reference to an area stays valid as long as the
+ * cache exists. To save memory, areas that aren't needed for a while can be spilled to an \ref AreaSpillStore, from where they are loaded
+ * back when they are looked up again.
+ *
+ * \tparam Key The type of the keys. Must be hashable with \p Hash.
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class ShardedAreaCache
+{
+public:
+    ShardedAreaCache()
+        : data_(std::make_unique<Data>())
+    {
+    }
+
+    /*!
+     * \brief Look up the area of a key.
+     * \return The area, or an empty optional if no area was added for the key yet.
+     */
+    std::optional<std::reference_wrapper<const Shape>> find(const Key& key) const
+    {
+        const Shard& shard = shardOf(key);
+        if (data_->frozen.load(std::memory_order_acquire))
+        {
+            // The shards don't change anymore once frozen.
+            const auto found = shard.areas.find(key);
+            if (found != shard.areas.end())
+            {
+                data_->hits.fetch_add(1, std::memory_order_relaxed);
+                return found->second;
+            }
+        }
+        else
+        {
+            std::shared_lock lock(shard.mutex);
+            const auto found = shard.areas.find(key);
+            if (found != shard.areas.end())
+            {
+                data_->hits.fetch_add(1, std::memory_order_relaxed);
+                return found->second;
+            }
+        }
+        if (! data_->has_overflow.load(std::memory_order_acquire))
+        {
+            data_->misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        return findOverflow(key);
+    }
+
+    /*!
+     * \brief Whether an area was added for a key, in memory or spilled.
+     *
+     * Unlike \ref find, this doesn't load a spilled area back.
+     */
+    bool contains(const Key& key) const
+    {
+        const Shard& shard = shardOf(key);
+        if (data_->frozen.load(std::memory_order_acquire))
+        {
+            if (shard.areas.contains(key))
+            {
+                return true;
+            }
+        }
+        else
+        {
+            std::shared_lock lock(shard.mutex);
+            if (shard.areas.contains(key))
+            {
+                return true;
+            }
+        }
+        if (! data_->has_overflow.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        std::shared_lock lock(data_->late_mutex);
+        return data_->late_areas.contains(key) || data_->spilled_areas.contains(key);
+    }
+
+    /*!
+     * \brief Add the areas of a range of key-area pairs. Keys that already have an area keep their area.
+     */
+    template<typename Iterator>
+    void insert(Iterator begin, const Iterator end)
+    {
+        for (; begin != end; ++begin)
+        {
+            insert(begin->first, begin->second);
+        }
+    }
+
+    /*!
+     * \brief Add the area of a key, if the key doesn't have one yet.
+     */
+    void insert(const Key& key, const Shape& area)
+    {
+        Shard& shard = shardOf(key);
+        if (! data_->frozen.load(std::memory_order_acquire))
+        {
+            std::unique_lock lock(shard.mutex);
+            // Check again, as the cache may have been frozen while waiting for the lock.
+            if (! data_->frozen.load(std::memory_order_relaxed))
+            {
+                if (! shard.areas.emplace(key, area).second)
+                {
+                    return;
+                }
+                account(area);
+                lock.unlock();
+                if (data_->has_overflow.load(std::memory_order_acquire))
+                {
+                    // The area may have been spilled and recalculated since.
+                    std::unique_lock late_lock(data_->late_mutex);
+                    discardSpilled(key);
+                }
+                return;
+            }
+        }
+
+        if (shard.areas.contains(key))
+        {
+            return;
+        }
+        std::unique_lock lock(data_->late_mutex);
+        if (data_->spilled_areas.contains(key))
+        {
+            return;
+        }
+        if (data_->late_areas.emplace(key, area).second)
+        {
+            account(area);
+            data_->has_overflow.store(true, std::memory_order_release);
+        }
+    }
+
+    /*!
+     * \brief Stop changing the shards, so that the areas added so far can be read without locking.
+     *
+     * Waits for any areas that are being added at the moment.
+     */
+    void freeze()
+    {
+        std::array<std::unique_lock<std::shared_mutex>, shard_count_> locks;
+        for (size_t shard_idx = 0; shard_idx < shard_count_; ++shard_idx)
+        {
+            locks[shard_idx] = std::unique_lock(data_->shards[shard_idx].mutex);
+        }
+        data_->frozen.store(true, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Allow areas to be spilled to a store, see \ref spill.
+     * \param store Where to keep the spilled areas. Must outlive the cache.
+     */
+    void enableSpilling(AreaSpillStore* store)
+    {
+        data_->spill_store = store;
+    }
+
+    /*!
+     * \brief Move areas out of memory, to the compact form of the spill store. A spilled area is loaded back when it is looked up.
+     *
+     * This invalidates references to the spilled areas. As frozen areas are read without locking, no other thread may use the cache
+     * meanwhile.
+     *
+     * \param should_spill Whether to spill the area of a key.
+     * \return Roughly how many bytes were freed.
+     */
+    template<typename Predicate>
+    size_t spill(Predicate&& should_spill)
+    {
+        if (! data_->spill_store)
+        {
+            return 0;
+        }
+        size_t freed = 0;
+        const auto spill_from = [&](std::unordered_map<Key, Shape, Hash>& areas)
+        {
+            for (auto it = areas.begin(); it != areas.end();)
+            {
+                if (! should_spill(it->first))
+                {
+                    ++it;
+                    continue;
+                }
+                data_->spilled_areas.emplace(it->first, data_->spill_store->store(it->second));
+                const size_t bytes = approximateBytes(it->second);
+                data_->area_count.fetch_sub(1, std::memory_order_relaxed);
+                data_->bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                freed += bytes;
+                it = areas.erase(it);
+            }
+        };
+
+        std::unique_lock late_lock(data_->late_mutex);
+        for (Shard& shard : data_->shards)
+        {
+            std::unique_lock lock(shard.mutex);
+            spill_from(shard.areas);
+        }
+        spill_from(data_->late_areas);
+        if (! data_->spilled_areas.empty())
+        {
+            data_->has_overflow.store(true, std::memory_order_release);
+        }
+        return freed;
+    }
+
+    /*!
+     * \brief How many areas the cache holds in memory.
+     */
+    size_t size() const
+    {
+        return data_->area_count.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Roughly how many bytes the areas in memory take up.
+     *
+     * Only the areas themselves are counted, not the bookkeeping of the maps.
+     */
+    size_t getMemoryUsage() const
+    {
+        return data_->bytes.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief How many areas are spilled at the moment.
+     */
+    size_t getSpilledCount() const
+    {
+        std::shared_lock lock(data_->late_mutex);
+        return data_->spilled_areas.size();
+    }
+
+    /*!
+     * \brief How many lookups found an area in memory.
+     */
+    size_t getHits() const
+    {
+        return data_->hits.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief How many lookups found no area at all.
+     */
+    size_t getMisses() const
+    {
+        return data_->misses.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief How many lookups had to load a spilled area back.
+     */
+    size_t getReloads() const
+    {
+        return data_->reloads.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t shard_count_ = 32;
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, Shape, Hash> areas;
+    };
+
+    /*!
+     * Everything is kept on the heap, as mutexes can't be moved.
+     */
+    struct Data
+    {
+        std::array<Shard, shard_count_> shards;
+        std::atomic<bool> frozen{ false };
+        std::atomic<bool> has_overflow{ false }; //!< Whether there may be late or spilled areas.
+        mutable std::shared_mutex late_mutex; //!< Guards \ref late_areas and \ref spilled_areas.
+        std::unordered_map<Key, Shape, Hash> late_areas; //!< The areas added after freezing, or loaded back after spilling.
+        std::unordered_map<Key, size_t, Hash> spilled_areas; //!< The identifiers of the spilled areas in \ref spill_store.
+        AreaSpillStore* spill_store = nullptr;
+        std::atomic<size_t> area_count{ 0 };
+        std::atomic<size_t> bytes{ 0 };
+        std::atomic<size_t> hits{ 0 };
+        std::atomic<size_t> misses{ 0 };
+        std::atomic<size_t> reloads{ 0 };
+    };
+
+    std::unique_ptr<Data> data_;
+
+    Shard& shardOf(const Key& key) const
+    {
+        return data_->shards[shard_index(Hash{}(key), shard_count_)];
+    }
+
+    std::optional<std::reference_wrapper<const Shape>> findOverflow(const Key& key) const
+    {
+        {
+            std::shared_lock lock(data_->late_mutex);
+            const auto found = data_->late_areas.find(key);
+            if (found != data_->late_areas.end())
+            {
+                data_->hits.fetch_add(1, std::memory_order_relaxed);
+                return found->second;
+            }
+            if (! data_->spilled_areas.contains(key))
+            {
+                data_->misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+        }
+
+        std::unique_lock lock(data_->late_mutex);
+        // Another thread may have loaded the area back while waiting for the lock.
+        const auto found = data_->late_areas.find(key);
+        if (found != data_->late_areas.end())
+        {
+            data_->hits.fetch_add(1, std::memory_order_relaxed);
+            return found->second;
+        }
+        const auto spilled = data_->spilled_areas.find(key);
+        if (spilled == data_->spilled_areas.end())
+        {
+            data_->misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        Shape area = data_->spill_store->load(spilled->second);
+        data_->spilled_areas.erase(spilled);
+        data_->reloads.fetch_add(1, std::memory_order_relaxed);
+        const Shape& loaded = data_->late_areas.emplace(key, std::move(area)).first->second;
+        account(loaded);
+        return loaded;
+    }
+
+    /*!
+     * \brief Forget a spilled area. Requires a unique lock on \ref Data::late_mutex.
+     */
+    void discardSpilled(const Key& key)
+    {
+        const auto spilled = data_->spilled_areas.find(key);
+        if (spilled != data_->spilled_areas.end())
+        {
+            data_->spill_store->discard(spilled->second);
+            data_->spilled_areas.erase(spilled);
+        }
+    }
+
+    static size_t approximateBytes(const Shape& area)
+    {
+        size_t bytes = sizeof(Shape) + area.size() * sizeof(Polygon);
+        for (const Polygon& polygon : area)
+        {
+            bytes += polygon.size() * sizeof(Point2LL);
+        }
+        return bytes;
+    }
+
+    void account(const Shape& area) const
+    {
+        data_->area_count.fetch_add(1, std::memory_order_relaxed);
+        data_->bytes.fetch_add(approximateBytes(area), std::memory_order_relaxed);
+    }
+};
+
+} // namespace cura
+
+#endif // UTILS_SHARDED_AREA_CACHE_H
@@ -4,10 +4,12 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <algorithm> // sort, inplace_merge
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
-#include <deque>
-#include <functional> // std::function<>
+#include <functional> // std::less<>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -19,17 +21,103 @@ namespace cura
 {
 
 /*!
- * \brief Very minimal and low level thread pool.
+ * \brief Counts down the tasks of a batch, so that the thread that submitted them can wait for their completion.
+ *
+ * Unlike waiting on the counter itself, waiting on a TaskLatch only returns once the last task is done touching the latch, so the
+ * latch (and the state of the batch next to it) may be destroyed right after `wait()` returns.
+ *
+ * Batches created from within a task of another batch remember that batch as their parent. A thread waiting for a batch only helps
+ * with the tasks of that batch and of its descendants, see ThreadPool::work_until().
+ */
+class TaskLatch
+{
+public:
+    //! Creates the latch of a batch of `count` tasks. Its parent is the batch of the task running on the calling thread, if any.
+    explicit TaskLatch(size_t count);
+
+    //! Called by each task of the batch when it completes
+    void count_down()
+    {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard lock(mutex_);
+            done_ = true;
+            done_condition_.notify_all();
+        }
+    }
+
+    //! Whether all tasks are completed. Only a hint: `wait()` must still be called before destroying the latch
+    bool is_ready() const
+    {
+        return remaining_.load(std::memory_order_acquire) == 0;
+    }
+
+    //! Blocks until all tasks are completed
+    void wait()
+    {
+        std::unique_lock lock(mutex_);
+        done_condition_.wait(
+            lock,
+            [this]
+            {
+                return done_;
+            });
+    }
+
+    //! Blocks until all tasks are completed, or until the timeout expires. Returns whether all tasks are completed
+    template<typename Duration>
+    bool wait_for(const Duration& timeout)
+    {
+        std::unique_lock lock(mutex_);
+        return done_condition_.wait_for(
+            lock,
+            timeout,
+            [this]
+            {
+                return done_;
+            });
+    }
+
+    //! Whether this batch is `ancestor`, or was created (indirectly) from within one of the tasks of `ancestor`
+    bool is_descendant_of(const TaskLatch& ancestor) const
+    {
+        for (const TaskLatch* latch = this; latch != nullptr; latch = latch->parent_)
+        {
+            if (latch == &ancestor)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const TaskLatch* parent_; // Outlives this latch: the parent task waits for this batch before it completes
+    std::atomic<size_t> remaining_;
+    std::mutex mutex_;
+    std::condition_variable done_condition_;
+    bool done_;
+};
+
+/*!
+ * \brief Very minimal and low level work stealing thread pool.
  *
  * Consider using `parallel_for()` instead, interfacing directly with this class should be reserved to concurrency primitives.
- * ThreadPool can be described as a synchronized FIFO queue shared by a fleet of `std::thread`s.
- * Tasks have the responsibility of unlocking the queue's lock passed as an argument while they do asynchronous work.
+ *
+ * Each worker thread has its own task queue, plus one queue shared by the threads that are not part of the pool (i.e. the main thread).
+ * Tasks are pushed on the queue of the pushing thread. A thread runs the most recently pushed task of its own queue first, and when that
+ * is empty steals the oldest task of another queue. Every queue has its own lock, so threads only contend when they work on the same
+ * queue.
+ *
+ * Tasks are plain function pointers with a context pointer and an index, so queuing them never allocates. The context is owned by the
+ * pushing code, which must keep it alive until the tasks are completed, tracked by the TaskLatch of their batch.
+ *
+ * Tasks may push and wait for batches of their own (nested parallelism). See work_until().
  */
 class ThreadPool
 {
 public:
-    using lock_t = std::unique_lock<std::mutex>;
-    using task_t = std::function<void(lock_t&)>;
+    using task_fn_t = void (*)(void* context, size_t index);
 
     //! Spawns a thread pool with `nthreads` threads
     ThreadPool(size_t nthreads);
@@ -45,53 +133,78 @@ public:
         return threads.size();
     }
 
-    //! Gets a lock on the queue, stopping the queuing or execution of new tasks while held
-    lock_t get_lock()
-    {
-        return lock_t(mutex);
-    }
-
     /*!
-     * \brief Pushes a new task while the queue is locked.
-     * \param func Closure that unlocks the local worker's lock passed as an argument while
-     * doing asynchronous work.
+     * \brief Queues a batch of tasks calling `function(context, index)` for every index in [0, count).
+     *
+     * The tasks have to count `latch` down themselves when they complete.
+     * Queues are bounded. When the queue of the calling thread is full, the tasks that don't fit are run right away on the calling thread.
      */
-    template<typename F>
-    void push(const lock_t& lock [[maybe_unused]], F&& func)
-    {
-        assert(lock);
-        tasks.push_back(std::forward<F>(func));
-        condition.notify_one();
-    }
+    void push(task_fn_t function, void* context, size_t count, TaskLatch& latch);
+
     /*!
-     * \brief Executes pending tasks while the predicates returns true
-     * This method doesn't wait unless predicate does (like implementation of ThreadPool::worker())
+     * \brief Runs a single queued task on the calling thread: the latest one of its own queue, or else one stolen from another queue.
+     * \return Whether a task was run. False if all queues were empty.
      */
-    template<typename P>
-    void work_while(lock_t& lock, P predicate)
-    {
-        assert(lock);
-        while (predicate() && ! tasks.empty()) // Order is important: predicate() might wait on an empty queue
-        {
-            assert(! tasks.empty());
-            task_t task = std::move(tasks.front());
-            tasks.pop_front();
+    bool run_one();
 
-            task(lock);
-            assert(lock);
-        }
-    }
+    /*!
+     * \brief Executes the tasks of the batch counted by `latch` until they are completed.
+     *
+     * The calling thread only runs tasks of this batch and of the batches created from within them, never unrelated tasks that could
+     * wait on something further up its own call stack. This makes it safe to call from within a task. When such tasks are all running on
+     * other threads, it waits for them, checking regularly whether they pushed nested tasks to help with.
+     */
+    void work_until(TaskLatch& latch);
 
 private:
-    void worker();
+    struct Task
+    {
+        task_fn_t function;
+        void* context;
+        size_t index;
+        TaskLatch* latch;
+    };
+
+    //! Bounded double-ended queue of tasks. The owner pushes and pops at the back, thieves take from the front.
+    struct alignas(64) TaskQueue
+    {
+        std::mutex mutex;
+        std::unique_ptr<Task[]> ring;
+        size_t head = 0; //!< Position of the oldest task, modulo the capacity
+        size_t tail = 0; //!< Position after the newest task, modulo the capacity
+        std::atomic<size_t> size = 0; //!< Number of tasks, readable without the lock to skip empty queues
+    };
+
+    void worker(size_t queue_idx);
 
     void join();
 
-    std::mutex mutex;
-    std::condition_variable condition;
-    std::deque<task_t> tasks;
-    std::vector<std::thread> threads;
+    //! Index of the queue of the calling thread: its own for workers of this pool, the shared one for any other thread
+    size_t current_queue_idx() const;
+
+    /*!
+     * Runs a single queued task, like run_one(), but only one belonging to `ancestor` or its descendants if that is set.
+     */
+    bool run_one(const TaskLatch* ancestor);
+
+    //! Runs a task on the calling thread, as part of its batch
+    static void run(const Task& task);
+
+    /*!
+     * Pops the newest task of a queue, or steals the oldest one.
+     * Fails if that task doesn't belong to `ancestor` or its descendants, when set.
+     */
+    bool take(TaskQueue& queue, bool steal, const TaskLatch* ancestor, Task& task);
+
+    size_t queue_capacity; //!< Capacity of each queue, a power of two
+    size_t queues_count;
+    std::unique_ptr<TaskQueue[]> queues; //!< One per worker thread, the last one is shared by all other threads
+    std::atomic<size_t> queued_tasks = 0; //!< Number of tasks in all queues
+    std::atomic<size_t> sleeping_workers = 0;
+    std::mutex idle_mutex; //!< Only used by idle workers to sleep
+    std::condition_variable idle_condition;
     bool wait_for_new_tasks;
+    std::vector<std::thread> threads;
 };
 
 
@@ -114,6 +227,11 @@ inline Signed distance(const Int& first, const Int& last)
  * The range of items is divided in chunks such that there is a maximum number of `chunks_per_worker` and such that
  * chunk size is a multiple of `chunk_size_factor`.
  *
+ * The loop body may itself call parallel_for. The inner loop is then split in chunks as well, and the calling thread runs its chunks
+ * (and helps with the ones stolen by other threads) instead of blocking.
+ *
+ * When no thread pool has been started, the loop simply runs on the calling thread.
+ *
  * \param from, to: The [inclusive, exclusive) range of iteration. Integers or random access iterators
  * \param body The loop-body, as a closure. Receives the index on invocation.
  * \param chunk_size_factor Chunk size will be a multiple of this number.
@@ -122,8 +240,6 @@ inline Signed distance(const Int& first, const Int& last)
 template<typename T, typename F>
 void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1, const size_t chunks_per_worker = 8)
 {
-    using lock_t = ThreadPool::lock_t;
-
     // Computes the number of items (early out if needed)
     const auto dist = distance(first, last);
     if (dist <= 0)
@@ -133,7 +249,14 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
     const size_t nitems = dist;
 
     ThreadPool* const thread_pool = Application::getInstance().thread_pool_;
-    assert(thread_pool);
+    if (thread_pool == nullptr)
+    { // No pool has been started (e.g. when used as a library or from unit tests), so just run the loop on this thread
+        for (T i = first; i < last; ++i)
+        {
+            loop_body(i);
+        }
+        return;
+    }
     const size_t nworkers = thread_pool->thread_count() + 1; // One task per std::thread + 1 for main thread
 
     size_t blocks; // Number of indivisible units of work (sized by chunk_size_factor)
@@ -155,56 +278,34 @@ void parallel_for(T first, T last, F&& loop_body, size_t chunk_size_factor = 1,
     assert(chunks * chunk_size >= nitems && (chunks - 1) * chunk_size < nitems);
     assert(chunks <= chunks_per_worker * nworkers && chunks <= blocks);
 
-    // Packs state variables such that they can be referenced by the task closure through a single reference
-    struct
+    // Packs state variables such that they can be referenced by the tasks through a single pointer
+    struct State
     {
         std::decay_t<F> loop_body; // User's closure data
-        size_t chunks_remaining;
-        std::condition_variable work_done = {};
-    } shared_state = { std::forward<F>(loop_body), chunks };
+        T first;
+        T last;
+        decltype(dist) chunk_increment;
+        TaskLatch chunks_done;
+    } state{ std::forward<F>(loop_body), first, last, chunk_increment, TaskLatch(chunks) };
 
-    // Schedules a task per chunk on the thread pool
-    lock_t lock = thread_pool->get_lock();
-    T chunk_last;
-    for (T chunk_first = first; chunk_first < last; chunk_first = chunk_last)
+    const auto run_chunk = [](void* context, size_t chunk_idx)
     {
-        if (distance(chunk_first, last) > chunk_increment)
-        { // Full size chunk
-            chunk_last = chunk_first + chunk_increment;
-        }
-        else
-        { // Adjust for the size of the last chunk
-            chunk_last = last;
+        State& chunk_state = *static_cast<State*>(context);
+        const T chunk_first = chunk_state.first + static_cast<decltype(dist)>(chunk_idx) * chunk_state.chunk_increment;
+        // Full size chunk, except for the last one
+        const T chunk_last = distance(chunk_first, chunk_state.last) > chunk_state.chunk_increment ? chunk_first + chunk_state.chunk_increment : chunk_state.last;
+        for (T i = chunk_first; i < chunk_last; ++i)
+        {
+            chunk_state.loop_body(i);
         }
+        chunk_state.chunks_done.count_down();
+    };
 
-        thread_pool->push(
-            lock,
-            [&shared_state, chunk_first, chunk_last](lock_t& th_lock)
-            {
-                th_lock.unlock(); // Enter unsynchronized region
-                for (T i = chunk_first; i < chunk_last; ++i)
-                {
-                    shared_state.loop_body(i);
-                }
-                th_lock.lock();
-                if (--shared_state.chunks_remaining == 0)
-                {
-                    shared_state.work_done.notify_one();
-                }
-            });
-    }
+    // Schedules a task per chunk on the thread pool
+    thread_pool->push(run_chunk, &state, chunks, state.chunks_done);
 
-    // Do work while parallel_for's tasks are running
-    thread_pool->work_while(
-        lock,
-        [&]
-        {
-            return shared_state.chunks_remaining > 0;
-        });
-    while (shared_state.chunks_remaining > 0) // Wait until all the task are completed
-    {
-        shared_state.work_done.wait(lock);
-    }
+    // Do work while parallel_for's tasks are running, then wait until all the task are completed
+    thread_pool->work_until(state.chunks_done);
 }
 
 /*!
@@ -218,6 +319,68 @@ auto parallel_for(Container& container, F&& loop_body, size_t chunk_size_factor
 }
 
 
+/*!
+ * \brief Sorts a random access range on the thread pool.
+ *
+ * The range is cut in one chunk per worker, the chunks are sorted in parallel and then merged pairwise, also in parallel, until a single
+ * sorted range remains. Like `std::sort()`, the sort is not stable.
+ *
+ * \param first, last The [inclusive, exclusive) range to sort.
+ * \param comp The strict weak ordering to sort by.
+ * \param min_chunk_size Ranges are not split further than this number of items, smaller ranges are sorted on the calling thread.
+ */
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp = {}, const size_t min_chunk_size = 4096)
+{
+    const auto dist = std::distance(first, last);
+    if (dist <= 0)
+    {
+        return;
+    }
+    const size_t nitems = dist;
+
+    ThreadPool* const thread_pool = Application::getInstance().thread_pool_;
+    const size_t nthreads = thread_pool == nullptr ? 1 : thread_pool->thread_count() + 1;
+    const size_t nchunks = std::min<size_t>(nthreads, round_up_divide(nitems, std::max<size_t>(min_chunk_size, 1)));
+    if (nchunks <= 1)
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<RandomIt> bounds;
+    bounds.reserve(nchunks + 1);
+    for (size_t chunk_idx = 0; chunk_idx <= nchunks; ++chunk_idx)
+    {
+        bounds.push_back(first + static_cast<decltype(dist)>(nitems * chunk_idx / nchunks));
+    }
+
+    parallel_for<size_t>(
+        0,
+        nchunks,
+        [&bounds, &comp](const size_t chunk_idx)
+        {
+            std::sort(bounds[chunk_idx], bounds[chunk_idx + 1], comp);
+        });
+
+    for (size_t width = 1; width < nchunks; width *= 2)
+    {
+        parallel_for<size_t>(
+            0,
+            round_up_divide(nchunks, 2 * width),
+            [&bounds, &comp, width, nchunks](const size_t pair_idx)
+            {
+                const size_t low = pair_idx * 2 * width;
+                const size_t mid = std::min(low + width, nchunks);
+                const size_t high = std::min(low + 2 * width, nchunks);
+                if (mid < high)
+                {
+                    std::inplace_merge(bounds[low], bounds[mid], bounds[high], comp);
+                }
+            });
+    }
+}
+
 //! \private Internal state for run_multiple_producers_ordered_consumer()
 template<typename Producer, typename Consumer>
 class MultipleProducersOrderedConsumer;
@@ -254,7 +417,7 @@ template<typename Producer, typename Consumer>
 class MultipleProducersOrderedConsumer
 {
     using item_t = std::invoke_result_t<Producer, ptrdiff_t>;
-    using lock_t = ThreadPool::lock_t;
+    using lock_t = std::unique_lock<std::mutex>;
 
 public:
     /*!
@@ -281,25 +444,27 @@ public:
         {
             return;
         }
-        workers_count_ = thread_pool.thread_count() + 1;
         // Start thread_pool.thread_count() workers on the thread pool
-        auto lock = thread_pool.get_lock();
-        for (size_t i = 1; i < workers_count_; i++)
+        const size_t pool_workers = thread_pool.thread_count();
+        TaskLatch workers_done(pool_workers);
+        workers_done_ = &workers_done;
+        const auto pool_worker = [](void* context, size_t)
         {
-            thread_pool.push(
-                lock,
-                [this](lock_t& th_lock)
-                {
-                    worker(th_lock);
-                });
-        }
+            auto& self = *static_cast<MultipleProducersOrderedConsumer*>(context);
+            {
+                lock_t lock(self.mutex_);
+                self.worker(lock);
+            }
+            self.workers_done_->count_down();
+        };
+        thread_pool.push(pool_worker, this, pool_workers, workers_done);
         // Run a worker on the main thread
-        worker(lock);
-        // Wait for completion of all workers
-        if (workers_count_ > 0)
         {
-            work_done_cond_.wait(lock);
+            lock_t lock(mutex_);
+            worker(lock);
         }
+        // Wait for completion of all workers
+        thread_pool.work_until(workers_done);
     }
 
 protected:
@@ -330,7 +495,7 @@ protected:
         item_t* slot = &queue_[(produced_idx + max_pending_) % max_pending_];
         assert(produced_idx < last_idx_);
 
-        // Unlocks global mutex while producing an item
+        // Unlocks the mutex while producing an item
         lock.unlock();
         item_t item = producer_(produced_idx);
         lock.lock();
@@ -348,7 +513,7 @@ protected:
         assert(read_idx_ < write_idx_);
         for (item_t* slot = &queue_[(read_idx_ + max_pending_) % max_pending_]; *slot; slot = &queue_[(read_idx_ + max_pending_) % max_pending_])
         {
-            // Unlocks global mutex while consuming an item
+            // Unlocks the mutex while consuming an item
             lock.unlock();
             consumer_(std::move(*slot));
             *slot = {};
@@ -367,7 +532,7 @@ protected:
         consumer_wait_idx_ = read_idx_; // The producer filling this slot will resume consumption
     }
 
-    //! Task pushed on the ThreadPool
+    //! Runs on the ThreadPool and on the main thread
     void worker(lock_t& lock)
     {
         while (wait(lock)) // While there is work to do
@@ -381,16 +546,10 @@ protected:
 
         // Notify eventual workers waiting for a free slot but never got one during the interval of producing the last items
         free_slot_cond_.notify_all();
-
-        if (--workers_count_ == 0)
-        { // Last worker exiting: signal run() about workers completion
-            work_done_cond_.notify_one();
-        }
     }
 
-    // Tracks worker completion
-    size_t workers_count_;
-    std::condition_variable work_done_cond_;
+    std::mutex mutex_; // Protects the indices and the ring buffer slots
+    TaskLatch* workers_done_; // Tracks completion of the workers running on the thread pool
 
     Producer producer_;
     Consumer consumer_;
@@ -5,6 +5,7 @@
 #define UTILS_MATH_H
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 
 #include "utils/types/generic.h"
@@ -48,5 +49,15 @@ template<utils::multipliable T>
     return (dividend + divisor - 1) / divisor;
 }
 
+[[nodiscard]] inline uint64_t mix_hash(const uint64_t hash) //!< Spread the lowest bits of a hash over the upper ones (Fibonacci hashing).
+{
+    return hash * 0x9E3779B97F4A7C15ULL;
+}
+
+[[nodiscard]] inline size_t shard_index(const size_t hash, const size_t shard_count) //!< Pick one of shard_count shards for a hash, also where size_t has 32 bits.
+{
+    return static_cast<size_t>((mix_hash(hash) >> 32) % shard_count);
+}
+
 } // namespace cura
 #endif // UTILS_MATH_H
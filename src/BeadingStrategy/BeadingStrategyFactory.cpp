@@ -4,9 +4,13 @@
 #include "BeadingStrategy/BeadingStrategyFactory.h"
 
 #include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #include <spdlog/spdlog.h>
 
+#include "BeadingStrategy/CachingBeadingStrategy.h"
 #include "BeadingStrategy/DistributedBeadingStrategy.h"
 #include "BeadingStrategy/LimitedBeadingStrategy.h"
 #include "BeadingStrategy/OuterWallInsetBeadingStrategy.h"
@@ -59,4 +63,80 @@ BeadingStrategyPtr BeadingStrategyFactory::makeStrategy(
     ret = make_unique<LimitedBeadingStrategy>(max_bead_count, move(ret));
     return ret;
 }
+
+namespace
+{
+
+using StrategyParameters = std::tuple<coord_t, coord_t, coord_t, double, bool, coord_t, coord_t, double, double, coord_t, coord_t, int, double>;
+
+std::mutex shared_strategies_mutex;
+std::map<StrategyParameters, std::shared_ptr<CachingBeadingStrategy>> shared_strategies;
+
+} // namespace
+
+std::shared_ptr<const BeadingStrategy> BeadingStrategyFactory::makeSharedStrategy(
+    const coord_t preferred_bead_width_outer,
+    const coord_t preferred_bead_width_inner,
+    const coord_t preferred_transition_length,
+    const double transitioning_angle,
+    const bool print_thin_walls,
+    const coord_t min_bead_width,
+    const coord_t min_feature_size,
+    const Ratio wall_split_middle_threshold,
+    const Ratio wall_add_middle_threshold,
+    const coord_t max_bead_count,
+    const coord_t outer_wall_offset,
+    const int inward_distributed_center_wall_count,
+    const Ratio minimum_variable_line_ratio)
+{
+    const StrategyParameters parameters{ preferred_bead_width_outer,
+                                         preferred_bead_width_inner,
+                                         preferred_transition_length,
+                                         transitioning_angle,
+                                         print_thin_walls,
+                                         min_bead_width,
+                                         min_feature_size,
+                                         wall_split_middle_threshold,
+                                         wall_add_middle_threshold,
+                                         max_bead_count,
+                                         outer_wall_offset,
+                                         inward_distributed_center_wall_count,
+                                         minimum_variable_line_ratio };
+    std::lock_guard<std::mutex> lock(shared_strategies_mutex);
+    std::shared_ptr<CachingBeadingStrategy>& strategy = shared_strategies[parameters];
+    if (! strategy)
+    {
+        strategy = std::make_shared<CachingBeadingStrategy>(makeStrategy(
+            preferred_bead_width_outer,
+            preferred_bead_width_inner,
+            preferred_transition_length,
+            transitioning_angle,
+            print_thin_walls,
+            min_bead_width,
+            min_feature_size,
+            wall_split_middle_threshold,
+            wall_add_middle_threshold,
+            max_bead_count,
+            outer_wall_offset,
+            inward_distributed_center_wall_count,
+            minimum_variable_line_ratio));
+    }
+    return strategy;
+}
+
+void BeadingStrategyFactory::clearSharedStrategies()
+{
+    std::lock_guard<std::mutex> lock(shared_strategies_mutex);
+    for (const auto& [parameters, strategy] : shared_strategies)
+    {
+        const size_t lookups = strategy->getHits() + strategy->getMisses();
+        spdlog::debug(
+            "Beading cache of {}: {} hits out of {} lookups ({:.1f}%).",
+            strategy->toString(),
+            strategy->getHits(),
+            lookups,
+            lookups == 0 ? 0.0 : 100.0 * static_cast<double>(strategy->getHits()) / static_cast<double>(lookups));
+    }
+    shared_strategies.clear();
+}
 } // namespace cura
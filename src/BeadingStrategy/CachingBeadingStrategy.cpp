@@ -0,0 +1,98 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "BeadingStrategy/CachingBeadingStrategy.h"
+
+#include <cstdint>
+
+#include "utils/math.h"
+
+namespace cura
+{
+
+CachingBeadingStrategy::CachingBeadingStrategy(BeadingStrategyPtr parent, const size_t max_size)
+    : BeadingStrategy(*parent)
+    , parent_(std::move(parent))
+    , max_shard_size_(max_size / shard_count_)
+{
+    name_ = "CachingBeadingStrategy";
+}
+
+size_t CachingBeadingStrategy::KeyHash::operator()(const std::pair<coord_t, coord_t>& key) const
+{
+    // Spread the thicknesses, which are often close together, over all bits. Fold the upper half in, for targets with a 32-bit size_t.
+    const uint64_t mixed = mix_hash(static_cast<uint64_t>(key.first)) ^ static_cast<uint64_t>(key.second);
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+}
+
+BeadingStrategy::Beading CachingBeadingStrategy::compute(coord_t thickness, coord_t bead_count) const
+{
+    const std::pair<coord_t, coord_t> key(thickness, bead_count);
+    Shard& shard = shards_[shard_index(KeyHash{}(key), shard_count_)];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto cached = shard.beadings.find(key);
+        if (cached != shard.beadings.end())
+        {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return cached->second;
+        }
+    }
+
+    // Compute outside of the lock. Another thread may compute the same beading meanwhile, which gives the same result.
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    Beading beading = parent_->compute(thickness, bead_count);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.beadings.size() < max_shard_size_)
+    {
+        shard.beadings.emplace(key, beading);
+    }
+    return beading;
+}
+
+coord_t CachingBeadingStrategy::getOptimalThickness(coord_t bead_count) const
+{
+    return parent_->getOptimalThickness(bead_count);
+}
+
+coord_t CachingBeadingStrategy::getTransitionThickness(coord_t lower_bead_count) const
+{
+    return parent_->getTransitionThickness(lower_bead_count);
+}
+
+coord_t CachingBeadingStrategy::getOptimalBeadCount(coord_t thickness) const
+{
+    return parent_->getOptimalBeadCount(thickness);
+}
+
+coord_t CachingBeadingStrategy::getTransitioningLength(coord_t lower_bead_count) const
+{
+    return parent_->getTransitioningLength(lower_bead_count);
+}
+
+double CachingBeadingStrategy::getTransitionAnchorPos(coord_t lower_bead_count) const
+{
+    return parent_->getTransitionAnchorPos(lower_bead_count);
+}
+
+std::vector<coord_t> CachingBeadingStrategy::getNonlinearThicknesses(coord_t lower_bead_count) const
+{
+    return parent_->getNonlinearThicknesses(lower_bead_count);
+}
+
+std::string CachingBeadingStrategy::toString() const
+{
+    return std::string("CachingBeadingStrategy+") + parent_->toString();
+}
+
+size_t CachingBeadingStrategy::getHits() const
+{
+    return hits_.load(std::memory_order_relaxed);
+}
+
+size_t CachingBeadingStrategy::getMisses() const
+{
+    return misses_.load(std::memory_order_relaxed);
+}
+
+} // namespace cura
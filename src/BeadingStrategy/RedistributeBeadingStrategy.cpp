@@ -63,7 +63,7 @@ double RedistributeBeadingStrategy::getTransitionAnchorPos(coord_t lower_bead_co
 
 std::string RedistributeBeadingStrategy::toString() const
 {
-    return toString() + parent_->toString();
+    return std::string("RedistributeBeadingStrategy+") + parent_->toString();
 }
 
 BeadingStrategy::Beading RedistributeBeadingStrategy::compute(coord_t thickness, coord_t bead_count) const
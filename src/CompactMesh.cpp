@@ -0,0 +1,131 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "CompactMesh.h"
+
+#include <limits>
+
+#include "mesh.h"
+#include "utils/ThreadPool.h"
+
+namespace cura
+{
+
+CompactMesh::CompactMesh(const Mesh& mesh)
+{
+    const size_t vertex_count = mesh.vertices_.size();
+    const size_t face_count = mesh.faces_.size();
+
+    // Don't trust the bounding box of the mesh for this: it gets expanded by the XY offset after slicing.
+    Point3LL min(std::numeric_limits<coord_t>::max(), std::numeric_limits<coord_t>::max(), std::numeric_limits<coord_t>::max());
+    Point3LL max(std::numeric_limits<coord_t>::lowest(), std::numeric_limits<coord_t>::lowest(), std::numeric_limits<coord_t>::lowest());
+    for (const MeshVertex& vertex : mesh.vertices_)
+    {
+        for (size_t dim = 0; dim < 3; ++dim)
+        {
+            min[dim] = std::min(min[dim], vertex.p_[dim]);
+            max[dim] = std::max(max[dim], vertex.p_[dim]);
+        }
+    }
+    origin_ = vertex_count > 0 ? min : Point3LL(0, 0, 0);
+    constexpr coord_t max_offset = std::numeric_limits<int32_t>::max();
+    is_32_bit_ = vertex_count == 0 || (max.x_ - min.x_ <= max_offset && max.y_ - min.y_ <= max_offset && max.z_ - min.z_ <= max_offset);
+
+    if (is_32_bit_)
+    {
+        x_32_.resize(vertex_count);
+        y_32_.resize(vertex_count);
+        z_32_.resize(vertex_count);
+    }
+    else
+    {
+        x_64_.resize(vertex_count);
+        y_64_.resize(vertex_count);
+        z_64_.resize(vertex_count);
+    }
+    cura::parallel_for<size_t>(
+        0,
+        vertex_count,
+        [&](const size_t vertex_idx)
+        {
+            const Point3LL& p = mesh.vertices_[vertex_idx].p_;
+            if (is_32_bit_)
+            {
+                x_32_[vertex_idx] = static_cast<int32_t>(p.x_ - origin_.x_);
+                y_32_[vertex_idx] = static_cast<int32_t>(p.y_ - origin_.y_);
+                z_32_[vertex_idx] = static_cast<int32_t>(p.z_ - origin_.z_);
+            }
+            else
+            {
+                x_64_[vertex_idx] = p.x_;
+                y_64_[vertex_idx] = p.y_;
+                z_64_[vertex_idx] = p.z_;
+            }
+        },
+        4096);
+
+    face_vertices_.resize(face_count);
+    face_connections_.resize(face_count);
+    cura::parallel_for<size_t>(
+        0,
+        face_count,
+        [&](const size_t face_idx)
+        {
+            const MeshFace& face = mesh.faces_[face_idx];
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                face_vertices_[face_idx][corner] = face.vertex_index_[corner];
+                face_connections_[face_idx][corner] = face.connected_face_index_[corner];
+            }
+        },
+        4096);
+
+    // Vertex to face incidence: count the faces per vertex, turn the counts into offsets, then fill in face order.
+    vertex_face_offsets_.assign(vertex_count + 1, 0);
+    for (const std::array<uint32_t, 3>& corners : face_vertices_)
+    {
+        for (const uint32_t vertex_idx : corners)
+        {
+            ++vertex_face_offsets_[vertex_idx + 1];
+        }
+    }
+    for (size_t vertex_idx = 0; vertex_idx < vertex_count; ++vertex_idx)
+    {
+        vertex_face_offsets_[vertex_idx + 1] += vertex_face_offsets_[vertex_idx];
+    }
+    vertex_faces_.resize(vertex_face_offsets_.back());
+    std::vector<uint32_t> fill_position(vertex_face_offsets_.begin(), vertex_face_offsets_.end() - 1);
+    for (size_t face_idx = 0; face_idx < face_count; ++face_idx)
+    {
+        for (const uint32_t vertex_idx : face_vertices_[face_idx])
+        {
+            vertex_faces_[fill_position[vertex_idx]++] = static_cast<uint32_t>(face_idx);
+        }
+    }
+}
+
+size_t CompactMesh::memoryUsage() const
+{
+    return (x_32_.capacity() + y_32_.capacity() + z_32_.capacity()) * sizeof(int32_t) + (x_64_.capacity() + y_64_.capacity() + z_64_.capacity()) * sizeof(coord_t)
+         + face_vertices_.capacity() * sizeof(face_vertices_[0]) + face_connections_.capacity() * sizeof(face_connections_[0])
+         + (vertex_face_offsets_.capacity() + vertex_faces_.capacity()) * sizeof(uint32_t);
+}
+
+void CompactMesh::clear()
+{
+    is_32_bit_ = true;
+    for (std::vector<int32_t>* coordinates : { &x_32_, &y_32_, &z_32_ })
+    {
+        std::vector<int32_t>().swap(*coordinates);
+    }
+    for (std::vector<coord_t>* coordinates : { &x_64_, &y_64_, &z_64_ })
+    {
+        std::vector<coord_t>().swap(*coordinates);
+    }
+    std::vector<std::array<uint32_t, 3>>().swap(face_vertices_);
+    std::vector<std::array<int32_t, 3>>().swap(face_connections_);
+    std::vector<uint32_t>(1, 0).swap(vertex_face_offsets_);
+    std::vector<uint32_t>().swap(vertex_faces_);
+}
+
+} // namespace cura
@@ -57,6 +57,11 @@ void FffGcodeWriter::setTargetStream(std::ostream* stream)
     gcode.setOutputStream(stream);
 }
 
+void FffGcodeWriter::setTargetSink(GCodeSink* sink)
+{
+    gcode.setOutputSink(sink);
+}
+
 double FffGcodeWriter::getTotalFilamentUsed(int extruder_nr)
 {
     return gcode.getTotalFilamentUsed(extruder_nr);
@@ -69,13 +74,38 @@ std::vector<Duration> FffGcodeWriter::getTotalPrintTimePerFeature()
 
 bool FffGcodeWriter::setTargetFile(const char* filename)
 {
-    output_file.open(filename);
-    if (output_file.is_open())
+    auto file = std::make_unique<FileDescriptorSink>();
+    if (! file->open(filename))
+    {
+        return false;
+    }
+    std::unique_ptr<CompressedSink> compression;
+    if (const std::optional<CompressedSink::Format> format = CompressedSink::formatForFile(filename))
+    {
+        if (CompressedSink::isSupported(*format))
+        {
+            compression = std::make_unique<CompressedSink>(*format, *file);
+            if (compression->hasFailed())
+            {
+                return false;
+            }
+        }
+        else
+        {
+            spdlog::warn("This build of CuraEngine can't compress g-code, writing {} uncompressed.", filename);
+        }
+    }
+    gcode.setOutputSink(compression ? static_cast<GCodeSink*>(compression.get()) : file.get());
+
+    // Complete the previous file, if any, before it is replaced.
+    if (GCodeSink* previous = output_compression ? static_cast<GCodeSink*>(output_compression.get()) : output_file.get(); previous != nullptr && ! previous->finish())
     {
-        gcode.setOutputStream(&output_file);
-        return true;
+        spdlog::error("Failed to write all g-code to the previous output file, it is incomplete.");
     }
-    return false;
+    output_compression.reset();
+    output_file = std::move(file);
+    output_compression = std::move(compression);
+    return true;
 }
 
 void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keeper)
@@ -183,6 +213,7 @@ void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keep
         total_layers,
         [&storage, total_layers, this](int layer_nr)
         {
+            layer_plan_buffer.renderRecordedLayers(); // Take rendering the g-code text off the thread that writes it.
             return std::make_optional(processLayer(storage, layer_nr, total_layers));
         },
         [this, total_layers](std::optional<ProcessLayerResult> result_opt)
@@ -193,6 +224,7 @@ void FffGcodeWriter::writeGCode(SliceDataStorage& storage, TimeKeeper& time_keep
         });
 
     layer_plan_buffer.flush();
+    spdlog::debug("Reused {} out of {} requested layer outlines.", storage.getLayerOutlinesHits(), storage.getLayerOutlinesHits() + storage.getLayerOutlinesMisses());
 
     Progress::messageProgressStage(Progress::Stage::FINISH, &time_keeper);
 
@@ -3964,7 +3996,7 @@ void FffGcodeWriter::addPrimeTower(const SliceDataStorage& storage, LayerPlan& g
     storage.primeTower.addToGcode(storage, gcode_layer, extruder_order, prev_extruder, gcode_layer.getExtruder());
 }
 
-void FffGcodeWriter::finalize()
+bool FffGcodeWriter::finalize()
 {
     const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
     if (mesh_group_settings.get<bool>("machine_heated_bed"))
@@ -4025,12 +4057,26 @@ void FffGcodeWriter::finalize()
     }
 
     gcode.writeComment("End of Gcode");
+    const bool complete = gcode.finishOutput();
+    if (! complete)
+    {
+        spdlog::error("Failed to write all g-code, the output is incomplete.");
+    }
+    if (output_compression)
+    {
+        spdlog::info("G-code size: {} bytes, compressed to {} bytes", output_compression->getBytesWritten(), output_file->getBytesWritten());
+    }
+    else
+    {
+        spdlog::info("G-code size: {} bytes", gcode.getOutputSink().getBytesWritten());
+    }
     /*
     the profile string below can be executed since the M25 doesn't end the gcode on an UMO and when printing via USB.
     gcode.writeCode("M25 ;Stop reading from this point on.");
     gcode.writeComment("Cura profile string:");
     gcode.writeComment(FffProcessor::getInstance()->getAllLocalSettingsString() + FffProcessor::getInstance()->getProfileString());
     */
+    return complete;
 }
 
 
@@ -12,6 +12,7 @@
 // Code smell: Order of the includes is important here, probably due to some forward declarations which might be masking some undefined behaviours
 // clang-format off
 #include "Application.h"
+#include "CompactMesh.h"
 #include "ConicalOverhang.h"
 #include "ExtruderTrain.h"
 #include "FffPolygonGenerator.h"
@@ -31,6 +32,7 @@
 #include "support.h"
 #include "TopSurface.h"
 #include "TreeSupport.h"
+#include "WallToolPathsCache.h"
 #include "WallsComputation.h"
 #include "infill/DensityProvider.h"
 #include "infill/ImageBasedDensityProvider.h"
@@ -121,6 +123,16 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
         return false;
     }
 
+    // Move the geometry of all meshes into the compact form that the slicer reads, releasing the original vertex and face data of each mesh
+    // right away to keep the peak memory usage down.
+    std::vector<CompactMesh> mesh_geometries;
+    mesh_geometries.reserve(meshgroup->meshes.size());
+    for (Mesh& mesh : meshgroup->meshes)
+    {
+        mesh_geometries.emplace_back(mesh);
+        mesh.clear();
+    }
+
     // variable layers
     AdaptiveLayerHeights* adaptive_layer_heights = nullptr;
     const bool use_variable_layer_heights = mesh_group_settings.get<bool>("adaptive_layer_height_enabled");
@@ -132,7 +144,7 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
         const auto variable_layer_height_variation_step = mesh_group_settings.get<coord_t>("adaptive_layer_height_variation_step");
         const auto adaptive_threshold = mesh_group_settings.get<coord_t>("adaptive_layer_height_threshold");
         adaptive_layer_heights
-            = new AdaptiveLayerHeights(layer_thickness, variable_layer_height_max_variation, variable_layer_height_variation_step, adaptive_threshold, meshgroup);
+            = new AdaptiveLayerHeights(layer_thickness, variable_layer_height_max_variation, variable_layer_height_variation_step, adaptive_threshold, meshgroup, mesh_geometries);
 
         // Get the amount of layers
         slice_layer_count = adaptive_layer_heights->getLayerCount();
@@ -208,7 +220,8 @@ bool FffPolygonGenerator::sliceModel(MeshGroup* meshgroup, TimeKeeper& timeKeepe
         }
 
         Mesh& mesh = meshgroup->meshes[mesh_idx];
-        Slicer* slicer = new Slicer(&mesh, layer_thickness, slice_layer_count, use_variable_layer_heights, adaptive_layer_height_values);
+        Slicer* slicer = new Slicer(&mesh, mesh_geometries[mesh_idx], layer_thickness, slice_layer_count, use_variable_layer_heights, adaptive_layer_height_values);
+        mesh_geometries[mesh_idx].clear(); // Release the geometry as soon as it is sliced.
 
         slicerList.push_back(slicer);
 
@@ -397,6 +410,7 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
     {
         removeEmptyFirstLayers(storage, storage.print_layer_count); // changes storage.print_layer_count!
     }
+    storage.invalidateLayerOutlines();
     if (storage.print_layer_count == 0)
     {
         spdlog::warn("Stopping process because there are no non-empty layers.");
@@ -411,12 +425,14 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
     AreaSupport::generateSupportAreas(storage);
     TreeSupport tree_support_generator(storage);
     tree_support_generator.generateSupportAreas(storage);
+    storage.invalidateLayerOutlines();
 
     computePrintHeightStatistics(storage);
 
     // handle helpers
     storage.primeTower.generatePaths(storage);
     storage.primeTower.subtractFromSupport(storage);
+    storage.invalidateLayerOutlines();
 
     spdlog::debug("Processing ooze shield");
     processOozeShield(storage);
@@ -430,6 +446,7 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
     {
         spdlog::debug("Processing platform adhesion");
         processPlatformAdhesion(storage);
+        storage.invalidateLayerOutlines();
     }
 
     spdlog::debug("Meshes post-processing");
@@ -442,6 +459,7 @@ void FffPolygonGenerator::slices2polygons(SliceDataStorage& storage, TimeKeeper&
     spdlog::debug("Processing gradual support");
     // generate gradual support
     AreaSupport::generateSupportInfillFeatures(storage);
+    storage.invalidateLayerOutlines();
 }
 
 void FffPolygonGenerator::processBasicWallsSkinInfill(
@@ -495,15 +513,17 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
     } guarded_progress = { inset_skin_progress_estimate };
 
     // walls
+    WallToolPathsCache walls_cache(mesh.settings);
     cura::parallel_for<size_t>(
         0,
         mesh_layer_count,
         [&](size_t layer_number)
         {
             spdlog::debug("Processing insets for layer {} of {}", layer_number, mesh.layers.size());
-            processWalls(mesh, layer_number);
+            processWalls(mesh, layer_number, walls_cache);
             guarded_progress++;
         });
+    spdlog::debug("Reused the walls of {} out of {} layer parts.", walls_cache.getHits(), walls_cache.getHits() + walls_cache.getMisses());
 
     ProgressEstimatorLinear* skin_estimator = new ProgressEstimatorLinear(mesh_layer_count);
     mesh_inset_skin_progress_estimator->nextStage(skin_estimator);
@@ -537,6 +557,9 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
         mesh_max_initial_bottom_layer_count = std::max(mesh_max_initial_bottom_layer_count, mesh.settings.get<size_t>("initial_bottom_layers"));
     }
 
+    // With spiralize only the first few layers get skin, so then the solid areas of the whole mesh aren't worth computing.
+    const SkinSolidAreas solid_areas = magic_spiralize ? SkinSolidAreas() : SkinInfillAreaComputation::computeSolidAreas(mesh);
+
     guarded_progress.reset();
     cura::parallel_for<size_t>(
         0,
@@ -546,7 +569,7 @@ void FffPolygonGenerator::processBasicWallsSkinInfill(
             spdlog::debug("Processing skins and infill layer {} of {}", layer_number, mesh.layers.size());
             if (! magic_spiralize || layer_number < mesh_max_initial_bottom_layer_count) // Only generate up/downskin and infill for the first X layers when spiralize is choosen.
             {
-                processSkinsAndInfill(mesh, layer_number, process_infill);
+                processSkinsAndInfill(mesh, layer_number, process_infill, solid_areas);
             }
             guarded_progress++;
         });
@@ -729,10 +752,10 @@ void FffPolygonGenerator::processDerivedWallsSkinInfill(SliceMeshStorage& mesh)
  *
  * processInsets only reads and writes data for the current layer
  */
-void FffPolygonGenerator::processWalls(SliceMeshStorage& mesh, size_t layer_nr)
+void FffPolygonGenerator::processWalls(SliceMeshStorage& mesh, size_t layer_nr, WallToolPathsCache& walls_cache)
 {
     SliceLayer* layer = &mesh.layers[layer_nr];
-    WallsComputation walls_computation(mesh.settings, layer_nr);
+    WallsComputation walls_computation(mesh.settings, layer_nr, &walls_cache);
     walls_computation.generateWalls(layer, SectionType::WALL);
 }
 
@@ -830,14 +853,14 @@ void FffPolygonGenerator::removeEmptyFirstLayers(SliceDataStorage& storage, size
  * processSkinsAndInfill read (depend on) mesh.layers[*].parts[*].{insets,boundingBox}.
  *                       write mesh.layers[n].parts[*].{skin_parts,infill_area}.
  */
-void FffPolygonGenerator::processSkinsAndInfill(SliceMeshStorage& mesh, const LayerIndex layer_nr, bool process_infill)
+void FffPolygonGenerator::processSkinsAndInfill(SliceMeshStorage& mesh, const LayerIndex layer_nr, bool process_infill, const SkinSolidAreas& solid_areas)
 {
     if (mesh.settings.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE)
     {
         return;
     }
 
-    SkinInfillAreaComputation skin_infill_area_computation(layer_nr, mesh, process_infill);
+    SkinInfillAreaComputation skin_infill_area_computation(layer_nr, mesh, process_infill, &solid_areas);
     skin_infill_area_computation.generateSkinsAndInfill();
 
     if (((mesh.settings.get<bool>("ironing_enabled") && (! mesh.settings.get<bool>("ironing_only_highest_layer"))) || mesh.layer_nr_max_filled_layer == layer_nr)
@@ -18,6 +18,11 @@ void FffProcessor::setTargetStream(std::ostream* stream)
     return gcode_writer.setTargetStream(stream);
 }
 
+void FffProcessor::setTargetSink(GCodeSink* sink)
+{
+    gcode_writer.setTargetSink(sink);
+}
+
 double FffProcessor::getTotalFilamentUsed(int extruder_nr)
 {
     return gcode_writer.getTotalFilamentUsed(extruder_nr);
@@ -28,9 +33,9 @@ std::vector<Duration> FffProcessor::getTotalPrintTimePerFeature()
     return gcode_writer.getTotalPrintTimePerFeature();
 }
 
-void FffProcessor::finalize()
+bool FffProcessor::finalize()
 {
-    gcode_writer.finalize();
+    return gcode_writer.finalize();
 }
 
 } // namespace cura 
@@ -3,6 +3,8 @@
 
 #include "LayerPlanBuffer.h"
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
 #include "Application.h" //To flush g-code through the communication channel.
@@ -12,6 +14,7 @@
 #include "Slice.h"
 #include "communication/Communication.h" //To flush g-code through the communication channel.
 #include "gcodeExport.h"
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
@@ -31,8 +34,7 @@ void LayerPlanBuffer::handle(LayerPlan& layer_plan, GCodeExport& gcode)
     LayerPlan* to_be_written = processBuffer();
     if (to_be_written)
     {
-        to_be_written->writeGCode(gcode);
-        delete to_be_written;
+        writeLayer(to_be_written, gcode);
     }
 }
 
@@ -71,11 +73,116 @@ void LayerPlanBuffer::flush()
     }
     while (! buffer_.empty())
     {
-        buffer_.front()->writeGCode(gcode_);
+        writeLayer(buffer_.front(), gcode_);
         Application::getInstance().communication_->flushGCode();
-        delete buffer_.front();
         buffer_.pop_front();
     }
+
+    // Write out the recorded layers, helping with rendering those that no other thread took up yet.
+    std::unique_lock lock(recorded_layers_mutex_);
+    while (renderRecordedLayer(lock))
+    {
+    }
+    layer_rendered_.wait(
+        lock,
+        [this]()
+        {
+            return std::all_of(
+                recorded_layers_.begin(),
+                recorded_layers_.end(),
+                [](const std::unique_ptr<RecordedLayer>& layer)
+                {
+                    return layer->rendered;
+                });
+        });
+    writeRenderedLayers(gcode_, lock);
+}
+
+void LayerPlanBuffer::renderRecordedLayers()
+{
+    std::unique_lock lock(recorded_layers_mutex_);
+    while (renderRecordedLayer(lock))
+    {
+    }
+}
+
+void LayerPlanBuffer::writeLayer(LayerPlan* layer_plan, GCodeExport& gcode)
+{
+    const ThreadPool* thread_pool = Application::getInstance().thread_pool_;
+    if (thread_pool == nullptr || thread_pool->thread_count() == 0)
+    { // Nobody to render the g-code in parallel with.
+        layer_plan->writeGCode(gcode);
+        delete layer_plan;
+        return;
+    }
+
+    // Only the state of the exporter is sequential. Record the g-code, so that rendering its text doesn't have to be.
+    auto recorded_layer = std::make_unique<RecordedLayer>();
+    gcode.startRecording();
+    layer_plan->writeGCode(gcode);
+    recorded_layer->gcode = gcode.stopRecording();
+    delete layer_plan;
+
+    std::unique_lock lock(recorded_layers_mutex_);
+    recorded_layers_.push_back(std::move(recorded_layer));
+
+    // Don't let the recordings pile up when the other threads don't get around to rendering them.
+    const auto unclaimed_count = [this]()
+    {
+        return std::count_if(
+            recorded_layers_.begin(),
+            recorded_layers_.end(),
+            [](const std::unique_ptr<RecordedLayer>& layer)
+            {
+                return ! layer->rendering;
+            });
+    };
+    const auto max_unclaimed = static_cast<std::ptrdiff_t>(thread_pool->thread_count() + 1);
+    while (unclaimed_count() > max_unclaimed && renderRecordedLayer(lock))
+    {
+    }
+
+    writeRenderedLayers(gcode, lock);
+}
+
+bool LayerPlanBuffer::renderRecordedLayer(std::unique_lock<std::mutex>& lock)
+{
+    const auto layer_it = std::find_if(
+        recorded_layers_.begin(),
+        recorded_layers_.end(),
+        [](const std::unique_ptr<RecordedLayer>& layer)
+        {
+            return ! layer->rendering;
+        });
+    if (layer_it == recorded_layers_.end())
+    {
+        return false;
+    }
+    RecordedLayer& layer = **layer_it; // Only written out once rendered, so it stays alive while unlocked.
+    layer.rendering = true;
+
+    lock.unlock();
+    std::string text = GCodeBuffer::render(layer.gcode);
+    lock.lock();
+
+    layer.gcode = std::move(text);
+    layer.rendered = true;
+    layer_rendered_.notify_all();
+    return true;
+}
+
+void LayerPlanBuffer::writeRenderedLayers(GCodeExport& gcode, std::unique_lock<std::mutex>& lock)
+{
+    while (! recorded_layers_.empty() && recorded_layers_.front()->rendered)
+    {
+        const std::unique_ptr<RecordedLayer> layer = std::move(recorded_layers_.front());
+        recorded_layers_.pop_front();
+
+        lock.unlock();
+        gcode.writeRendered(layer->gcode);
+        Application::getInstance().communication_->flushGCode(); // Each layer is flushed separately, just like when writing it directly.
+        lock.lock();
+    }
 }
 
 void LayerPlanBuffer::addConnectingTravelMove(LayerPlan* prev_layer, const LayerPlan* newest_layer)
@@ -3,10 +3,18 @@
 
 #include "MeshGroup.h"
 
+#include <cstring>
 #include <limits>
 #include <stdio.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <fmt/format.h>
 #include <range/v3/view/enumerate.hpp>
 #include <scripta/logger.h>
@@ -15,6 +23,7 @@
 #include "settings/types/Ratio.h" //For the shrinkage percentage and scale factor.
 #include "utils/Matrix4x3D.h" //To transform the input meshes for shrinkage compensation and to align in command line mode.
 #include "utils/Point3F.h" //To accept incoming meshes with floating point vertices.
+#include "utils/ThreadPool.h"
 #include "utils/gettime.h"
 #include "utils/section_type.h"
 #include "utils/string.h"
@@ -169,30 +178,100 @@ bool loadMeshSTL_ascii(Mesh* mesh, const char* filename, const Matrix4x3D& matri
     return true;
 }
 
-bool loadMeshSTL_binary(Mesh* mesh, const char* filename, const Matrix4x3D& matrix)
+/*!
+ * Read-only view on the complete contents of a file.
+ *
+ * The file is memory mapped where the platform allows it, so that large files are paged in on demand by whichever thread touches them.
+ * Elsewhere it falls back to reading the file into a buffer.
+ */
+class MappedFile : public NoCopy
 {
-    FILE* f = fopen(filename, "rb");
+public:
+    explicit MappedFile(const char* filename)
+    {
+#ifndef _WIN32
+        const int fd = open(filename, O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                mapped_ = mapped;
+                data_ = static_cast<const char*>(mapped);
+                size_ = file_stat.st_size;
+            }
+        }
+        close(fd);
+        if (data_)
+        {
+            return;
+        }
+#endif
+        FILE* f = fopen(filename, "rb");
+        if (f == nullptr)
+        {
+            return;
+        }
+        fseek(f, 0L, SEEK_END);
+        const long long file_size = ftell(f);
+        rewind(f);
+        if (file_size > 0)
+        {
+            buffer_.resize(file_size);
+            if (fread(buffer_.data(), file_size, 1, f) == 1)
+            {
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+            }
+        }
+        fclose(f);
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (mapped_)
+        {
+            munmap(mapped_, size_);
+        }
+#endif
+    }
 
-    fseek(f, 0L, SEEK_END);
-    long long file_size = ftell(f); // The file size is the position of the cursor after seeking to the end.
-    rewind(f); // Seek back to start.
-    size_t face_count = (file_size - 80 - sizeof(uint32_t)) / 50; // Subtract the size of the header. Every face uses exactly 50 bytes.
+    const char* data() const
+    {
+        return data_;
+    }
 
-    char buffer[80];
-    // Skip the header
-    if (fread(buffer, 80, 1, f) != 1)
+    size_t size() const
     {
-        fclose(f);
-        return false;
+        return size_;
     }
 
-    uint32_t reported_face_count;
-    // Read the face count. We'll use it as a sort of redundancy code to check for file corruption.
-    if (fread(&reported_face_count, sizeof(uint32_t), 1, f) != 1)
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapped_ = nullptr; //!< Start of the memory mapping, if the file could be mapped.
+    std::vector<char> buffer_; //!< Contents of the file, if it could not be mapped.
+};
+
+bool loadMeshSTL_binary(Mesh* mesh, const char* filename, const Matrix4x3D& matrix)
+{
+    const MappedFile file(filename);
+    constexpr size_t header_size = 80 + sizeof(uint32_t); // Comment header, followed by the face count.
+    if (file.data() == nullptr || file.size() < header_size)
     {
-        fclose(f);
         return false;
     }
+    const size_t face_count = (file.size() - header_size) / 50; // Subtract the size of the header. Every face uses exactly 50 bytes.
+
+    uint32_t reported_face_count;
+    // Read the face count. We'll use it as a sort of redundancy code to check for file corruption.
+    std::memcpy(&reported_face_count, file.data() + 80, sizeof(uint32_t));
     if (reported_face_count != face_count)
     {
         spdlog::warn("Face count reported by file ({}) is not equal to actual face count ({}). File could be corrupt!", reported_face_count, face_count);
@@ -201,23 +280,22 @@ bool loadMeshSTL_binary(Mesh* mesh, const char* filename, const Matrix4x3D& matr
     // For each face read:
     // float(x,y,z) = normal, float(X,Y,Z)*3 = vertexes, uint16_t = flags
     //  Every Face is 50 Bytes: Normal(3*float), Vertices(9*float), 2 Bytes Spacer
-    mesh->faces_.reserve(face_count);
-    mesh->vertices_.reserve(face_count);
-    for (size_t i = 0; i < face_count; i++)
-    {
-        if (fread(buffer, 50, 1, f) != 1)
+    // Faces are independent, so they are decoded and transformed in parallel. Vertex welding happens afterwards, in Mesh::addFaces.
+    std::vector<Point3LL> corners(face_count * 3);
+    cura::parallel_for<size_t>(
+        0,
+        face_count,
+        [&](const size_t face_idx)
         {
-            fclose(f);
-            return false;
-        }
-        float* v = reinterpret_cast<float*>(buffer) + 3;
+            float v[9];
+            std::memcpy(v, file.data() + header_size + face_idx * 50 + 3 * sizeof(float), sizeof(v));
 
-        Point3LL v0 = matrix.apply(Point3F(v[0], v[1], v[2]).toPoint3d());
-        Point3LL v1 = matrix.apply(Point3F(v[3], v[4], v[5]).toPoint3d());
-        Point3LL v2 = matrix.apply(Point3F(v[6], v[7], v[8]).toPoint3d());
-        mesh->addFace(v0, v1, v2);
-    }
-    fclose(f);
+            corners[face_idx * 3] = matrix.apply(Point3F(v[0], v[1], v[2]).toPoint3d());
+            corners[face_idx * 3 + 1] = matrix.apply(Point3F(v[3], v[4], v[5]).toPoint3d());
+            corners[face_idx * 3 + 2] = matrix.apply(Point3F(v[6], v[7], v[8]).toPoint3d());
+        },
+        4096);
+    mesh->addFaces(corners);
     mesh->finish();
     return true;
 }
@@ -892,8 +892,7 @@ void SkeletalTrapezoidation::generateTransitioningRibs()
 {
     // Store the upward edges to the transitions.
     // We only store the halfedge for which the distance_to_boundary is higher at the end than at the beginning.
-    ptr_vector_t<std::list<TransitionMiddle>> edge_transitions;
-    generateTransitionMids(edge_transitions);
+    generateTransitionMids(edge_transitions_);
 
     for (edge_t& edge : graph_.edges)
     { // Check if there is a transition in between nodes with different bead counts
@@ -905,15 +904,13 @@ void SkeletalTrapezoidation::generateTransitioningRibs()
 
     filterTransitionMids();
 
-    ptr_vector_t<std::list<TransitionEnd>> edge_transition_ends; // We only map the half edge in the upward direction. mapped items are not sorted
-    generateAllTransitionEnds(edge_transition_ends);
+    generateAllTransitionEnds(edge_transition_ends_);
 
-    applyTransitions(edge_transition_ends);
-    // Note that the shared pointer lists will be out of scope and thus destroyed here, since the remaining refs are weak_ptr.
+    applyTransitions(edge_transition_ends_);
 }
 
 
-void SkeletalTrapezoidation::generateTransitionMids(ptr_vector_t<std::list<TransitionMiddle>>& edge_transitions)
+void SkeletalTrapezoidation::generateTransitionMids(arena_t<std::list<TransitionMiddle>>& edge_transitions)
 {
     for (edge_t& edge : graph_.edges)
     {
@@ -981,8 +978,7 @@ void SkeletalTrapezoidation::generateTransitionMids(ptr_vector_t<std::list<Trans
             assert((! edge.data_.hasTransitions(ignore_empty)) || mid_pos >= transitions->back().pos_);
             if (! edge.data_.hasTransitions(ignore_empty))
             {
-                edge_transitions.emplace_back(std::make_shared<std::list<TransitionMiddle>>());
-                edge.data_.setTransitions(edge_transitions.back()); // initialization
+                edge.data_.setTransitions(&edge_transitions.emplace_back()); // initialization
                 transitions = edge.data_.getTransitions();
             }
             transitions->emplace_back(mid_pos, transition_lower_bead_count, mid_R);
@@ -1188,7 +1184,7 @@ bool SkeletalTrapezoidation::filterEndOfCentralTransition(edge_t* edge_to_start,
     return should_dissolve;
 }
 
-void SkeletalTrapezoidation::generateAllTransitionEnds(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::generateAllTransitionEnds(arena_t<std::list<TransitionEnd>>& edge_transition_ends)
 {
     for (edge_t& edge : graph_.edges)
     {
@@ -1208,7 +1204,7 @@ void SkeletalTrapezoidation::generateAllTransitionEnds(ptr_vector_t<std::list<Tr
     }
 }
 
-void SkeletalTrapezoidation::generateTransitionEnds(edge_t& edge, coord_t mid_pos, coord_t lower_bead_count, ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::generateTransitionEnds(edge_t& edge, coord_t mid_pos, coord_t lower_bead_count, arena_t<std::list<TransitionEnd>>& edge_transition_ends)
 {
     const Point2LL a = edge.from_->p_;
     const Point2LL b = edge.to_->p_;
@@ -1253,7 +1249,7 @@ bool SkeletalTrapezoidation::generateTransitionEnd(
     Ratio start_rest,
     Ratio end_rest,
     coord_t lower_bead_count,
-    ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+    arena_t<std::list<TransitionEnd>>& edge_transition_ends)
 {
     Point2LL a = edge.from_->p_;
     Point2LL b = edge.to_->p_;
@@ -1339,8 +1335,7 @@ bool SkeletalTrapezoidation::generateTransitionEnd(
         if (! upward_edge->data_.hasTransitionEnds())
         {
             // This edge doesn't have a data structure yet for the transition ends. Make one.
-            edge_transition_ends.emplace_back(std::make_shared<std::list<TransitionEnd>>());
-            upward_edge->data_.setTransitionEnds(edge_transition_ends.back());
+            upward_edge->data_.setTransitionEnds(&edge_transition_ends.emplace_back());
         }
         auto transitions = upward_edge->data_.getTransitionEnds();
 
@@ -1413,7 +1408,7 @@ bool SkeletalTrapezoidation::isGoingDown(edge_t* outgoing, coord_t traveled_dist
     return has_recursed && is_only_going_down;
 }
 
-void SkeletalTrapezoidation::applyTransitions(ptr_vector_t<std::list<TransitionEnd>>& edge_transition_ends)
+void SkeletalTrapezoidation::applyTransitions(arena_t<std::list<TransitionEnd>>& edge_transition_ends)
 {
     for (edge_t& edge : graph_.edges)
     {
@@ -1423,8 +1418,7 @@ void SkeletalTrapezoidation::applyTransitions(ptr_vector_t<std::list<TransitionE
             auto& twin_transition_ends = *edge.twin_->data_.getTransitionEnds();
             if (! edge.data_.hasTransitionEnds())
             {
-                edge_transition_ends.emplace_back(std::make_shared<std::list<TransitionEnd>>());
-                edge.data_.setTransitionEnds(edge_transition_ends.back());
+                edge.data_.setTransitionEnds(&edge_transition_ends.emplace_back());
             }
             auto& transition_ends = *edge.data_.getTransitionEnds();
             for (TransitionEnd& end : twin_transition_ends)
@@ -1614,7 +1608,6 @@ void SkeletalTrapezoidation::generateSegments()
             return a->to_->data_.distance_to_boundary_ > b->to_->data_.distance_to_boundary_;
         });
 
-    ptr_vector_t<BeadingPropagation> node_beadings;
     { // Store beading
         for (node_t& node : graph_.nodes)
         {
@@ -1624,10 +1617,9 @@ void SkeletalTrapezoidation::generateSegments()
             }
             if (node.data_.transition_ratio_ == 0)
             {
-                node_beadings.emplace_back(new BeadingPropagation(beading_strategy_.compute(node.data_.distance_to_boundary_ * 2, node.data_.bead_count_)));
-                node.data_.setBeading(node_beadings.back());
-                assert(node_beadings.back()->beading_.total_thickness == node.data_.distance_to_boundary_ * 2);
-                if (node_beadings.back()->beading_.total_thickness != node.data_.distance_to_boundary_ * 2)
+                node.data_.setBeading(&node_beadings_.emplace_back(beading_strategy_.compute(node.data_.distance_to_boundary_ * 2, node.data_.bead_count_)));
+                assert(node_beadings_.back().beading_.total_thickness == node.data_.distance_to_boundary_ * 2);
+                if (node_beadings_.back().beading_.total_thickness != node.data_.distance_to_boundary_ * 2)
                 {
                     spdlog::warn("If transitioning to an endpoint (ratio 0), the node should be exactly in the middle.");
                 }
@@ -1637,8 +1629,7 @@ void SkeletalTrapezoidation::generateSegments()
                 Beading low_count_beading = beading_strategy_.compute(node.data_.distance_to_boundary_ * 2, node.data_.bead_count_);
                 Beading high_count_beading = beading_strategy_.compute(node.data_.distance_to_boundary_ * 2, node.data_.bead_count_ + 1);
                 Beading merged = interpolate(low_count_beading, 1.0 - node.data_.transition_ratio_, high_count_beading);
-                node_beadings.emplace_back(new BeadingPropagation(merged));
-                node.data_.setBeading(node_beadings.back());
+                node.data_.setBeading(&node_beadings_.emplace_back(merged));
                 assert(merged.total_thickness == node.data_.distance_to_boundary_ * 2);
                 if (merged.total_thickness != node.data_.distance_to_boundary_ * 2)
                 {
@@ -1648,14 +1639,13 @@ void SkeletalTrapezoidation::generateSegments()
         }
     }
 
-    propagateBeadingsUpward(upward_quad_mids, node_beadings);
+    propagateBeadingsUpward(upward_quad_mids, node_beadings_);
 
-    propagateBeadingsDownward(upward_quad_mids, node_beadings);
+    propagateBeadingsDownward(upward_quad_mids, node_beadings_);
 
-    ptr_vector_t<LineJunctions> edge_junctions; // junctions ordered high R to low R
-    generateJunctions(node_beadings, edge_junctions);
+    generateJunctions(node_beadings_, edge_junctions_);
 
-    connectJunctions(edge_junctions);
+    connectJunctions(edge_junctions_);
 
     generateLocalMaximaSingleBeads();
 }
@@ -1684,7 +1674,7 @@ SkeletalTrapezoidation::edge_t* SkeletalTrapezoidation::getQuadMaxRedgeTo(edge_t
     return ret;
 }
 
-void SkeletalTrapezoidation::propagateBeadingsUpward(std::vector<edge_t*>& upward_quad_mids, ptr_vector_t<BeadingPropagation>& node_beadings)
+void SkeletalTrapezoidation::propagateBeadingsUpward(std::vector<edge_t*>& upward_quad_mids, arena_t<BeadingPropagation>& node_beadings)
 {
     for (auto upward_quad_mids_it = upward_quad_mids.rbegin(); upward_quad_mids_it != upward_quad_mids.rend(); ++upward_quad_mids_it)
     {
@@ -1710,13 +1700,12 @@ void SkeletalTrapezoidation::propagateBeadingsUpward(std::vector<edge_t*>& upwar
         BeadingPropagation upper_beading = lower_beading;
         upper_beading.dist_to_bottom_source_ += length;
         upper_beading.is_upward_propagated_only_ = true;
-        node_beadings.emplace_back(new BeadingPropagation(upper_beading));
-        upward_edge->to_->data_.setBeading(node_beadings.back());
+        upward_edge->to_->data_.setBeading(&node_beadings.emplace_back(upper_beading));
         assert(upper_beading.beading_.total_thickness <= upward_edge->to_->data_.distance_to_boundary_ * 2);
     }
 }
 
-void SkeletalTrapezoidation::propagateBeadingsDownward(std::vector<edge_t*>& upward_quad_mids, ptr_vector_t<BeadingPropagation>& node_beadings)
+void SkeletalTrapezoidation::propagateBeadingsDownward(std::vector<edge_t*>& upward_quad_mids, arena_t<BeadingPropagation>& node_beadings)
 {
     for (edge_t* upward_quad_mid : upward_quad_mids)
     {
@@ -1737,7 +1726,7 @@ void SkeletalTrapezoidation::propagateBeadingsDownward(std::vector<edge_t*>& upw
     }
 }
 
-void SkeletalTrapezoidation::propagateBeadingsDownward(edge_t* edge_to_peak, ptr_vector_t<BeadingPropagation>& node_beadings)
+void SkeletalTrapezoidation::propagateBeadingsDownward(edge_t* edge_to_peak, arena_t<BeadingPropagation>& node_beadings)
 {
     coord_t length = vSize(edge_to_peak->to_->p_ - edge_to_peak->from_->p_);
     BeadingPropagation& top_beading = *getOrCreateBeading(edge_to_peak->to_, node_beadings);
@@ -1752,8 +1741,7 @@ void SkeletalTrapezoidation::propagateBeadingsDownward(edge_t* edge_to_peak, ptr
     { // Set new beading if there is no beading associated with the node yet
         BeadingPropagation propagated_beading = top_beading;
         propagated_beading.dist_from_top_source_ += length;
-        node_beadings.emplace_back(new BeadingPropagation(propagated_beading));
-        edge_to_peak->from_->data_.setBeading(node_beadings.back());
+        edge_to_peak->from_->data_.setBeading(&node_beadings.emplace_back(propagated_beading));
         assert(propagated_beading.beading_.total_thickness >= edge_to_peak->from_->data_.distance_to_boundary_ * 2);
         if (propagated_beading.beading_.total_thickness < edge_to_peak->from_->data_.distance_to_boundary_ * 2)
         {
@@ -1851,7 +1839,7 @@ SkeletalTrapezoidation::Beading SkeletalTrapezoidation::interpolate(const Beadin
     return ret;
 }
 
-void SkeletalTrapezoidation::generateJunctions(ptr_vector_t<BeadingPropagation>& node_beadings, ptr_vector_t<LineJunctions>& edge_junctions)
+void SkeletalTrapezoidation::generateJunctions(arena_t<BeadingPropagation>& node_beadings, arena_t<LineJunctions>& edge_junctions)
 {
     for (edge_t& edge_ : graph_.edges)
     {
@@ -1870,9 +1858,8 @@ void SkeletalTrapezoidation::generateJunctions(ptr_vector_t<BeadingPropagation>&
         }
 
         Beading* beading = &getOrCreateBeading(edge->to_, node_beadings)->beading_;
-        edge_junctions.emplace_back(std::make_shared<LineJunctions>());
-        edge_.data_.setExtrusionJunctions(edge_junctions.back()); // initialization
-        LineJunctions& ret = *edge_junctions.back();
+        LineJunctions& ret = edge_junctions.emplace_back();
+        edge_.data_.setExtrusionJunctions(&ret); // initialization
 
         assert(beading->total_thickness >= edge->to_->data_.distance_to_boundary_ * 2);
         if (beading->total_thickness < edge->to_->data_.distance_to_boundary_ * 2)
@@ -1922,7 +1909,7 @@ void SkeletalTrapezoidation::generateJunctions(ptr_vector_t<BeadingPropagation>&
     }
 }
 
-std::shared_ptr<SkeletalTrapezoidationJoint::BeadingPropagation> SkeletalTrapezoidation::getOrCreateBeading(node_t* node, ptr_vector_t<BeadingPropagation>& node_beadings)
+SkeletalTrapezoidationJoint::BeadingPropagation* SkeletalTrapezoidation::getOrCreateBeading(node_t* node, arena_t<BeadingPropagation>& node_beadings)
 {
     if (! node->data_.hasBeading())
     {
@@ -1957,14 +1944,13 @@ std::shared_ptr<SkeletalTrapezoidationJoint::BeadingPropagation> SkeletalTrapezo
             node->data_.bead_count_ = beading_strategy_.getOptimalBeadCount(dist * 2);
         }
         assert(node->data_.bead_count_ != -1);
-        node_beadings.emplace_back(new BeadingPropagation(beading_strategy_.compute(node->data_.distance_to_boundary_ * 2, node->data_.bead_count_)));
-        node->data_.setBeading(node_beadings.back());
+        node->data_.setBeading(&node_beadings.emplace_back(beading_strategy_.compute(node->data_.distance_to_boundary_ * 2, node->data_.bead_count_)));
     }
     assert(node->data_.hasBeading());
     return node->data_.getBeading();
 }
 
-std::shared_ptr<SkeletalTrapezoidationJoint::BeadingPropagation> SkeletalTrapezoidation::getNearestBeading(node_t* node, coord_t max_dist)
+SkeletalTrapezoidationJoint::BeadingPropagation* SkeletalTrapezoidation::getNearestBeading(node_t* node, coord_t max_dist)
 {
     struct DistEdge
     {
@@ -2057,7 +2043,7 @@ void SkeletalTrapezoidation::addToolpathSegment(const ExtrusionJunction& from, c
     }
 };
 
-void SkeletalTrapezoidation::connectJunctions(ptr_vector_t<LineJunctions>& edge_junctions)
+void SkeletalTrapezoidation::connectJunctions(arena_t<LineJunctions>& edge_junctions)
 {
     std::unordered_set<edge_t*> unprocessed_quad_starts(graph_.edges.size() * 5 / 2);
     for (edge_t& edge : graph_.edges)
@@ -2092,15 +2078,13 @@ void SkeletalTrapezoidation::connectJunctions(ptr_vector_t<LineJunctions>& edge_
 
             if (! edge_to_peak->data_.hasExtrusionJunctions())
             {
-                edge_junctions.emplace_back(std::make_shared<LineJunctions>());
-                edge_to_peak->data_.setExtrusionJunctions(edge_junctions.back());
+                edge_to_peak->data_.setExtrusionJunctions(&edge_junctions.emplace_back());
             }
             // The junctions on the edge(s) from the start of the quad to the node with highest R
             LineJunctions from_junctions = *edge_to_peak->data_.getExtrusionJunctions();
             if (! edge_from_peak->twin_->data_.hasExtrusionJunctions())
             {
-                edge_junctions.emplace_back(std::make_shared<LineJunctions>());
-                edge_from_peak->twin_->data_.setExtrusionJunctions(edge_junctions.back());
+                edge_from_peak->twin_->data_.setExtrusionJunctions(&edge_junctions.emplace_back());
             }
             // The junctions on the edge(s) from the end of the quad to the node with highest R
             LineJunctions to_junctions = *edge_from_peak->twin_->data_.getExtrusionJunctions();
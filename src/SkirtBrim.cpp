@@ -590,6 +590,8 @@ std::vector<Shape> SkirtBrim::generateAllowedAreas(const std::vector<Shape>& sta
         Shape& allowed_areas = allowed_areas_per_extruder[extruder_nr];
         allowed_areas = storage_.getMachineBorder(extruder_nr);
 
+        // Collect the areas to remove and remove them all at once, rather than clipping the allowed areas again for each of them.
+        std::vector<Shape> to_remove;
         if (adhesion_type_ == EPlatformAdhesion::BRIM)
         {
             const Settings& settings = Application::getInstance().current_slice_->scene.extruders[extruder_nr].settings_;
@@ -620,22 +622,25 @@ std::vector<Shape> SkirtBrim::generateAllowedAreas(const std::vector<Shape>& sta
 
                     if (covered_area < 0)
                     {
-                        // Invert offset to make holes grow inside
+                        // Invert offset to make holes grow inside. The areas removed so far must not be removed from the hole.
+                        allowed_areas = allowed_areas.differenceAll(to_remove);
+                        to_remove.clear();
                         allowed_areas.push_back(covered_surface.offset(-offset, ClipperLib::jtRound));
                     }
                     else
                     {
-                        allowed_areas = allowed_areas.difference(covered_surface.offset(offset, ClipperLib::jtRound));
+                        to_remove.push_back(covered_surface.offset(offset, ClipperLib::jtRound));
                     }
                 }
 
                 // Remove areas covered by support, with a low margin because we don't care if the brim touches it
-                allowed_areas = allowed_areas.difference(extruder_outlines.supports_outlines.offset(base_offset - 50));
+                to_remove.push_back(extruder_outlines.supports_outlines.offset(base_offset - 50));
             }
         }
 
         // Anyway, don't allow a brim/skirt to grow inside itself, which may happen e.g. with ooze shield+skirt
-        allowed_areas = allowed_areas.difference(starting_outlines[extruder_nr].offset(extruder_config.gap_ - 50, ClipperLib::jtRound));
+        to_remove.push_back(starting_outlines[extruder_nr].offset(extruder_config.gap_ - 50, ClipperLib::jtRound));
+        allowed_areas = allowed_areas.differenceAll(to_remove);
     }
 
     return allowed_areas_per_extruder;
@@ -8,6 +8,7 @@
 #include <sentry.h>
 #endif
 
+#include "BeadingStrategy/BeadingStrategyFactory.h"
 #include "ExtruderTrain.h"
 
 namespace cura
@@ -36,6 +37,7 @@ void Slice::compute()
         }
         scene.processMeshGroup(*mesh_group);
     }
+    BeadingStrategyFactory::clearSharedStrategies();
 }
 
 void Slice::reset()
@@ -3,11 +3,17 @@
 
 #include "TreeModelVolumes.h"
 
+#include <bit>
+#include <string_view>
+#include <type_traits>
+
 #include <range/v3/view/enumerate.hpp>
 #include <range/v3/view/iota.hpp>
 #include <range/v3/view/reverse.hpp>
 #include <spdlog/spdlog.h>
 
+#include "Application.h"
+#include "Slice.h"
 #include "TreeSupport.h"
 #include "TreeSupportEnums.h"
 #include "progress/Progress.h"
@@ -167,6 +173,23 @@ TreeModelVolumes::TreeModelVolumes(
     radius_0_ = config.getRadius(0);
     support_rest_preference_ = config.support_rest_preference;
     simplifier_ = Simplify(min_maximum_resolution, min_maximum_deviation, min_maximum_area_deviation);
+
+    // These settings are optional, as they are about the machine that slices rather than the print.
+    const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
+    if (mesh_group_settings.has("support_tree_cache_memory_limit"))
+    {
+        cache_memory_limit_ = mesh_group_settings.get<size_t>("support_tree_cache_memory_limit") * 1024 * 1024;
+    }
+    if (cache_memory_limit_ > 0)
+    {
+        const bool spill_to_file = mesh_group_settings.has("support_tree_cache_spill_to_file") && mesh_group_settings.get<bool>("support_tree_cache_spill_to_file");
+        spill_store_ = std::make_unique<AreaSpillStore>(spill_to_file);
+        forEachCache(
+            [this](auto& cache, const std::string_view)
+            {
+                cache.enableSpilling(spill_store_.get());
+            });
+    }
 }
 
 void TreeModelVolumes::precalculate(coord_t max_layer)
@@ -264,6 +287,7 @@ void TreeModelVolumes::precalculate(coord_t max_layer)
 
     // ### Calculate collisions without holes, build from regular collision
     calculateCollisionHolefree(relevant_hole_collision_radiis);
+    enforceMemoryLimit(max_layer);
 
     const auto t_coll = std::chrono::high_resolution_clock::now();
     auto t_acc = std::chrono::high_resolution_clock::now();
@@ -313,6 +337,18 @@ void TreeModelVolumes::precalculate(coord_t max_layer)
     }
 
     precalculation_finished_ = true;
+
+    // Everything that is known to be needed has been calculated, so from here on the caches are mostly read from.
+    size_t cache_bytes = 0;
+    forEachCache(
+        [&cache_bytes](auto& cache, const std::string_view name)
+        {
+            cache.freeze();
+            cache_bytes += cache.getMemoryUsage();
+            spdlog::debug("Tree support cache {} holds {} areas, taking {:.1f} MiB.", name, cache.size(), cache.getMemoryUsage() / (1024.0 * 1024.0));
+        });
+    spdlog::debug("Tree support caches take {:.1f} MiB in total.", cache_bytes / (1024.0 * 1024.0));
+    enforceMemoryLimit(max_layer);
     const auto dur_col = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_coll - t_start).count();
     const auto dur_acc = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_acc - t_coll).count();
     const auto dur_avo = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_avo - t_acc).count();
@@ -328,6 +364,91 @@ void TreeModelVolumes::precalculate(coord_t max_layer)
         dur_col_avo);
 }
 
+void TreeModelVolumes::enforceMemoryLimit(const LayerIndex active_layer)
+{
+    if (cache_memory_limit_ == 0)
+    {
+        return;
+    }
+    const auto get_memory_usage = [this]()
+    {
+        size_t bytes = 0;
+        forEachCache(
+            [&bytes](auto& cache, const std::string_view)
+            {
+                bytes += cache.getMemoryUsage();
+            });
+        return bytes;
+    };
+    const auto spill_layers = [this](const auto& should_spill_layer)
+    {
+        forEachCache(
+            [&should_spill_layer](auto& cache, const std::string_view)
+            {
+                cache.spill(
+                    [&should_spill_layer](const auto& key)
+                    {
+                        if constexpr (std::is_same_v<std::decay_t<decltype(key)>, LayerIndex>)
+                        {
+                            return should_spill_layer(key);
+                        }
+                        else
+                        {
+                            return should_spill_layer(key.second);
+                        }
+                    });
+            });
+    };
+
+    const size_t bytes_before = get_memory_usage();
+    if (bytes_before <= cache_memory_limit_)
+    {
+        return;
+    }
+
+    // The layers right next to the active layer are needed for the next layer, so those are kept.
+    static constexpr LayerIndex::value_type kept_layers = 2;
+    spill_layers(
+        [active_layer](const LayerIndex layer)
+        {
+            return layer > active_layer + kept_layers;
+        });
+    // Spill the layers below in steps, starting with those furthest away, so that the layers that will be needed soon stay in memory if possible.
+    for (auto distance = static_cast<LayerIndex::value_type>(std::bit_floor(static_cast<size_t>(std::max(active_layer.value, LayerIndex::value_type(1))))); distance >= kept_layers && get_memory_usage() > cache_memory_limit_; distance /= 2)
+    {
+        spill_layers(
+            [active_layer, distance](const LayerIndex layer)
+            {
+                return layer < active_layer - distance;
+            });
+    }
+
+    const size_t bytes_after = get_memory_usage();
+    spdlog::debug(
+        "Spilled {:.1f} MiB of tree support areas at layer {}. {:.1f} MiB remains in memory, {:.1f} MiB is spilled.",
+        (bytes_before - bytes_after) / (1024.0 * 1024.0),
+        active_layer,
+        bytes_after / (1024.0 * 1024.0),
+        spill_store_->getBytes() / (1024.0 * 1024.0));
+}
+
+void TreeModelVolumes::logCacheStatistics()
+{
+    forEachCache(
+        [](auto& cache, const std::string_view name)
+        {
+            spdlog::debug(
+                "Tree support cache {}: {} hits, {} misses, {} reloads. {} areas taking {:.1f} MiB, {} areas spilled.",
+                name,
+                cache.getHits(),
+                cache.getMisses(),
+                cache.getReloads(),
+                cache.size(),
+                cache.getMemoryUsage() / (1024.0 * 1024.0),
+                cache.getSpilledCount());
+        });
+}
+
 const Shape& TreeModelVolumes::getCollision(coord_t radius, LayerIndex layer_idx, bool min_xy_dist)
 {
     const coord_t orig_radius = radius;
@@ -345,10 +466,7 @@ const Shape& TreeModelVolumes::getCollision(coord_t radius, LayerIndex layer_idx
     }
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_avoidance_cache_);
-        result = getArea(collision_cache_, key);
-    }
+    result = getArea(collision_cache_, key);
     if (result)
     {
         return result.value().get();
@@ -375,10 +493,7 @@ const Shape& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerIndex l
     }
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_collision_cache_holefree_);
-        result = getArea(collision_cache_holefree_, key);
-    }
+    result = getArea(collision_cache_holefree_, key);
     if (result)
     {
         return result.value().get();
@@ -393,12 +508,10 @@ const Shape& TreeModelVolumes::getCollisionHolefree(coord_t radius, LayerIndex l
 
 const Shape& TreeModelVolumes::getAccumulatedPlaceable0(LayerIndex layer_idx)
 {
+    const std::optional<std::reference_wrapper<const Shape>> result = getArea(accumulated_placeables_cache_radius_0_, layer_idx);
+    if (result)
     {
-        std::lock_guard<std::mutex> critical_section_support_max_layer_nr(*critical_accumulated_placeables_cache_radius_0_);
-        if (accumulated_placeables_cache_radius_0_.count(layer_idx))
-        {
-            return accumulated_placeables_cache_radius_0_[layer_idx];
-        }
+        return result.value().get();
     }
     calculateAccumulatedPlaceable0(layer_idx);
     return getAccumulatedPlaceable0(layer_idx);
@@ -425,21 +538,17 @@ const Shape& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_idx
 
     const RadiusLayerPair key{ radius, layer_idx };
 
-    std::unordered_map<RadiusLayerPair, Shape>* cache_ptr = nullptr;
-    std::mutex* mutex_ptr = nullptr;
+    const ShardedAreaCache<RadiusLayerPair>* cache_ptr = nullptr;
     switch (type)
     {
     case AvoidanceType::FAST:
         cache_ptr = to_model ? &avoidance_cache_to_model_ : &avoidance_cache_;
-        mutex_ptr = to_model ? critical_avoidance_cache_to_model_.get() : critical_avoidance_cache_.get();
         break;
     case AvoidanceType::SLOW:
         cache_ptr = to_model ? &avoidance_cache_to_model_slow_ : &avoidance_cache_slow_;
-        mutex_ptr = to_model ? critical_avoidance_cache_to_model_slow_.get() : critical_avoidance_cache_slow_.get();
         break;
     case AvoidanceType::FAST_SAFE:
         cache_ptr = to_model ? &avoidance_cache_hole_to_model_ : &avoidance_cache_hole_;
-        mutex_ptr = to_model ? critical_avoidance_cache_holefree_to_model_.get() : critical_avoidance_cache_holefree_.get();
         break;
     case AvoidanceType::COLLISION:
         if (layer_idx <= max_layer_idx_without_blocker_)
@@ -449,7 +558,6 @@ const Shape& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_idx
         else
         {
             cache_ptr = &avoidance_cache_collision_;
-            mutex_ptr = critical_avoidance_cache_collision_.get();
         }
         break;
     default:
@@ -457,10 +565,7 @@ const Shape& TreeModelVolumes::getAvoidance(coord_t radius, LayerIndex layer_idx
         break;
     }
 
-    {
-        std::lock_guard<std::mutex> critical_section(*mutex_ptr);
-        result = getArea(*cache_ptr, key);
-    }
+    result = getArea(*cache_ptr, key);
     if (result)
     {
         return result.value().get();
@@ -496,10 +601,7 @@ const Shape& TreeModelVolumes::getPlaceableAreas(coord_t radius, LayerIndex laye
     radius = ceilRadius(radius);
     RadiusLayerPair key{ radius, layer_idx };
 
-    {
-        std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-        result = getArea(placeable_areas_cache_, key);
-    }
+    result = getArea(placeable_areas_cache_, key);
     if (result)
     {
         return result.value().get();
@@ -535,11 +637,7 @@ const Shape& TreeModelVolumes::getWallRestriction(coord_t radius, LayerIndex lay
     radius = ceilRadius(radius);
     const RadiusLayerPair key{ radius, layer_idx };
 
-    std::unordered_map<RadiusLayerPair, Shape>* cache_ptr = min_xy_dist ? &wall_restrictions_cache_min_ : &wall_restrictions_cache_;
-    {
-        std::lock_guard<std::mutex> critical_section(min_xy_dist ? *critical_wall_restrictions_cache_min_ : *critical_wall_restrictions_cache_);
-        result = getArea(*cache_ptr, key);
-    }
+    result = getArea(min_xy_dist ? wall_restrictions_cache_min_ : wall_restrictions_cache_, key);
     if (result)
     {
         return result.value().get();
@@ -592,7 +690,7 @@ Shape TreeModelVolumes::extractOutlineFromMesh(const SliceMeshStorage& mesh, Lay
     return Simplify(maximum_resolution, maximum_deviation, maximum_area_deviation).polygon(total);
 }
 
-LayerIndex TreeModelVolumes::getMaxCalculatedLayer(coord_t radius, const std::unordered_map<RadiusLayerPair, Shape>& map) const
+LayerIndex TreeModelVolumes::getMaxCalculatedLayer(coord_t radius, const ShardedAreaCache<RadiusLayerPair>& map) const
 {
     LayerIndex max_layer = -1;
 
@@ -603,7 +701,7 @@ LayerIndex TreeModelVolumes::getMaxCalculatedLayer(coord_t radius, const std::un
         max_layer = 1;
     }
 
-    while (map.count(RadiusLayerPair(radius, max_layer + 1)))
+    while (map.contains(RadiusLayerPair(radius, max_layer + 1)))
     {
         max_layer++;
     }
@@ -640,10 +738,7 @@ void TreeModelVolumes::calculateCollision(const std::deque<RadiusLayerPair>& key
                 //   and later for each avoidance... But avoidance calculation has to be for the whole scene and can NOT be done for each outline_idx separately and combined later.
                 // So avoiding this inaccuracy seems infeasible as it would require 2x the avoidance calculations => 0.5x the performance.
                 coord_t min_layer_bottom;
-                {
-                    std::lock_guard<std::mutex> critical_section(*critical_collision_cache_);
-                    min_layer_bottom = getMaxCalculatedLayer(radius, collision_cache_) - z_distance_bottom_layers;
-                }
+                min_layer_bottom = getMaxCalculatedLayer(radius, collision_cache_) - z_distance_bottom_layers;
 
                 if (min_layer_bottom < 0)
                 {
@@ -754,16 +849,10 @@ void TreeModelVolumes::calculateCollision(const std::deque<RadiusLayerPair>& key
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_collision_cache_);
-                collision_cache_.insert(data_outer.begin(), data_outer.end());
-            }
+            collision_cache_.insert(data_outer.begin(), data_outer.end());
             if (radius == 0)
             {
-                {
-                    std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                    placeable_areas_cache_.insert(data_placeable_outer.begin(), data_placeable_outer.end());
-                }
+                placeable_areas_cache_.insert(data_placeable_outer.begin(), data_placeable_outer.end());
             }
         });
 }
@@ -793,10 +882,7 @@ void TreeModelVolumes::calculateCollisionHolefree(const std::deque<RadiusLayerPa
                 data[RadiusLayerPair(radius, layer_idx)] = col;
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_collision_cache_holefree_);
-                collision_cache_holefree_.insert(data.begin(), data.end());
-            }
+            collision_cache_holefree_.insert(data.begin(), data.end());
         });
 }
 
@@ -805,14 +891,11 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
     LayerIndex start_layer = -1;
 
     // the placeable on model areas do not exist on layer 0, as there can not be model below it. As such it may be possible that layer 1 is available, but layer 0 does not exist.
+    while (accumulated_placeables_cache_radius_0_.contains(start_layer + 1))
     {
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
-        while (accumulated_placeables_cache_radius_0_.count(start_layer + 1))
-        {
-            start_layer++;
-        }
-        start_layer = std::max(LayerIndex{ start_layer + 1 }, LayerIndex{ 1 });
+        start_layer++;
     }
+    start_layer = std::max(LayerIndex{ start_layer + 1 }, LayerIndex{ 1 });
     if (start_layer > max_layer)
     {
         spdlog::debug("Requested calculation for value already calculated ?");
@@ -828,7 +911,6 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
     for (LayerIndex layer = start_layer; layer <= max_layer; layer++)
     {
         accumulated_placeable_0 = accumulated_placeable_0.unionPolygons(getPlaceableAreas(0, layer).offset(FUDGE_LENGTH)).difference(anti_overhang_[layer]);
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
         accumulated_placeable_0 = simplifier_.polygon(accumulated_placeable_0);
         data[layer] = std::pair(layer, accumulated_placeable_0);
     }
@@ -839,10 +921,7 @@ void TreeModelVolumes::calculateAccumulatedPlaceable0(const LayerIndex max_layer
         {
             data[layer_idx].second = data[layer_idx].second.offset(-(current_min_xy_dist_ + current_min_xy_dist_delta_));
         });
-    {
-        std::lock_guard<std::mutex> critical_section(*critical_accumulated_placeables_cache_radius_0_);
-        accumulated_placeables_cache_radius_0_.insert(data.begin(), data.end());
-    }
+    accumulated_placeables_cache_radius_0_.insert(data.begin(), data.end());
 }
 
 
@@ -857,10 +936,7 @@ void TreeModelVolumes::calculateCollisionAvoidance(const std::deque<RadiusLayerP
             const LayerIndex max_required_layer = keys[key_idx].second;
             const coord_t max_step_move = std::max(1.9 * radius, current_min_xy_dist_ * 1.9);
             LayerIndex start_layer = 0;
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_avoidance_cache_collision_);
-                start_layer = 1 + std::max(getMaxCalculatedLayer(radius, avoidance_cache_collision_), max_layer_idx_without_blocker_);
-            }
+            start_layer = 1 + std::max(getMaxCalculatedLayer(radius, avoidance_cache_collision_), max_layer_idx_without_blocker_);
 
             if (start_layer > max_required_layer)
             {
@@ -889,10 +965,7 @@ void TreeModelVolumes::calculateCollisionAvoidance(const std::deque<RadiusLayerP
                 data[layer] = std::pair<RadiusLayerPair, Shape>(key, latest_avoidance);
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_avoidance_cache_collision_);
-                avoidance_cache_collision_.insert(data.begin(), data.end());
-            }
+            avoidance_cache_collision_.insert(data.begin(), data.end());
         });
 }
 
@@ -946,10 +1019,7 @@ void TreeModelVolumes::calculateAvoidance(const std::deque<RadiusLayerPair>& key
             RadiusLayerPair key(radius, 0);
             Shape latest_avoidance;
             LayerIndex start_layer;
-            {
-                std::lock_guard<std::mutex> critical_section(*(slow ? critical_avoidance_cache_slow_ : holefree ? critical_avoidance_cache_holefree_ : critical_avoidance_cache_));
-                start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_);
-            }
+            start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_);
             if (start_layer > max_required_layer)
             {
                 spdlog::debug("Requested calculation for value already calculated ?");
@@ -995,10 +1065,7 @@ void TreeModelVolumes::calculateAvoidance(const std::deque<RadiusLayerPair>& key
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*(slow ? critical_avoidance_cache_slow_ : holefree ? critical_avoidance_cache_holefree_ : critical_avoidance_cache_));
-                (slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_).insert(data.begin(), data.end());
-            }
+            (slow ? avoidance_cache_slow_ : holefree ? avoidance_cache_hole_ : avoidance_cache_).insert(data.begin(), data.end());
         });
 }
 
@@ -1017,10 +1084,7 @@ void TreeModelVolumes::calculatePlaceables(const std::deque<RadiusLayerPair>& ke
             RadiusLayerPair key(radius, 0);
 
             LayerIndex start_layer;
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                start_layer = 1 + getMaxCalculatedLayer(radius, placeable_areas_cache_);
-            }
+            start_layer = 1 + getMaxCalculatedLayer(radius, placeable_areas_cache_);
             if (start_layer > max_required_layer)
             {
                 spdlog::debug("Requested calculation for value already calculated ?");
@@ -1052,10 +1116,7 @@ void TreeModelVolumes::calculatePlaceables(const std::deque<RadiusLayerPair>& ke
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_placeable_areas_cache_);
-                placeable_areas_cache_.insert(data.begin(), data.end());
-            }
+            placeable_areas_cache_.insert(data.begin(), data.end());
         });
 }
 
@@ -1092,13 +1153,7 @@ void TreeModelVolumes::calculateAvoidanceToModel(const std::deque<RadiusLayerPai
 
             LayerIndex start_layer;
 
-            {
-                std::lock_guard<std::mutex> critical_section(
-                    *(slow       ? critical_avoidance_cache_to_model_slow_
-                      : holefree ? critical_avoidance_cache_holefree_to_model_
-                                 : critical_avoidance_cache_to_model_));
-                start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_);
-            }
+            start_layer = 1 + getMaxCalculatedLayer(radius, slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_);
             start_layer = std::max(start_layer, LayerIndex(1));
             if (start_layer > max_required_layer)
             {
@@ -1144,13 +1199,7 @@ void TreeModelVolumes::calculateAvoidanceToModel(const std::deque<RadiusLayerPai
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(
-                    *(slow       ? critical_avoidance_cache_to_model_slow_
-                      : holefree ? critical_avoidance_cache_holefree_to_model_
-                                 : critical_avoidance_cache_to_model_));
-                (slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_).insert(data.begin(), data.end());
-            }
+            (slow ? avoidance_cache_to_model_slow_ : holefree ? avoidance_cache_hole_to_model_ : avoidance_cache_to_model_).insert(data.begin(), data.end());
         });
 }
 
@@ -1205,10 +1254,7 @@ void TreeModelVolumes::calculateWallRestrictions(const std::deque<RadiusLayerPai
             std::unordered_map<RadiusLayerPair, Shape> data;
             std::unordered_map<RadiusLayerPair, Shape> data_min;
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_);
-                min_layer_bottom = getMaxCalculatedLayer(radius, wall_restrictions_cache_);
-            }
+            min_layer_bottom = getMaxCalculatedLayer(radius, wall_restrictions_cache_);
 
             if (min_layer_bottom < 1)
             {
@@ -1228,15 +1274,9 @@ void TreeModelVolumes::calculateWallRestrictions(const std::deque<RadiusLayerPai
                 }
             }
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_);
-                wall_restrictions_cache_.insert(data.begin(), data.end());
-            }
+            wall_restrictions_cache_.insert(data.begin(), data.end());
 
-            {
-                std::lock_guard<std::mutex> critical_section(*critical_wall_restrictions_cache_min_);
-                wall_restrictions_cache_min_.insert(data_min.begin(), data_min.end());
-            }
+            wall_restrictions_cache_min_.insert(data_min.begin(), data_min.end());
         });
 }
 
@@ -1271,17 +1311,9 @@ coord_t TreeModelVolumes::ceilRadius(coord_t radius) const
 }
 
 template<typename KEY>
-const std::optional<std::reference_wrapper<const Shape>> TreeModelVolumes::getArea(const std::unordered_map<KEY, Shape>& cache, const KEY key) const
+const std::optional<std::reference_wrapper<const Shape>> TreeModelVolumes::getArea(const ShardedAreaCache<KEY>& cache, const KEY key) const
 {
-    const auto it = cache.find(key);
-    if (it != cache.end())
-    {
-        return std::optional<std::reference_wrapper<const Shape>>{ it->second };
-    }
-    else
-    {
-        return std::optional<std::reference_wrapper<const Shape>>();
-    }
+    return cache.find(key);
 }
 
 Shape TreeModelVolumes::calculateMachineBorderCollision(const Shape&& machine_border)
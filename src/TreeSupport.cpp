@@ -198,6 +198,7 @@ void TreeSupport::generateSupportAreas(SliceDataStorage& storage)
             dur_path,
             dur_place,
             dur_draw);
+        volumes_.logCacheStatistics();
 
 
         for (auto& layer : move_bounds)
@@ -1372,6 +1373,9 @@ void TreeSupport::createLayerPathing(std::vector<std::set<TreeSupportElement*>>&
 
         progress_total += data_size_inverse * TREE_PROGRESS_AREA_CALC;
         Progress::messageProgress(Progress::Stage::SUPPORT, progress_total * progress_multiplier + progress_offset, TREE_PROGRESS_TOTAL);
+
+        // Nothing refers to the cached volumes in between layers, so this is the moment to free up memory if needed.
+        volumes_.enforceMemoryLimit(layer_idx - 1);
     }
 
     spdlog::info("Time spent with creating influence areas' subtasks: Increasing areas {} ms merging areas: {} ms", dur_inc.count() / 1000000, dur_merge.count() / 1000000);
@@ -1756,12 +1760,12 @@ void TreeSupport::generateBranchAreas(
                     // if larger area did not fix the problem, all parts off the nozzle path that do not contain the center point are removed, hoping for the best
                     if (nozzle_path.splitIntoParts(false).size() > 1)
                     {
-                        Shape polygons_with_correct_center;
-                        for (SingleShape part : nozzle_path.splitIntoParts(false))
+                        std::vector<SingleShape> parts_with_correct_center;
+                        for (SingleShape& part : nozzle_path.splitIntoParts(false))
                         {
                             if (part.inside(elem->result_on_layer_, true))
                             {
-                                polygons_with_correct_center = polygons_with_correct_center.unionPolygons(part);
+                                parts_with_correct_center.push_back(std::move(part));
                             }
                             else
                             {
@@ -1770,10 +1774,11 @@ void TreeSupport::generateBranchAreas(
                                 PolygonUtils::moveInside(part, from, 0);
                                 if (vSize2(elem->result_on_layer_ - from) < (FUDGE_LENGTH * FUDGE_LENGTH) / 4)
                                 {
-                                    polygons_with_correct_center = polygons_with_correct_center.unionPolygons(part);
+                                    parts_with_correct_center.push_back(std::move(part));
                                 }
                             }
                         }
+                        const Shape polygons_with_correct_center = Shape::unionAll(parts_with_correct_center);
                         // Increase the area again, to ensure the nozzle path when calculated later is very similar to the one assumed above.
                         linear_inserts[idx] = polygons_with_correct_center.offset(config.support_line_width / 2).unionPolygons();
                         linear_inserts[idx]
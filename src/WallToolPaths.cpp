@@ -132,7 +132,7 @@ const std::vector<VariableWidthLines>& WallToolPaths::generate()
 
     const int wall_distribution_count = settings_.get<int>("wall_distribution_count");
     const size_t max_bead_count = (inset_count_ < std::numeric_limits<coord_t>::max() / 2) ? 2 * inset_count_ : std::numeric_limits<coord_t>::max();
-    const auto beading_strat = BeadingStrategyFactory::makeStrategy(
+    const auto beading_strat = BeadingStrategyFactory::makeSharedStrategy(
         bead_width_0_,
         bead_width_x_,
         wall_transition_length,
@@ -0,0 +1,127 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "WallToolPathsCache.h"
+
+#include <algorithm>
+
+#include "WallToolPaths.h"
+#include "geometry/Polygon.h"
+#include "utils/AABB.h"
+
+namespace cura
+{
+
+namespace
+{
+
+size_t hashCombine(const size_t seed, const size_t value)
+{
+    return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+}
+
+bool samePolygons(const Shape& a, const Shape& b)
+{
+    return a.size() == b.size()
+        && std::equal(
+               a.begin(),
+               a.end(),
+               b.begin(),
+               [](const Polygon& polygon_a, const Polygon& polygon_b)
+               {
+                   return polygon_a.getPoints() == polygon_b.getPoints();
+               });
+}
+
+WallToolPathsCache::Walls translated(const WallToolPathsCache::Walls& walls, const Point2LL& offset)
+{
+    WallToolPathsCache::Walls result = walls;
+    for (VariableWidthLines& inset : result.toolpaths)
+    {
+        for (ExtrusionLine& line : inset)
+        {
+            for (ExtrusionJunction& junction : line.junctions_)
+            {
+                junction.p_ += offset;
+            }
+        }
+    }
+    result.inner_contour.translate(offset);
+    return result;
+}
+
+} // namespace
+
+WallToolPathsCache::WallToolPathsCache(const Settings& settings, const size_t capacity)
+    : settings_(settings)
+    , entries_(capacity)
+{
+}
+
+WallToolPathsCache::Walls WallToolPathsCache::getWalls(
+    const Shape& outline,
+    const coord_t bead_width_0,
+    const coord_t bead_width_x,
+    const size_t inset_count,
+    const coord_t wall_0_inset,
+    const int layer_idx,
+    const SectionType section_type)
+{
+    const Point2LL origin = outline.empty() ? Point2LL(0, 0) : AABB(outline).min_;
+    Shape normalised_outline = outline;
+    normalised_outline.translate(-origin);
+
+    size_t hash = 0;
+    for (const Polygon& polygon : normalised_outline)
+    {
+        hash = hashCombine(hash, polygon.size());
+        for (const Point2LL& point : polygon)
+        {
+            hash = hashCombine(hash, std::hash<Point2LL>{}(point));
+        }
+    }
+    hash = hashCombine(hash, static_cast<size_t>(bead_width_0));
+    hash = hashCombine(hash, static_cast<size_t>(bead_width_x));
+    hash = hashCombine(hash, inset_count);
+    hash = hashCombine(hash, static_cast<size_t>(wall_0_inset));
+    hash = hashCombine(hash, static_cast<size_t>(section_type));
+
+    std::shared_ptr<const Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const std::shared_ptr<const Entry>* found = entries_.find(hash))
+        {
+            entry = *found;
+        }
+    }
+    if (entry && entry->bead_width_0 == bead_width_0 && entry->bead_width_x == bead_width_x && entry->inset_count == inset_count
+        && entry->wall_0_inset == wall_0_inset && entry->section_type == section_type && samePolygons(entry->outline, normalised_outline))
+    {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return translated(entry->walls, origin);
+    }
+
+    // Generate outside of the lock, so that other layers can be processed meanwhile.
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    WallToolPaths wall_tool_paths(normalised_outline, bead_width_0, bead_width_x, inset_count, wall_0_inset, settings_, layer_idx, section_type);
+    Walls walls{ wall_tool_paths.getToolPaths(), wall_tool_paths.getInnerContour() };
+    Walls result = translated(walls, origin);
+    auto new_entry = std::make_shared<const Entry>(Entry{ std::move(normalised_outline), bead_width_0, bead_width_x, inset_count, wall_0_inset, section_type, std::move(walls) });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.insert(hash, std::move(new_entry));
+    }
+    return result;
+}
+
+size_t WallToolPathsCache::getHits() const
+{
+    return hits_.load(std::memory_order_relaxed);
+}
+
+size_t WallToolPathsCache::getMisses() const
+{
+    return misses_.load(std::memory_order_relaxed);
+}
+
+} // namespace cura
@@ -16,16 +16,19 @@
 #include "ExtruderTrain.h"
 #include "Slice.h"
 #include "WallToolPaths.h"
+#include "WallToolPathsCache.h"
 #include "settings/types/Ratio.h"
 #include "sliceDataStorage.h"
 #include "utils/Simplify.h" // We're simplifying the spiralized insets.
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
 
-WallsComputation::WallsComputation(const Settings& settings, const LayerIndex layer_nr)
+WallsComputation::WallsComputation(const Settings& settings, const LayerIndex layer_nr, WallToolPathsCache* walls_cache)
     : settings_(settings)
     , layer_nr_(layer_nr)
+    , walls_cache_(walls_cache)
 {
 }
 
@@ -73,16 +76,12 @@ void WallsComputation::generateWalls(SliceLayerPart* part, SectionType section_t
         generateSpiralInsets(part, line_width_0, wall_0_inset, recompute_outline_based_on_outer_wall);
         if (layer_nr_ <= static_cast<LayerIndex>(settings_.get<size_t>("initial_bottom_layers")))
         {
-            WallToolPaths wall_tool_paths(part->outline, line_width_0, line_width_x, wall_count, wall_0_inset, settings_, layer_nr_, section_type);
-            part->wall_toolpaths = wall_tool_paths.getToolPaths();
-            part->inner_area = wall_tool_paths.getInnerContour();
+            generateWallToolPaths(part, line_width_0, line_width_x, wall_count, wall_0_inset, section_type);
         }
     }
     else
     {
-        WallToolPaths wall_tool_paths(part->outline, line_width_0, line_width_x, wall_count, wall_0_inset, settings_, layer_nr_, section_type);
-        part->wall_toolpaths = wall_tool_paths.getToolPaths();
-        part->inner_area = wall_tool_paths.getInnerContour();
+        generateWallToolPaths(part, line_width_0, line_width_x, wall_count, wall_0_inset, section_type);
     }
 
     part->outline = SingleShape{ Simplify(settings_).polygon(part->outline) };
@@ -97,10 +96,14 @@ void WallsComputation::generateWalls(SliceLayerPart* part, SectionType section_t
  */
 void WallsComputation::generateWalls(SliceLayer* layer, SectionType section)
 {
-    for (SliceLayerPart& part : layer->parts)
-    {
-        generateWalls(&part, section);
-    }
+    // Called from within the parallel loop over the layers. The parts are independent, so a layer with many parts is split up as well.
+    cura::parallel_for<size_t>(
+        0,
+        layer->parts.size(),
+        [&](const size_t part_idx)
+        {
+            generateWalls(&layer->parts[part_idx], section);
+        });
 
     // Remove the parts which did not generate a wall. As these parts are too small to print,
     //  and later code can now assume that there is always minimal 1 wall line.
@@ -121,6 +124,26 @@ void WallsComputation::generateWalls(SliceLayer* layer, SectionType section)
     }
 }
 
+void WallsComputation::generateWallToolPaths(
+    SliceLayerPart* part,
+    const coord_t line_width_0,
+    const coord_t line_width_x,
+    const size_t wall_count,
+    const coord_t wall_0_inset,
+    const SectionType section_type)
+{
+    if (walls_cache_ != nullptr)
+    {
+        WallToolPathsCache::Walls walls = walls_cache_->getWalls(part->outline, line_width_0, line_width_x, wall_count, wall_0_inset, layer_nr_, section_type);
+        part->wall_toolpaths = std::move(walls.toolpaths);
+        part->inner_area = std::move(walls.inner_contour);
+        return;
+    }
+    WallToolPaths wall_tool_paths(part->outline, line_width_0, line_width_x, wall_count, wall_0_inset, settings_, layer_nr_, section_type);
+    part->wall_toolpaths = wall_tool_paths.getToolPaths();
+    part->inner_area = wall_tool_paths.getInnerContour();
+}
+
 void WallsComputation::generateSpiralInsets(SliceLayerPart* part, coord_t line_width_0, coord_t wall_0_inset, bool recompute_outline_based_on_outer_wall)
 {
     part->spiral_wall = part->outline.offset(-line_width_0 / 2 - wall_0_inset);
@@ -350,13 +350,13 @@ void ArcusCommunication::setSocketMock(Arcus::Socket* socket)
 
 void ArcusCommunication::beginGCode()
 {
-    FffProcessor::getInstance()->setTargetStream(&private_data->gcode_output_stream);
+    FffProcessor::getInstance()->setTargetSink(&private_data->gcode_output);
 }
 
 void ArcusCommunication::flushGCode()
 {
-    std::string gcode_output_stream = private_data->gcode_output_stream.str();
-    auto message_str = slots::instance().modify<plugins::v0::SlotID::POSTPROCESS_MODIFY>(gcode_output_stream);
+    std::string gcode_output(private_data->gcode_output.view());
+    auto message_str = slots::instance().modify<plugins::v0::SlotID::POSTPROCESS_MODIFY>(gcode_output);
     if (message_str.size() == 0)
     {
         return;
@@ -367,7 +367,7 @@ void ArcusCommunication::flushGCode()
     // Send the g-code to the front-end! Yay!
     private_data->socket->sendMessage(message);
 
-    private_data->gcode_output_stream.str("");
+    private_data->gcode_output.clear();
 }
 
 bool ArcusCommunication::isSequential() const
@@ -575,6 +575,7 @@ void ArcusCommunication::sliceNext()
         ExtruderTrain& extruder = slice.scene.extruders[setting_extruder.extruder()];
         slice.scene.limit_to_extruder.emplace(setting_extruder.name(), &extruder);
     }
+    Settings::invalidateCachedValues(); // Settings resolved before the limits were known may have come from the wrong extruder.
 
     // Load all mesh groups, meshes and their settings.
     private_data->object_count = 0;
@@ -477,6 +477,7 @@ void CommandLine::sliceNext()
                             slice.scene.limit_to_extruder[key] = &slice.scene.extruders[extruder_nr];
                         }
                     }
+                    Settings::invalidateCachedValues(); // Settings resolved while loading the models didn't take these limits into account.
 
                     break;
                 }
@@ -523,7 +524,11 @@ void CommandLine::sliceNext()
 #endif // DEBUG
 
     // Finalize the processor. This adds the end g-code and reports statistics.
-    FffProcessor::getInstance()->finalize();
+    if (! FffProcessor::getInstance()->finalize())
+    {
+        spdlog::error("The g-code output is incomplete.");
+        exit(1);
+    }
 }
 
 int CommandLine::loadJSON(const std::filesystem::path& json_filename, Settings& settings, bool force_read_parent, bool force_read_nondefault)
@@ -31,12 +31,87 @@
 #include "geometry/Polygon.h"
 #include "geometry/SingleShape.h"
 #include "settings/types/Ratio.h"
+#include "utils/AABB.h"
 #include "utils/OpenPolylineStitcher.h"
 #include "utils/linearAlg2D.h"
 
 namespace cura
 {
 
+namespace
+{
+
+/*!
+ * The bounding boxes of the polygons of a shape, and of the shape as a whole.
+ *
+ * These are cheap to compute compared to a boolean operation, and allow skipping Clipper when the result of one is trivial.
+ */
+struct ShapeBounds
+{
+    std::vector<AABB> polygon_boxes;
+    AABB box;
+
+    explicit ShapeBounds(const Shape& shape)
+    {
+        polygon_boxes.reserve(shape.size());
+        for (const Polygon& polygon : shape)
+        {
+            polygon_boxes.emplace_back(polygon);
+            box.include(polygon_boxes.back());
+        }
+    }
+};
+
+/*!
+ * Add the polygons of a shape to a clipper, except those that don't overlap with \p region.
+ *
+ * A polygon only changes which area is covered within its own bounding box, whatever the fill rule. So leaving out a polygon that lies
+ * outside of \p region doesn't change the result of a boolean operation within \p region.
+ */
+void addPathsOverlapping(ClipperLib::Clipper& clipper, const Shape& shape, const ShapeBounds& bounds, const AABB& region, const ClipperLib::PolyType poly_type)
+{
+    for (size_t polygon_idx = 0; polygon_idx < shape.size(); ++polygon_idx)
+    {
+        if (bounds.polygon_boxes[polygon_idx].hit(region))
+        {
+            clipper.AddPath(shape[polygon_idx].getPoints(), poly_type, true);
+        }
+    }
+}
+
+/*!
+ * Whether a shape is a single axis-aligned rectangle, which covers exactly its bounding box.
+ */
+bool isRectangle(const Shape& shape, const ShapeBounds& bounds)
+{
+    if (shape.size() != 1 || bounds.box.area() <= 0)
+    {
+        return false;
+    }
+    const Polygon& polygon = shape.front();
+    size_t corner_count = 0;
+    Point2LL previous = polygon.back();
+    for (const Point2LL& point : polygon)
+    {
+        if (point == previous)
+        {
+            continue; // Explicitly closed, or a duplicate vertex.
+        }
+        const bool is_corner = (point.X == bounds.box.min_.X || point.X == bounds.box.max_.X) && (point.Y == bounds.box.min_.Y || point.Y == bounds.box.max_.Y);
+        const bool axis_aligned = point.X == previous.X || point.Y == previous.Y;
+        if (! is_corner || ! axis_aligned)
+        {
+            return false;
+        }
+        previous = point;
+        ++corner_count;
+    }
+    // Going around more than once would cover the rectangle more than once, which doesn't count as covered with the even-odd fill rule.
+    return corner_count == 4;
+}
+
+} // namespace
+
 Shape::Shape(ClipperLib::Paths&& paths, bool explicitely_closed)
 {
     emplace_back(std::move(paths), explicitely_closed);
@@ -144,10 +219,16 @@ Shape Shape::difference(const Shape& other) const
     {
         return *this;
     }
+    const AABB box(*this);
+    const ShapeBounds other_bounds(other);
+    if (isRectangle(other, other_bounds) && other_bounds.box.contains(box))
+    {
+        return {};
+    }
     ClipperLib::Paths ret;
     ClipperLib::Clipper clipper(clipper_init);
     addPaths(clipper, ClipperLib::ptSubject);
-    other.addPaths(clipper, ClipperLib::ptClip);
+    addPathsOverlapping(clipper, other, other_bounds, box, ClipperLib::ptClip);
     clipper.Execute(ClipperLib::ctDifference, ret);
     return Shape(std::move(ret));
 }
@@ -185,14 +266,102 @@ Shape Shape::intersection(const Shape& other) const
     {
         return {};
     }
+    const ShapeBounds bounds(*this);
+    const ShapeBounds other_bounds(other);
+    if (! bounds.box.hit(other_bounds.box))
+    {
+        return {};
+    }
     ClipperLib::Paths ret;
     ClipperLib::Clipper clipper(clipper_init);
-    addPaths(clipper, ClipperLib::ptSubject);
-    other.addPaths(clipper, ClipperLib::ptClip);
+    addPathsOverlapping(clipper, *this, bounds, other_bounds.box, ClipperLib::ptSubject);
+    addPathsOverlapping(clipper, other, other_bounds, bounds.box, ClipperLib::ptClip);
     clipper.Execute(ClipperLib::ctIntersection, ret);
     return Shape{ std::move(ret) };
 }
 
+Shape Shape::unionAll(const std::vector<const Shape*>& shapes, ClipperLib::PolyFillType fill_type)
+{
+    const Shape* last_non_empty = nullptr;
+    size_t non_empty_count = 0;
+    for (const Shape* shape : shapes)
+    {
+        if (! shape->empty())
+        {
+            last_non_empty = shape;
+            ++non_empty_count;
+        }
+    }
+    if (non_empty_count == 0)
+    {
+        return {};
+    }
+    if (non_empty_count == 1)
+    {
+        return last_non_empty->unionPolygons(Shape(), fill_type);
+    }
+    ClipperLib::Paths ret;
+    ClipperLib::Clipper clipper(clipper_init);
+    for (const Shape* shape : shapes)
+    {
+        shape->addPaths(clipper, ClipperLib::ptSubject);
+    }
+    clipper.Execute(ClipperLib::ctUnion, ret, fill_type, fill_type);
+    return Shape{ std::move(ret) };
+}
+
+Shape Shape::differenceAll(const std::vector<const Shape*>& others) const
+{
+    if (empty())
+    {
+        return {};
+    }
+    if (std::ranges::all_of(
+            others,
+            [](const Shape* other)
+            {
+                return other->empty();
+            }))
+    {
+        return *this;
+    }
+    const AABB box(*this);
+    ClipperLib::Clipper clipper(clipper_init);
+    for (const Shape* other : others)
+    {
+        const ShapeBounds other_bounds(*other);
+        if (other->empty() || ! box.hit(other_bounds.box))
+        {
+            continue; // Like difference(), which then still cleans up this shape with Clipper below.
+        }
+        if (isRectangle(*other, other_bounds))
+        {
+            if (other_bounds.box.contains(box))
+            {
+                return {};
+            }
+            // A rectangle covers the same area with either fill rule, but a clockwise one would cancel out other shapes with the non-zero rule.
+            Polygon rectangle = other->front();
+            if (rectangle.area() < 0)
+            {
+                rectangle.reverse();
+            }
+            clipper.AddPath(rectangle.getPoints(), ClipperLib::ptClip, true);
+        }
+        else
+        {
+            // The shapes to subtract are combined with the non-zero rule, while difference() reads each of them with the even-odd rule. Those
+            // only agree on counter-clockwise shapes without overlapping or self-intersecting polygons, so make sure it is one. This is linear
+            // in the size of this one shape.
+            other->execute(ClipperLib::pftEvenOdd).addPaths(clipper, ClipperLib::ptClip);
+        }
+    }
+    ClipperLib::Paths ret;
+    addPaths(clipper, ClipperLib::ptSubject);
+    clipper.Execute(ClipperLib::ctDifference, ret, ClipperLib::pftEvenOdd, ClipperLib::pftNonZero);
+    return Shape(std::move(ret));
+}
+
 Shape Shape::offset(coord_t distance, ClipperLib::JoinType join_type, double miter_limit) const
 {
     if (empty())
@@ -3,6 +3,7 @@
 
 #include "infill/LightningDistanceField.h" //Class we're implementing.
 
+#include "utils/ThreadPool.h"
 #include "utils/polygonUtils.h" //For spreadDotsArea helper function.
 
 namespace cura
@@ -18,11 +19,20 @@ LightningDistanceField::LightningDistanceField(const coord_t& radius, const Shap
     , current_overhang_(current_overhang)
 {
     std::vector<Point2LL> regular_dots = PolygonUtils::spreadDotsArea(current_overhang, cell_size_);
-    for (const auto& p : regular_dots)
+    std::vector<coord_t> dists_to_boundary(regular_dots.size());
+    constexpr size_t dots_per_chunk = 64; // Finding the closest point is cheap for small outlines, so don't schedule every dot separately.
+    cura::parallel_for<size_t>(
+        0,
+        regular_dots.size(),
+        [&](const size_t dot_idx)
+        {
+            const ClosestPointPolygon cpp = PolygonUtils::findClosest(regular_dots[dot_idx], current_outline);
+            dists_to_boundary[dot_idx] = vSize(regular_dots[dot_idx] - cpp.p());
+        },
+        dots_per_chunk);
+    for (size_t dot_idx = 0; dot_idx < regular_dots.size(); ++dot_idx)
     {
-        const ClosestPointPolygon cpp = PolygonUtils::findClosest(p, current_outline);
-        const coord_t dist_to_boundary = vSize(p - cpp.p());
-        unsupported_points_.emplace_back(p, dist_to_boundary);
+        unsupported_points_.emplace_back(regular_dots[dot_idx], dists_to_boundary[dot_idx]);
     }
     unsupported_points_.sort(
         [&radius](const UnsupCell& a, const UnsupCell& b)
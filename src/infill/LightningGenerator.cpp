@@ -3,11 +3,19 @@
 
 #include "infill/LightningGenerator.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
 #include "ExtruderTrain.h"
+#include "geometry/SingleShape.h"
 #include "infill/LightningLayer.h"
 #include "infill/LightningTreeNode.h"
 #include "sliceDataStorage.h"
+#include "utils/AABB.h"
 #include "utils/SparsePointGridInclusive.h"
+#include "utils/ThreadPool.h"
 #include "utils/linearAlg2D.h"
 
 /* Possible future tasks/optimizations,etc.:
@@ -37,34 +45,46 @@ LightningGenerator::LightningGenerator(const SliceMeshStorage& mesh)
     prune_length = layer_thickness * std::tan(infill_extruder.settings_.get<AngleRadians>("lightning_infill_prune_angle"));
     straightening_max_distance = layer_thickness * std::tan(infill_extruder.settings_.get<AngleRadians>("lightning_infill_straightening_angle"));
 
-    generateInitialInternalOverhangs(mesh);
-    generateTrees(mesh);
+    const std::vector<Shape> infill_outlines = generateInfillOutlines(mesh);
+    generateInitialInternalOverhangs(infill_outlines);
+    generateTrees(infill_outlines);
 }
 
-void LightningGenerator::generateInitialInternalOverhangs(const SliceMeshStorage& mesh)
+std::vector<Shape> LightningGenerator::generateInfillOutlines(const SliceMeshStorage& mesh) const
 {
-    overhang_per_layer.resize(mesh.layers.size());
     const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
     const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
     const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
 
-    Shape infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = mesh.layers.size() - 1; layer_nr >= 0; layer_nr--)
-    {
-        const SliceLayer& current_layer = mesh.layers[layer_nr];
-        Shape infill_area_here;
-        for (auto& part : current_layer.parts)
+    std::vector<Shape> infill_outlines(mesh.layers.size());
+    cura::parallel_for<size_t>(
+        0,
+        mesh.layers.size(),
+        [&](const size_t layer_nr)
         {
-            infill_area_here.push_back(part.getOwnInfillArea().offset(infill_wall_offset));
-        }
+            for (const auto& part : mesh.layers[layer_nr].parts)
+            {
+                infill_outlines[layer_nr].push_back(part.getOwnInfillArea().offset(infill_wall_offset));
+            }
+        });
+    return infill_outlines;
+}
 
-        // Remove the part of the infill area that is already supported by the walls.
-        Shape overhang = infill_area_here.offset(-wall_supporting_radius).difference(infill_area_above);
+void LightningGenerator::generateInitialInternalOverhangs(const std::vector<Shape>& infill_outlines)
+{
+    overhang_per_layer.resize(infill_outlines.size());
 
-        overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    // Subtract the infill area above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
+    const Shape nothing_above;
+    cura::parallel_for<size_t>(
+        0,
+        infill_outlines.size(),
+        [&](const size_t layer_nr)
+        {
+            // Remove the part of the infill area that is already supported by the walls.
+            const Shape& infill_area_above = layer_nr + 1 < infill_outlines.size() ? infill_outlines[layer_nr + 1] : nothing_above;
+            overhang_per_layer[layer_nr] = infill_outlines[layer_nr].offset(-wall_supporting_radius).difference(infill_area_above);
+        });
 }
 
 const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_id) const
@@ -73,42 +93,40 @@ const LightningLayer& LightningGenerator::getTreesForLayer(const size_t& layer_i
     return lightning_layers[layer_id];
 }
 
-void LightningGenerator::generateTrees(const SliceMeshStorage& mesh)
+void LightningGenerator::generateTrees(const std::vector<Shape>& infill_outlines)
 {
-    lightning_layers.resize(mesh.layers.size());
-    const auto infill_wall_line_count = static_cast<coord_t>(mesh.settings.get<size_t>("infill_wall_line_count"));
-    const auto infill_line_width = mesh.settings.get<coord_t>("infill_line_width");
-    const coord_t infill_wall_offset = -infill_wall_line_count * infill_line_width;
-
-    std::vector<Shape> infill_outlines;
-    infill_outlines.insert(infill_outlines.end(), mesh.layers.size(), Shape());
+    lightning_layers.resize(infill_outlines.size());
+    if (infill_outlines.empty())
+    {
+        return;
+    }
 
-    // For-each layer from top to bottom:
-    for (int layer_id = mesh.layers.size() - 1; layer_id >= 0; layer_id--)
+    // For various operations its beneficial to quickly locate nearby features on the polygon.
+    // The grids are built in parallel, a batch of layers ahead of the layer being processed, and dropped once they're no longer needed.
+    constexpr size_t locator_batch_size = 16;
+    std::vector<std::unique_ptr<LocToLineGrid>> outlines_locators(infill_outlines.size());
+    const auto get_outlines_locator = [&infill_outlines, &outlines_locators](const size_t layer_id) -> const LocToLineGrid&
     {
-        for (const auto& part : mesh.layers[layer_id].parts)
+        if (! outlines_locators[layer_id])
         {
-            infill_outlines[layer_id].push_back(part.getOwnInfillArea().offset(infill_wall_offset));
+            const size_t batch_start = layer_id + 1 >= locator_batch_size ? layer_id + 1 - locator_batch_size : 0;
+            cura::parallel_for<size_t>(
+                batch_start,
+                layer_id + 1,
+                [&](const size_t batch_layer_id)
+                {
+                    outlines_locators[batch_layer_id] = PolygonUtils::createLocToLineGrid(infill_outlines[batch_layer_id], locator_cell_size);
+                });
         }
-    }
-
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = mesh.layers.size() - 1;
-    auto outlines_locator_ptr = PolygonUtils::createLocToLineGrid(infill_outlines[top_layer_id], locator_cell_size);
+        return *outlines_locators[layer_id];
+    };
 
     // For-each layer from top to bottom:
-    for (int layer_id = top_layer_id; layer_id >= 0; layer_id--)
+    for (size_t layer_id = infill_outlines.size() - 1;; layer_id--)
     {
         LightningLayer& current_lightning_layer = lightning_layers[layer_id];
-        Shape& current_outlines = infill_outlines[layer_id];
-        const auto& outlines_locator = *outlines_locator_ptr;
-
-        // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<LightningTreeNodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
-
-        current_lightning_layer.generateNewTrees(overhang_per_layer[layer_id], current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
-
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, outlines_locator, supporting_radius, wall_supporting_radius);
+        generateLayerTrees(current_lightning_layer, overhang_per_layer[layer_id], infill_outlines[layer_id], get_outlines_locator(layer_id));
+        outlines_locators[layer_id].reset();
 
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
@@ -116,8 +134,7 @@ void LightningGenerator::generateTrees(const SliceMeshStorage& mesh)
             return;
         }
         const Shape& below_outlines = infill_outlines[layer_id - 1];
-        outlines_locator_ptr = PolygonUtils::createLocToLineGrid(below_outlines, locator_cell_size);
-        const auto& below_outlines_locator = *outlines_locator_ptr;
+        const auto& below_outlines_locator = get_outlines_locator(layer_id - 1);
 
         std::vector<LightningTreeNodeSPtr>& lower_trees = lightning_layers[layer_id - 1].tree_roots;
         for (auto& tree : current_lightning_layer.tree_roots)
@@ -126,3 +143,186 @@ void LightningGenerator::generateTrees(const SliceMeshStorage& mesh)
         }
     }
 }
+
+namespace
+{
+
+/*!
+ * Simple union-find over indices, used to group the islands of a layer.
+ */
+size_t findGroup(std::vector<size_t>& group_of, size_t item)
+{
+    while (group_of[item] != item)
+    {
+        group_of[item] = group_of[group_of[item]];
+        item = group_of[item];
+    }
+    return item;
+}
+
+/*!
+ * Islands of the infill area of a layer, with the trees growing in them, that can be grown independently of the other islands.
+ */
+struct IslandCluster
+{
+    Shape outlines;
+    Shape overhang;
+    LightningLayer layer;
+};
+
+} // namespace
+
+void LightningGenerator::generateLayerTrees(LightningLayer& layer, const Shape& overhang, const Shape& outlines, const LocToLineGrid& outlines_locator) const
+{
+    const auto generate_trees = [this](LightningLayer& trees, const Shape& trees_overhang, const Shape& trees_outlines, const LocToLineGrid& trees_outlines_locator)
+    {
+        // register all trees propagated from the previous layer as to-be-reconnected
+        std::vector<LightningTreeNodeSPtr> to_be_reconnected_tree_roots = trees.tree_roots;
+
+        trees.generateNewTrees(trees_overhang, trees_outlines, trees_outlines_locator, supporting_radius, wall_supporting_radius);
+
+        trees.reconnectRoots(to_be_reconnected_tree_roots, trees_outlines, trees_outlines_locator, supporting_radius, wall_supporting_radius);
+    };
+
+    if (overhang.empty() && layer.tree_roots.empty())
+    {
+        return; // Nothing to support, and no trees to reconnect.
+    }
+
+    // Splitting the layer in islands only pays off if there are several of them, so don't bother if there's only one outer polygon.
+    const auto outer_polygon_count = std::count_if(
+        outlines.begin(),
+        outlines.end(),
+        [](const Polygon& polygon)
+        {
+            return polygon.area() > 0;
+        });
+    if (outer_polygon_count < 2)
+    {
+        generate_trees(layer, overhang, outlines, outlines_locator);
+        return;
+    }
+
+    // Trees only interact with the outlines and the other trees within a limited distance: the supported area around each node, and the
+    // area where roots look for the outline to reconnect to. Group all islands and trees that are within that distance of each other.
+    const std::vector<SingleShape> islands = outlines.splitIntoParts();
+    const coord_t interaction_distance = std::max(supporting_radius, wall_supporting_radius) + 2 * locator_cell_size;
+    std::vector<AABB> boxes; // The islands first, then the trees.
+    boxes.reserve(islands.size() + layer.tree_roots.size());
+    for (const SingleShape& island : islands)
+    {
+        boxes.emplace_back(island);
+    }
+    for (const LightningTreeNodeSPtr& tree : layer.tree_roots)
+    {
+        AABB& box = boxes.emplace_back();
+        tree->visitNodes(
+            [&box](const LightningTreeNodeSPtr& node)
+            {
+                box.include(node->getLocation());
+            });
+        if (tree->getLastGroundingLocation())
+        {
+            box.include(tree->getLastGroundingLocation().value());
+        }
+    }
+    for (AABB& box : boxes)
+    {
+        box.expand(interaction_distance);
+    }
+
+    std::vector<size_t> group_of(boxes.size());
+    std::iota(group_of.begin(), group_of.end(), 0);
+    std::vector<size_t> by_min_x(boxes.size());
+    std::iota(by_min_x.begin(), by_min_x.end(), 0);
+    std::sort(
+        by_min_x.begin(),
+        by_min_x.end(),
+        [&boxes](const size_t a, const size_t b)
+        {
+            return boxes[a].min_.X < boxes[b].min_.X;
+        });
+    for (size_t i = 0; i < by_min_x.size(); ++i)
+    {
+        const AABB& box = boxes[by_min_x[i]];
+        for (size_t j = i + 1; j < by_min_x.size() && boxes[by_min_x[j]].min_.X <= box.max_.X; ++j)
+        {
+            if (box.hit(boxes[by_min_x[j]]))
+            {
+                group_of[findGroup(group_of, by_min_x[i])] = findGroup(group_of, by_min_x[j]);
+            }
+        }
+    }
+
+    // Number the clusters in the order of their first island, to keep the result independent of the scheduling.
+    constexpr size_t no_cluster = std::numeric_limits<size_t>::max();
+    std::vector<size_t> cluster_of_group(boxes.size(), no_cluster);
+    std::vector<IslandCluster> clusters;
+    for (size_t island_idx = 0; island_idx < islands.size(); ++island_idx)
+    {
+        size_t& cluster_idx = cluster_of_group[findGroup(group_of, island_idx)];
+        if (cluster_idx == no_cluster)
+        {
+            cluster_idx = clusters.size();
+            clusters.emplace_back();
+        }
+        clusters[cluster_idx].outlines.push_back(islands[island_idx]);
+    }
+    if (clusters.size() < 2)
+    {
+        generate_trees(layer, overhang, outlines, outlines_locator);
+        return;
+    }
+    for (size_t tree_idx = 0; tree_idx < layer.tree_roots.size(); ++tree_idx)
+    {
+        const size_t cluster_idx = cluster_of_group[findGroup(group_of, islands.size() + tree_idx)];
+        if (cluster_idx == no_cluster)
+        {
+            // A tree away from all islands. Can't tell which outlines it belongs to.
+            generate_trees(layer, overhang, outlines, outlines_locator);
+            return;
+        }
+        clusters[cluster_idx].layer.tree_roots.push_back(layer.tree_roots[tree_idx]);
+    }
+    // The overhang lies within the outlines, so each of its polygons is within the bounding box of the island it lies in.
+    for (const Polygon& overhang_polygon : overhang)
+    {
+        if (overhang_polygon.empty())
+        {
+            continue;
+        }
+        const auto island_it = std::find_if(
+            boxes.begin(),
+            boxes.begin() + islands.size(),
+            [&overhang_polygon](const AABB& island_box)
+            {
+                return island_box.contains(overhang_polygon.front());
+            });
+        if (island_it == boxes.begin() + islands.size())
+        {
+            generate_trees(layer, overhang, outlines, outlines_locator);
+            return;
+        }
+        clusters[cluster_of_group[findGroup(group_of, island_it - boxes.begin())]].overhang.push_back(overhang_polygon);
+    }
+
+    cura::parallel_for<size_t>(
+        0,
+        clusters.size(),
+        [&](const size_t cluster_idx)
+        {
+            IslandCluster& cluster = clusters[cluster_idx];
+            if (cluster.overhang.empty() && cluster.layer.tree_roots.empty())
+            {
+                return;
+            }
+            const auto cluster_outlines_locator = PolygonUtils::createLocToLineGrid(cluster.outlines, locator_cell_size);
+            generate_trees(cluster.layer, cluster.overhang, cluster.outlines, *cluster_outlines_locator);
+        });
+
+    layer.tree_roots.clear();
+    for (IslandCluster& cluster : clusters)
+    {
+        std::move(cluster.layer.tree_roots.begin(), cluster.layer.tree_roots.end(), std::back_inserter(layer.tree_roots));
+    }
+}
@@ -3,16 +3,26 @@
 
 #include "mesh.h"
 
+#include <atomic>
 #include <numbers>
 
 #include <spdlog/spdlog.h>
 
 #include "utils/Point3D.h"
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
 
 const int vertex_meld_distance = MM2INT(0.03);
+/*!
+ * Returns the melding cell of a location: points within vertex_meld_distance of each other only get merged if they share this cell.
+ */
+static inline Point3LL meldCell(const Point3LL& p)
+{
+    return Point3LL((p.x_ + vertex_meld_distance / 2) / vertex_meld_distance, (p.y_ + vertex_meld_distance / 2) / vertex_meld_distance, (p.z_ + vertex_meld_distance / 2) / vertex_meld_distance);
+}
+
 /*!
  * returns a hash for the location, but first divides by the vertex_meld_distance,
  * so that any point within a box of vertex_meld_distance by vertex_meld_distance would get mapped to the same hash.
@@ -25,15 +35,11 @@ static inline uint32_t pointHash(const Point3LL& p)
 
 Mesh::Mesh(Settings& parent)
     : settings_(parent)
-    , has_disconnected_faces(false)
-    , has_overlapping_faces(false)
 {
 }
 
 Mesh::Mesh()
     : settings_()
-    , has_disconnected_faces(false)
-    , has_overlapping_faces(false)
 {
 }
 
@@ -45,21 +51,135 @@ void Mesh::addFace(Point3LL& v0, Point3LL& v1, Point3LL& v2)
     if (vi0 == vi1 || vi1 == vi2 || vi0 == vi2)
         return; // the face has two vertices which get assigned the same location. Don't add the face.
 
-    int idx = faces_.size(); // index of face to be added
-    faces_.emplace_back();
-    MeshFace& face = faces_[idx];
+    MeshFace& face = faces_.emplace_back();
     face.vertex_index_[0] = vi0;
     face.vertex_index_[1] = vi1;
     face.vertex_index_[2] = vi2;
-    vertices_[face.vertex_index_[0]].connected_faces_.push_back(idx);
-    vertices_[face.vertex_index_[1]].connected_faces_.push_back(idx);
-    vertices_[face.vertex_index_[2]].connected_faces_.push_back(idx);
+}
+
+void Mesh::addFaces(const std::vector<Point3LL>& corners)
+{
+    const size_t corner_count = corners.size() - corners.size() % 3;
+    if (! vertices_.empty() || corner_count == 0)
+    {
+        // Vertices from earlier faces only live in the serial vertex hash map, so weld against those the slow way.
+        for (size_t corner_idx = 0; corner_idx < corner_count; corner_idx += 3)
+        {
+            Point3LL v0 = corners[corner_idx];
+            Point3LL v1 = corners[corner_idx + 1];
+            Point3LL v2 = corners[corner_idx + 2];
+            addFace(v0, v1, v2);
+        }
+        return;
+    }
+
+    // findIndexOfVertex() merges a point with the first earlier vertex of the same hash bucket within vertex_meld_distance. Two points that
+    // close together only share a hash bucket if they share a melding cell, so the same result follows from grouping the corners per cell
+    // and, per group, merging each corner into the first earlier representative within range.
+    struct CornerKey
+    {
+        uint64_t cell_key; //!< Packed melding cell. Distinct cells may collide, so groups are checked against the actual cell as well.
+        uint32_t corner_idx;
+
+        bool operator<(const CornerKey& other) const
+        {
+            return cell_key < other.cell_key || (cell_key == other.cell_key && corner_idx < other.corner_idx);
+        }
+    };
+    std::vector<CornerKey> keys(corner_count);
+    cura::parallel_for<size_t>(
+        0,
+        corner_count,
+        [&](const size_t corner_idx)
+        {
+            const Point3LL cell = meldCell(corners[corner_idx]);
+            constexpr uint64_t mask = (uint64_t(1) << 21) - 1;
+            keys[corner_idx].cell_key = ((static_cast<uint64_t>(cell.x_) & mask) << 42) | ((static_cast<uint64_t>(cell.y_) & mask) << 21) | (static_cast<uint64_t>(cell.z_) & mask);
+            keys[corner_idx].corner_idx = static_cast<uint32_t>(corner_idx);
+        },
+        4096);
+    cura::parallel_sort(keys.begin(), keys.end());
+
+    std::vector<size_t> group_starts;
+    for (size_t key_idx = 0; key_idx < keys.size(); ++key_idx)
+    {
+        if (key_idx == 0 || keys[key_idx].cell_key != keys[key_idx - 1].cell_key)
+        {
+            group_starts.push_back(key_idx);
+        }
+    }
+    group_starts.push_back(keys.size());
+
+    // For each corner, the corner that created the vertex it gets merged into (itself if it creates a new vertex).
+    std::vector<uint32_t> representative(corner_count);
+    cura::parallel_for<size_t>(
+        0,
+        group_starts.size() - 1,
+        [&](const size_t group_idx)
+        {
+            std::vector<uint32_t> group_representatives;
+            for (size_t key_idx = group_starts[group_idx]; key_idx < group_starts[group_idx + 1]; ++key_idx)
+            {
+                const uint32_t corner_idx = keys[key_idx].corner_idx;
+                const Point3LL& p = corners[corner_idx];
+                representative[corner_idx] = corner_idx;
+                for (const uint32_t candidate_idx : group_representatives)
+                {
+                    const Point3LL& candidate = corners[candidate_idx];
+                    if (meldCell(candidate) == meldCell(p) && (candidate - p).testLength(vertex_meld_distance))
+                    {
+                        representative[corner_idx] = candidate_idx;
+                        break;
+                    }
+                }
+                if (representative[corner_idx] == corner_idx)
+                {
+                    group_representatives.push_back(corner_idx);
+                }
+            }
+        },
+        64);
+
+    // Number the vertices in order of creation, as findIndexOfVertex() would.
+    std::vector<int> vertex_idx(corner_count);
+    vertices_.reserve(corner_count / 6);
+    for (size_t corner_idx = 0; corner_idx < corner_count; ++corner_idx)
+    {
+        if (representative[corner_idx] == corner_idx)
+        {
+            vertex_idx[corner_idx] = vertices_.size();
+            vertices_.emplace_back(corners[corner_idx]);
+            aabb_.include(corners[corner_idx]);
+        }
+        else
+        {
+            vertex_idx[corner_idx] = vertex_idx[representative[corner_idx]];
+        }
+    }
+
+    faces_.reserve(faces_.size() + corner_count / 3);
+    for (size_t corner_idx = 0; corner_idx < corner_count; corner_idx += 3)
+    {
+        const int vi0 = vertex_idx[corner_idx];
+        const int vi1 = vertex_idx[corner_idx + 1];
+        const int vi2 = vertex_idx[corner_idx + 2];
+        if (vi0 == vi1 || vi1 == vi2 || vi0 == vi2)
+        {
+            continue; // the face has two vertices which get assigned the same location. Don't add the face.
+        }
+
+        MeshFace& face = faces_.emplace_back();
+        face.vertex_index_[0] = vi0;
+        face.vertex_index_[1] = vi1;
+        face.vertex_index_[2] = vi2;
+    }
 }
 
 void Mesh::clear()
 {
-    faces_.clear();
-    vertices_.clear();
+    // Swap with empty containers rather than clear(), to actually give the memory back.
+    std::vector<MeshFace>().swap(faces_);
+    std::vector<MeshVertex>().swap(vertices_);
     vertex_hash_map_.clear();
 }
 
@@ -68,14 +188,96 @@ void Mesh::finish()
     // Finish up the mesh, clear the vertex_hash_map, as it's no longer needed from this point on and uses quite a bit of memory.
     vertex_hash_map_.clear();
 
+    // Sort all face edges by their (unordered) pair of vertices, so that the faces sharing an edge end up next to each other, in increasing
+    // face order: the same candidates, in the same order, as searching all faces around the edge's first vertex.
+    struct FaceEdge
+    {
+        uint64_t vertex_pair; //!< Lowest vertex index in the high half, highest vertex index in the low half.
+        uint32_t face_edge_idx; //!< Face index * 3 + the index of the edge within the face.
+
+        bool operator<(const FaceEdge& other) const
+        {
+            return vertex_pair < other.vertex_pair || (vertex_pair == other.vertex_pair && face_edge_idx < other.face_edge_idx);
+        }
+    };
+    std::vector<FaceEdge> edges(faces_.size() * 3);
+    cura::parallel_for<size_t>(
+        0,
+        faces_.size(),
+        [&](const size_t face_idx)
+        {
+            const MeshFace& face = faces_[face_idx];
+            for (size_t edge_idx = 0; edge_idx < 3; ++edge_idx)
+            {
+                const uint64_t vertex_a = face.vertex_index_[edge_idx];
+                const uint64_t vertex_b = face.vertex_index_[(edge_idx + 1) % 3];
+                edges[face_idx * 3 + edge_idx] = FaceEdge{ (std::min(vertex_a, vertex_b) << 32) | std::max(vertex_a, vertex_b), static_cast<uint32_t>(face_idx * 3 + edge_idx) };
+            }
+        },
+        4096);
+    cura::parallel_sort(edges.begin(), edges.end());
+
+    std::vector<size_t> group_starts;
+    for (size_t edge_idx = 0; edge_idx < edges.size(); ++edge_idx)
+    {
+        if (edge_idx == 0 || edges[edge_idx].vertex_pair != edges[edge_idx - 1].vertex_pair)
+        {
+            group_starts.push_back(edge_idx);
+        }
+    }
+    group_starts.push_back(edges.size());
+
     // For each face, store which other face is connected with it.
-    for (unsigned int i = 0; i < faces_.size(); i++)
+    std::atomic<size_t> disconnected_edges = 0;
+    std::atomic<size_t> overlapping_faces = 0;
+    cura::parallel_for<size_t>(
+        0,
+        group_starts.size() - 1,
+        [&](const size_t group_idx)
+        {
+            std::vector<int> edge_faces;
+            for (size_t edge_idx = group_starts[group_idx]; edge_idx < group_starts[group_idx + 1]; ++edge_idx)
+            {
+                edge_faces.push_back(edges[edge_idx].face_edge_idx / 3);
+            }
+
+            size_t group_disconnected_edges = 0;
+            size_t group_overlapping_faces = 0;
+            for (size_t edge_idx = group_starts[group_idx]; edge_idx < group_starts[group_idx + 1]; ++edge_idx)
+            {
+                const size_t face_idx = edges[edge_idx].face_edge_idx / 3;
+                const size_t face_edge = edges[edge_idx].face_edge_idx % 3;
+                MeshFace& face = faces_[face_idx];
+                // faces are connected via the outside
+                face.connected_face_index_[face_edge] = getFaceIdxWithPoints(
+                    face.vertex_index_[face_edge],
+                    face.vertex_index_[(face_edge + 1) % 3],
+                    face_idx,
+                    face.vertex_index_[(face_edge + 2) % 3],
+                    edge_faces,
+                    group_disconnected_edges,
+                    group_overlapping_faces);
+            }
+            if (group_disconnected_edges > 0)
+            {
+                disconnected_edges += group_disconnected_edges;
+            }
+            if (group_overlapping_faces > 0)
+            {
+                overlapping_faces += group_overlapping_faces;
+            }
+        },
+        64);
+
+    disconnected_edge_count_ = disconnected_edges;
+    overlapping_face_count_ = overlapping_faces;
+    if (disconnected_edge_count_ > 0)
+    {
+        spdlog::warn("Mesh has disconnected faces! ({} face edges without a unique connected face)", disconnected_edge_count_);
+    }
+    if (overlapping_face_count_ > 0)
     {
-        MeshFace& face = faces_[i];
-        // faces are connected via the outside
-        face.connected_face_index_[0] = getFaceIdxWithPoints(face.vertex_index_[0], face.vertex_index_[1], i, face.vertex_index_[2]);
-        face.connected_face_index_[1] = getFaceIdxWithPoints(face.vertex_index_[1], face.vertex_index_[2], i, face.vertex_index_[0]);
-        face.connected_face_index_[2] = getFaceIdxWithPoints(face.vertex_index_[2], face.vertex_index_[0], i, face.vertex_index_[1]);
+        spdlog::warn("Mesh has overlapping faces! ({} overlapping pairs of faces)", overlapping_face_count_);
     }
 }
 
@@ -163,30 +365,28 @@ See <a href="http://stackoverflow.com/questions/14066933/direct-way-of-computing
 
 
 */
-int Mesh::getFaceIdxWithPoints(int idx0, int idx1, int notFaceIdx, int notFaceVertexIdx) const
+int Mesh::getFaceIdxWithPoints(
+    int idx0,
+    int idx1,
+    int notFaceIdx,
+    int notFaceVertexIdx,
+    const std::vector<int>& edge_faces,
+    size_t& disconnected_edges,
+    size_t& overlapping_faces) const
 {
     std::vector<int> candidateFaces; // in case more than two faces meet at an edge, multiple candidates are generated
-    for (int f : vertices_[idx0].connected_faces_) // search through all faces connected to the first vertex and find those that are also connected to the second
+    for (int f : edge_faces)
     {
-        if (f == notFaceIdx)
+        if (f != notFaceIdx)
         {
-            continue;
-        }
-        if (faces_[f].vertex_index_[0] == idx1 // && faces[f].vertex_index[1] == idx0 // next face should have the right direction!
-            || faces_[f].vertex_index_[1] == idx1 // && faces[f].vertex_index[2] == idx0
-            || faces_[f].vertex_index_[2] == idx1 // && faces[f].vertex_index[0] == idx0
-        )
             candidateFaces.push_back(f);
+        }
     }
 
     if (candidateFaces.size() == 0)
     {
         spdlog::debug("Couldn't find face connected to face {}", notFaceIdx);
-        if (! has_disconnected_faces)
-        {
-            spdlog::warn("Mesh has disconnected faces!");
-        }
-        has_disconnected_faces = true;
+        ++disconnected_edges;
         return -1;
     }
     if (candidateFaces.size() == 1)
@@ -198,11 +398,7 @@ int Mesh::getFaceIdxWithPoints(int idx0, int idx1, int notFaceIdx, int notFaceVe
     if (candidateFaces.size() % 2 == 0)
     {
         spdlog::debug("Edge with uneven number of faces connecting it!({})\n", candidateFaces.size() + 1);
-        if (! has_disconnected_faces)
-        {
-            spdlog::warn("Mesh has disconnected faces!");
-        }
-        has_disconnected_faces = true;
+        ++disconnected_edges;
     }
 
     Point3D vn = vertices_[idx1].p_ - vertices_[idx0].p_;
@@ -241,11 +437,7 @@ int Mesh::getFaceIdxWithPoints(int idx0, int idx1, int notFaceIdx, int notFaceVe
         if (angle == 0)
         {
             spdlog::debug("Overlapping faces: face {} and face {}.", notFaceIdx, candidateFace);
-            if (! has_overlapping_faces)
-            {
-                spdlog::warn("Mesh has overlapping faces!");
-            }
-            has_overlapping_faces = true;
+            ++overlapping_faces;
         }
         if (angle < smallestAngle)
         {
@@ -256,11 +448,7 @@ int Mesh::getFaceIdxWithPoints(int idx0, int idx1, int notFaceIdx, int notFaceVe
     if (bestIdx < 0)
     {
         spdlog::debug("Couldn't find face connected to face {}.", notFaceIdx);
-        if (! has_disconnected_faces)
-        {
-            spdlog::warn("Mesh has disconnected faces!");
-        }
-        has_disconnected_faces = true;
+        ++disconnected_edges;
     }
     return bestIdx;
 }
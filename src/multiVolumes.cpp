@@ -13,6 +13,7 @@
 #include "settings/types/LayerIndex.h"
 #include "slicer.h"
 #include "utils/OpenPolylineStitcher.h"
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
@@ -21,49 +22,93 @@ void carveMultipleVolumes(std::vector<Slicer*>& volumes)
 {
     // Go trough all the volumes, and remove the previous volume outlines from our own outline, so we never have overlapped areas.
     const bool alternate_carve_order = Application::getInstance().current_slice_->scene.current_mesh_group->settings.get<bool>("alternate_carve_order");
-    std::vector<Slicer*> ranked_volumes = volumes;
+
+    // Look up the settings of each volume once, rather than for every pair of volumes on every layer.
+    struct RankedVolume
+    {
+        Slicer* slicer_;
+        int infill_mesh_order_;
+        bool is_carved_; //!< Whether this volume takes part in the carving at all.
+        std::vector<size_t> carving_volumes_; //!< The ranked volumes before this one which may overlap with it.
+    };
+    std::vector<RankedVolume> ranked_volumes;
+    ranked_volumes.reserve(volumes.size());
+    for (Slicer* volume : volumes)
+    {
+        const Settings& settings = volume->mesh->settings_;
+        const bool is_carved = ! (settings.get<bool>("infill_mesh") || settings.get<bool>("anti_overhang_mesh") || settings.get<bool>("support_mesh")
+                                  || settings.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE);
+        ranked_volumes.push_back(RankedVolume{ volume, settings.get<int>("infill_mesh_order"), is_carved, {} });
+    }
     std::sort(
         ranked_volumes.begin(),
         ranked_volumes.end(),
-        [](Slicer* volume_1, Slicer* volume_2)
+        [](const RankedVolume& volume_1, const RankedVolume& volume_2)
         {
-            return volume_1->mesh->settings_.get<int>("infill_mesh_order") < volume_2->mesh->settings_.get<int>("infill_mesh_order");
+            return volume_1.infill_mesh_order_ < volume_2.infill_mesh_order_;
         });
-    for (unsigned int volume_1_idx = 1; volume_1_idx < volumes.size(); volume_1_idx++)
+
+    size_t layer_count = 0;
+    for (size_t volume_1_idx = 0; volume_1_idx < ranked_volumes.size(); volume_1_idx++)
     {
-        Slicer& volume_1 = *ranked_volumes[volume_1_idx];
-        if (volume_1.mesh->settings_.get<bool>("infill_mesh") || volume_1.mesh->settings_.get<bool>("anti_overhang_mesh") || volume_1.mesh->settings_.get<bool>("support_mesh")
-            || volume_1.mesh->settings_.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE)
+        RankedVolume& volume_1 = ranked_volumes[volume_1_idx];
+        if (! volume_1.is_carved_)
         {
             continue;
         }
-        for (unsigned int volume_2_idx = 0; volume_2_idx < volume_1_idx; volume_2_idx++)
+        layer_count = std::max(layer_count, volume_1.slicer_->layers.size());
+        const AABB3D aabb = volume_1.slicer_->mesh->getAABB();
+        for (size_t volume_2_idx = 0; volume_2_idx < volume_1_idx; volume_2_idx++)
         {
-            Slicer& volume_2 = *ranked_volumes[volume_2_idx];
-            if (volume_2.mesh->settings_.get<bool>("infill_mesh") || volume_2.mesh->settings_.get<bool>("anti_overhang_mesh") || volume_2.mesh->settings_.get<bool>("support_mesh")
-                || volume_2.mesh->settings_.get<ESurfaceMode>("magic_mesh_surface_mode") == ESurfaceMode::SURFACE)
+            const RankedVolume& volume_2 = ranked_volumes[volume_2_idx];
+            if (volume_2.is_carved_ && aabb.hit(volume_2.slicer_->mesh->getAABB()))
             {
-                continue;
+                volume_1.carving_volumes_.push_back(volume_2_idx);
             }
-            if (! volume_1.mesh->getAABB().hit(volume_2.mesh->getAABB()))
-            {
-                continue;
-            }
-            for (LayerIndex layerNr = 0; layerNr < volume_1.layers.size(); layerNr++)
+        }
+    }
+
+    // Each layer is carved independently of the other layers, so the layers are carved in parallel. Within a layer the volumes are carved in
+    // order of their rank, as before.
+    cura::parallel_for<size_t>(
+        0,
+        layer_count,
+        [&](const size_t layer_nr)
+        {
+            for (size_t volume_1_idx = 1; volume_1_idx < ranked_volumes.size(); volume_1_idx++)
             {
-                SlicerLayer& layer1 = volume_1.layers[layerNr];
-                SlicerLayer& layer2 = volume_2.layers[layerNr];
-                if (alternate_carve_order && layerNr % 2 == 0 && volume_1.mesh->settings_.get<int>("infill_mesh_order") == volume_2.mesh->settings_.get<int>("infill_mesh_order"))
+                const RankedVolume& volume_1 = ranked_volumes[volume_1_idx];
+                if (volume_1.carving_volumes_.empty() || layer_nr >= volume_1.slicer_->layers.size())
                 {
-                    layer2.polygons_ = layer2.polygons_.difference(layer1.polygons_);
+                    continue;
                 }
-                else
+                Shape& polygons_1 = volume_1.slicer_->layers[layer_nr].polygons_;
+                // Subtract the other volumes from this one in one go, except where one of them is carved by this volume instead, which needs this volume
+                // as it is at that point.
+                std::vector<const Shape*> to_subtract;
+                for (const size_t volume_2_idx : volume_1.carving_volumes_)
                 {
-                    layer1.polygons_ = layer1.polygons_.difference(layer2.polygons_);
+                    const RankedVolume& volume_2 = ranked_volumes[volume_2_idx];
+                    if (layer_nr >= volume_2.slicer_->layers.size())
+                    {
+                        continue;
+                    }
+                    Shape& polygons_2 = volume_2.slicer_->layers[layer_nr].polygons_;
+                    if (alternate_carve_order && layer_nr % 2 == 0 && volume_1.infill_mesh_order_ == volume_2.infill_mesh_order_)
+                    {
+                        polygons_1 = polygons_1.differenceAll(to_subtract);
+                        to_subtract.clear();
+                        polygons_2 = polygons_2.difference(polygons_1);
+                    }
+                    else
+                    {
+                        to_subtract.push_back(&polygons_2);
+                    }
                 }
+                // Shapes that don't overlap this layer are still passed on, as subtracting them cleans up the outlines all the same.
+                polygons_1 = polygons_1.differenceAll(to_subtract);
             }
-        }
-    }
+        });
 }
 
 // Expand each layer a bit and then keep the extra overlapping parts that overlap with other volumes.
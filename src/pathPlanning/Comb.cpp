@@ -5,7 +5,6 @@
 
 #include <algorithm>
 #include <functional> // function
-#include <unordered_set>
 
 #include "Application.h"
 #include "ExtruderTrain.h"
@@ -29,6 +28,16 @@ LocToLineGrid& Comb::getOutsideLocToLine(const ExtruderTrain& train)
     return *outside_loc_to_line_[train.extruder_nr_];
 }
 
+const std::vector<AABB>& Comb::getOutsidePolygonBoxes(const ExtruderTrain& train)
+{
+    const auto found = outside_polygon_boxes_.find(train.extruder_nr_);
+    if (found != outside_polygon_boxes_.end())
+    {
+        return found->second;
+    }
+    return outside_polygon_boxes_.emplace(train.extruder_nr_, LinePolygonsCrossings::computePolygonBoxes(getBoundaryOutside(train))).first->second;
+}
+
 Shape& Comb::getBoundaryOutside(const ExtruderTrain& train)
 {
     if (boundary_outside_[train.extruder_nr_].empty())
@@ -79,12 +88,59 @@ Comb::Comb(
     , boundary_inside_optimal_(comb_boundary_inside_optimal) // copy the boundary, because the partsView_inside will reorder the polygons
     , parts_view_inside_minimum_(boundary_inside_minimum_.splitIntoPartsView()) // WARNING !! changes the order of boundary_inside !!
     , parts_view_inside_optimal_(boundary_inside_optimal_.splitIntoPartsView()) // WARNING !! changes the order of boundary_inside !!
+    , parts_inside_minimum_(parts_view_inside_minimum_)
+    , parts_inside_optimal_(parts_view_inside_optimal_)
+    , polygon_boxes_inside_optimal_(LinePolygonsCrossings::computePolygonBoxes(boundary_inside_optimal_))
     , inside_loc_to_line_minimum_(PolygonUtils::createLocToLineGrid(boundary_inside_minimum_, comb_boundary_offset))
     , inside_loc_to_line_optimal_(PolygonUtils::createLocToLineGrid(boundary_inside_optimal_, comb_boundary_offset))
     , move_inside_distance_(move_inside_distance)
 {
 }
 
+Comb::PartIndex::PartIndex(const PartsView& parts_view)
+    : parts_view_(parts_view)
+    , part_of_polygon_(parts_view.polygons_.size(), NO_INDEX)
+{
+    parts_.reserve(parts_view.size());
+    for (size_t part_idx = 0; part_idx < parts_view.size(); ++part_idx)
+    {
+        Part& part = parts_.emplace_back();
+        part.shape_ = parts_view.assemblePart(part_idx);
+        part.polygon_boxes_ = LinePolygonsCrossings::computePolygonBoxes(part.shape_);
+        for (const size_t poly_idx : parts_view[part_idx])
+        {
+            if (part_of_polygon_[poly_idx] == NO_INDEX) // Same as the linear search: the first part listing the polygon wins.
+            {
+                part_of_polygon_[poly_idx] = part_idx;
+            }
+        }
+    }
+}
+
+size_t Comb::PartIndex::getPartContaining(const size_t poly_idx, size_t* boundary_poly_idx) const
+{
+    if (poly_idx >= part_of_polygon_.size() || part_of_polygon_[poly_idx] == NO_INDEX)
+    {
+        return NO_INDEX;
+    }
+    const size_t part_idx = part_of_polygon_[poly_idx];
+    if (boundary_poly_idx)
+    {
+        *boundary_poly_idx = parts_view_[part_idx][0];
+    }
+    return part_idx;
+}
+
+const Comb::PartIndex::Part& Comb::PartIndex::getPart(const size_t part_idx) const
+{
+    return part_idx < parts_.size() ? parts_[part_idx] : empty_part_;
+}
+
+bool Comb::PartIndex::isInPart(const size_t poly_idx, const size_t part_idx) const
+{
+    return poly_idx < part_of_polygon_.size() && part_of_polygon_[poly_idx] == part_idx;
+}
+
 bool Comb::calc(
     bool perform_z_hops,
     bool perform_z_hops_only_when_collides,
@@ -111,25 +167,26 @@ bool Comb::calc(
 
     size_t start_part_boundary_poly_idx = NO_INDEX; // Added initial value to stop MSVC throwing an exception in debug mode
     size_t end_part_boundary_poly_idx = NO_INDEX;
-    size_t start_part_idx = (start_inside_poly == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(start_inside_poly, &start_part_boundary_poly_idx);
-    size_t end_part_idx = (end_inside_poly == NO_INDEX) ? NO_INDEX : parts_view_inside_optimal_.getPartContaining(end_inside_poly, &end_part_boundary_poly_idx);
+    size_t start_part_idx = (start_inside_poly == NO_INDEX) ? NO_INDEX : parts_inside_optimal_.getPartContaining(start_inside_poly, &start_part_boundary_poly_idx);
+    size_t end_part_idx = (end_inside_poly == NO_INDEX) ? NO_INDEX : parts_inside_optimal_.getPartContaining(end_inside_poly, &end_part_boundary_poly_idx);
 
     const bool fail_on_unavoidable_obstacles = perform_z_hops && perform_z_hops_only_when_collides;
 
     // normal combing within part using optimal comb boundary
     if (start_inside && end_inside && start_part_idx == end_part_idx)
     {
-        SingleShape part = parts_view_inside_optimal_.assemblePart(start_part_idx);
+        const PartIndex::Part& part = parts_inside_optimal_.getPart(start_part_idx);
         comb_paths.emplace_back();
         const bool combing_succeeded = LinePolygonsCrossings::comb(
-            part,
+            part.shape_,
             *inside_loc_to_line_optimal_,
             start_point,
             end_point,
             comb_paths.back(),
             -offset_dist_to_get_from_on_the_polygon_to_outside_,
             max_comb_distance_ignored,
-            fail_on_unavoidable_obstacles);
+            fail_on_unavoidable_obstacles,
+            &part.polygon_boxes_);
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
         unretract_before_last_travel_move = combing_succeeded && end_point != travel_end_point_before_combing;
@@ -146,8 +203,8 @@ bool Comb::calc(
     size_t start_part_boundary_poly_idx_min{};
     size_t end_part_boundary_poly_idx_min{};
     size_t start_part_idx_min
-        = (start_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_view_inside_minimum_.getPartContaining(start_inside_poly_min, &start_part_boundary_poly_idx_min);
-    size_t end_part_idx_min = (end_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_view_inside_minimum_.getPartContaining(end_inside_poly_min, &end_part_boundary_poly_idx_min);
+        = (start_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_inside_minimum_.getPartContaining(start_inside_poly_min, &start_part_boundary_poly_idx_min);
+    size_t end_part_idx_min = (end_inside_poly_min == NO_INDEX) ? NO_INDEX : parts_inside_minimum_.getPartContaining(end_inside_poly_min, &end_part_boundary_poly_idx_min);
 
     CombPath result_path;
     bool comb_result;
@@ -155,18 +212,19 @@ bool Comb::calc(
     // normal combing within part using minimum comb boundary
     if (start_inside_min && end_inside_min && start_part_idx_min == end_part_idx_min)
     {
-        SingleShape part = parts_view_inside_minimum_.assemblePart(start_part_idx_min);
+        const PartIndex::Part& part = parts_inside_minimum_.getPart(start_part_idx_min);
         comb_paths.emplace_back();
 
         comb_result = LinePolygonsCrossings::comb(
-            part,
+            part.shape_,
             *inside_loc_to_line_minimum_,
             start_point,
             end_point,
             result_path,
             -offset_dist_to_get_from_on_the_polygon_to_outside_,
             max_comb_distance_ignored,
-            fail_on_unavoidable_obstacles);
+            fail_on_unavoidable_obstacles,
+            &part.polygon_boxes_);
         Comb::moveCombPathInside(boundary_inside_minimum_, boundary_inside_optimal_, result_path, comb_paths.back()); // add altered result_path to combPaths.back()
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when travelling to that outer wall
@@ -192,8 +250,8 @@ bool Comb::calc(
     Crossing end_crossing(end_point, end_inside_min, end_part_idx_min, end_part_boundary_poly_idx_min, boundary_inside_minimum_, *inside_loc_to_line_minimum_);
 
     { // find crossing over the in-between area between inside and outside
-        start_crossing.findCrossingInOrMid(parts_view_inside_minimum_, end_point);
-        end_crossing.findCrossingInOrMid(parts_view_inside_minimum_, start_crossing.in_or_mid_);
+        start_crossing.findCrossingInOrMid(parts_inside_minimum_, end_point);
+        end_crossing.findCrossingInOrMid(parts_inside_minimum_, start_crossing.in_or_mid_);
     }
 
     bool skip_avoid_other_parts_path = false;
@@ -224,7 +282,7 @@ bool Comb::calc(
     if (start_inside_min)
     {
         // start to boundary
-        assert(start_crossing.dest_part_.size() > 0 && "The part we start inside when combing should have been computed already!");
+        assert(start_crossing.dest_part_ != nullptr && ! start_crossing.dest_part_->shape_.empty() && "The part we start inside when combing should have been computed already!");
         comb_paths.emplace_back();
         // If we're inside the optimal bound, first try the optimal combing path. If it fails, use the minimum path instead.
         constexpr bool fail_for_optimum_bound = true;
@@ -237,18 +295,20 @@ bool Comb::calc(
                                      comb_paths.back(),
                                      -offset_dist_to_get_from_on_the_polygon_to_outside_,
                                      max_comb_distance_ignored,
-                                     fail_for_optimum_bound);
+                                     fail_for_optimum_bound,
+                                     &polygon_boxes_inside_optimal_);
         if (! combing_succeeded)
         {
             combing_succeeded = LinePolygonsCrossings::comb(
-                start_crossing.dest_part_,
+                start_crossing.dest_part_->shape_,
                 *inside_loc_to_line_minimum_,
                 start_point,
                 start_crossing.in_or_mid_,
                 comb_paths.back(),
                 -offset_dist_to_get_from_on_the_polygon_to_outside_,
                 max_comb_distance_ignored,
-                fail_on_unavoidable_obstacles);
+                fail_on_unavoidable_obstacles,
+                &start_crossing.dest_part_->polygon_boxes_);
         }
         if (! combing_succeeded)
         { // Couldn't comb between start point and computed crossing from the start part! Happens for very thin parts when the offset_to_get_off_boundary moves points to outside
@@ -279,7 +339,8 @@ bool Comb::calc(
                 tmp_comb_path,
                 offset_dist_to_get_from_on_the_polygon_to_outside_,
                 max_comb_distance_ignored,
-                true);
+                true,
+                &getOutsidePolygonBoxes(train));
 
             if (combing_succeeded)
             {
@@ -334,7 +395,7 @@ bool Comb::calc(
     if (end_inside)
     {
         // boundary to end
-        assert(end_crossing.dest_part_.size() > 0 && "The part we end up inside when combing should have been computed already!");
+        assert(end_crossing.dest_part_ != nullptr && ! end_crossing.dest_part_->shape_.empty() && "The part we end up inside when combing should have been computed already!");
         comb_paths.emplace_back();
         // If we're inside the optimal bound, first try the optimal combing path. If it fails, use the minimum path instead.
         constexpr bool fail_for_optimum_bound = true;
@@ -347,18 +408,20 @@ bool Comb::calc(
                                      comb_paths.back(),
                                      -offset_dist_to_get_from_on_the_polygon_to_outside_,
                                      max_comb_distance_ignored,
-                                     fail_for_optimum_bound);
+                                     fail_for_optimum_bound,
+                                     &polygon_boxes_inside_optimal_);
         if (! combing_succeeded)
         {
             combing_succeeded = LinePolygonsCrossings::comb(
-                end_crossing.dest_part_,
+                end_crossing.dest_part_->shape_,
                 *inside_loc_to_line_minimum_,
                 end_crossing.in_or_mid_,
                 end_point,
                 comb_paths.back(),
                 -offset_dist_to_get_from_on_the_polygon_to_outside_,
                 max_comb_distance_ignored,
-                fail_on_unavoidable_obstacles);
+                fail_on_unavoidable_obstacles,
+                &end_crossing.dest_part_->polygon_boxes_);
         }
         // If the endpoint of the travel path changes with combing, then it means that we are moving to an outer wall
         // and we should unretract before the last travel move when traveling to that outer wall
@@ -443,7 +506,7 @@ bool Comb::moveInside(Shape& boundary_inside, bool is_inside, LocToLineGrid* ins
     return false;
 }
 
-void Comb::Crossing::findCrossingInOrMid(const PartsView& partsView_inside, const Point2LL close_to)
+void Comb::Crossing::findCrossingInOrMid(const PartIndex& parts_inside, const Point2LL close_to)
 {
     if (dest_is_inside_)
     { // in-case
@@ -454,20 +517,16 @@ void Comb::Crossing::findCrossingInOrMid(const PartsView& partsView_inside, cons
             {
                 return vSize2((candidate - _dest_point) / 10);
             });
-        dest_part_ = partsView_inside.assemblePart(dest_part_idx_);
+        dest_part_ = &parts_inside.getPart(dest_part_idx_);
 
         ClosestPointPolygon boundary_crossing_point;
         { // set [result] to a point on the destination part closest to close_to (but also a bit close to _dest_point)
-            std::unordered_set<unsigned int> dest_part_poly_indices;
-            for (unsigned int poly_idx : partsView_inside[dest_part_idx_])
-            {
-                dest_part_poly_indices.emplace(poly_idx);
-            }
+            const size_t dest_part_idx = dest_part_idx_;
             coord_t dist2_score = std::numeric_limits<coord_t>::max();
             std::function<bool(const PolygonsPointIndex&)> line_processor
-                = [close_to, _dest_point, &boundary_crossing_point, &dist2_score, &dest_part_poly_indices](const PolygonsPointIndex& boundary_segment)
+                = [close_to, _dest_point, &boundary_crossing_point, &dist2_score, &parts_inside, dest_part_idx](const PolygonsPointIndex& boundary_segment)
             {
-                if (dest_part_poly_indices.find(boundary_segment.poly_idx_) == dest_part_poly_indices.end())
+                if (! parts_inside.isInPart(boundary_segment.poly_idx_, dest_part_idx))
                 { // we're not looking at a polygon from the dest_part
                     return true; // a.k.a. continue;
                 }
@@ -490,7 +549,7 @@ void Comb::Crossing::findCrossingInOrMid(const PartsView& partsView_inside, cons
         }
 
         ClosestPointPolygon crossing_1_in_cp = PolygonUtils::ensureInsideOrOutside(
-            dest_part_,
+            dest_part_->shape_,
             result,
             boundary_crossing_point,
             offset_dist_to_get_from_on_the_polygon_to_outside_,
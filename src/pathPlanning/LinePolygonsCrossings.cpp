@@ -18,10 +18,30 @@ LinePolygonsCrossings::Crossing::Crossing(const size_t poly_idx, const coord_t x
 {
 }
 
+std::vector<AABB> LinePolygonsCrossings::computePolygonBoxes(const Shape& boundary)
+{
+    std::vector<AABB> polygon_boxes;
+    polygon_boxes.reserve(boundary.size());
+    for (const Polygon& poly : boundary)
+    {
+        polygon_boxes.emplace_back(poly);
+    }
+    return polygon_boxes;
+}
+
+bool LinePolygonsCrossings::mayCross(const size_t poly_idx) const
+{
+    return polygon_boxes_ == nullptr || (*polygon_boxes_)[poly_idx].hit(segment_box_);
+}
+
 bool LinePolygonsCrossings::calcScanlineCrossings(bool fail_on_unavoidable_obstacles)
 {
     for (unsigned int poly_idx = 0; poly_idx < boundary_.size(); poly_idx++)
     {
+        if (! mayCross(poly_idx))
+        { // Can't add any crossings, so the number of crossings stays even too.
+            continue;
+        }
         const Polygon& poly = boundary_[poly_idx];
         Point2LL p0 = transformation_matrix_.apply(poly[poly.size() - 1]);
         for (unsigned int point_idx = 0; point_idx < poly.size(); point_idx++)
@@ -74,8 +94,13 @@ bool LinePolygonsCrossings::lineSegmentCollidesWithBoundary()
     transformed_start_point_ = transformation_matrix_.apply(start_point_);
     transformed_end_point_ = transformation_matrix_.apply(end_point_);
 
-    for (const Polygon& poly : boundary_)
+    for (size_t poly_idx = 0; poly_idx < boundary_.size(); ++poly_idx)
     {
+        if (! mayCross(poly_idx))
+        {
+            continue;
+        }
+        const Polygon& poly = boundary_[poly_idx];
         Point2LL p0 = transformation_matrix_.apply(poly.back());
         for (Point2LL p1_ : poly)
         {
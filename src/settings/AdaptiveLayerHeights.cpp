@@ -7,12 +7,14 @@
 #include <cmath>
 #include <limits>
 #include <numbers>
+#include <numeric>
 
 #include "Application.h"
 #include "Slice.h"
 #include "settings/EnumSettings.h"
 #include "settings/types/Angle.h"
 #include "utils/Point3D.h"
+#include "utils/ThreadPool.h"
 
 namespace cura
 {
@@ -22,7 +24,13 @@ AdaptiveLayer::AdaptiveLayer(const coord_t layer_height)
 {
 }
 
-AdaptiveLayerHeights::AdaptiveLayerHeights(const coord_t base_layer_height, const coord_t variation, const coord_t step_size, const coord_t threshold, const MeshGroup* meshgroup)
+AdaptiveLayerHeights::AdaptiveLayerHeights(
+    const coord_t base_layer_height,
+    const coord_t variation,
+    const coord_t step_size,
+    const coord_t threshold,
+    const MeshGroup* meshgroup,
+    const std::vector<CompactMesh>& mesh_geometries)
     : base_layer_height_{ base_layer_height }
     , max_variation_{ variation }
     , step_size_{ step_size }
@@ -30,7 +38,7 @@ AdaptiveLayerHeights::AdaptiveLayerHeights(const coord_t base_layer_height, cons
     , meshgroup_{ meshgroup }
 {
     calculateAllowedLayerHeights();
-    calculateMeshTriangleSlopes();
+    calculateMeshTriangleSlopes(mesh_geometries);
     calculateLayers();
 }
 
@@ -64,7 +72,6 @@ void AdaptiveLayerHeights::calculateLayers()
     const coord_t minimum_layer_height = *std::min_element(allowed_layer_heights_.begin(), allowed_layer_heights_.end());
     Settings const& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
     auto slicing_tolerance = mesh_group_settings.get<SlicingTolerance>("slicing_tolerance");
-    std::vector<size_t> triangles_of_interest;
     const coord_t model_max_z = meshgroup_->max().z_;
     coord_t z_level = 0;
     coord_t previous_layer_height = 0;
@@ -78,71 +85,84 @@ void AdaptiveLayerHeights::calculateLayers()
     previous_layer_height = adaptive_layer.layer_height_;
     layers_.push_back(adaptive_layer);
 
+    // Sweep upwards through the triangles, rather than searching through all of them for every layer. A triangle becomes active once the
+    // thickest potential layer reaches its bottom, and stops being active once the layers have passed its top. The active triangles are kept
+    // in a heap with the one ending lowest in front.
+    std::vector<size_t> triangles_by_min_z(face_min_z_values_.size());
+    std::iota(triangles_by_min_z.begin(), triangles_by_min_z.end(), 0);
+    cura::parallel_sort(
+        triangles_by_min_z.begin(),
+        triangles_by_min_z.end(),
+        [this](const size_t a, const size_t b)
+        {
+            return face_min_z_values_[a] < face_min_z_values_[b];
+        });
+    size_t next_triangle = 0;
+    std::vector<size_t> active_triangles;
+    const auto ends_higher = [this](const size_t a, const size_t b)
+    {
+        return face_max_z_values_[a] > face_max_z_values_[b];
+    };
+
+    std::vector<coord_t> upper_bounds(allowed_layer_heights_.size());
+    std::vector<double> minimum_slopes(allowed_layer_heights_.size());
+    constexpr double no_triangles = std::numeric_limits<double>::max();
+
     // loop while triangles are found
     while (z_level <= model_max_z || layers_.size() < 2)
     {
-        double global_min_slope = std::numeric_limits<double>::max();
-        // loop over all allowed layer heights starting with the largest
-        bool has_added_layer = false;
-        for (auto& layer_height : allowed_layer_heights_)
+        // use lower and upper bounds to filter on triangles that are interesting for each potential layer
+        const coord_t lower_bound = z_level;
+        for (size_t height_idx = 0; height_idx < allowed_layer_heights_.size(); ++height_idx)
         {
-            // use lower and upper bounds to filter on triangles that are interesting for this potential layer
-            const coord_t lower_bound = z_level;
             // if slicing tolerance "middle" is used, a layer is interpreted as the middle of the upper and lower bounds.
-            const coord_t upper_bound = z_level + ((slicing_tolerance == SlicingTolerance::MIDDLE) ? (layer_height / 2) : layer_height);
+            const coord_t layer_height = allowed_layer_heights_[height_idx];
+            upper_bounds[height_idx] = z_level + ((slicing_tolerance == SlicingTolerance::MIDDLE) ? (layer_height / 2) : layer_height);
+        }
 
-            if (layer_height == allowed_layer_heights_[0])
-            {
-                // this is the max layer thickness, search through all of the triangles in the mesh to find those
-                // that intersect with a layer this thick
-                triangles_of_interest.clear();
+        while (next_triangle < triangles_by_min_z.size() && face_min_z_values_[triangles_by_min_z[next_triangle]] <= upper_bounds.front())
+        {
+            active_triangles.push_back(triangles_by_min_z[next_triangle]);
+            std::push_heap(active_triangles.begin(), active_triangles.end(), ends_higher);
+            ++next_triangle;
+        }
+        while (! active_triangles.empty() && face_max_z_values_[active_triangles.front()] < lower_bound)
+        {
+            std::pop_heap(active_triangles.begin(), active_triangles.end(), ends_higher);
+            active_triangles.pop_back();
+        }
 
-                for (size_t i = 0; i < face_min_z_values_.size(); ++i)
-                {
-                    if (face_min_z_values_[i] <= upper_bound && face_max_z_values_[i] >= lower_bound)
-                    {
-                        triangles_of_interest.push_back(i);
-                    }
-                }
-            }
-            else
+        // Find the minimum slope of the triangles in a potential layer of each allowed height, from the thickest to the thinnest.
+        // A thinner layer contains fewer triangles, so first collect each triangle under the thinnest layer it is in, then carry the minimum
+        // over to the thicker layers.
+        std::fill(minimum_slopes.begin(), minimum_slopes.end(), no_triangles);
+        for (const size_t triangle_index : active_triangles)
+        {
+            size_t thinnest_idx = 0;
+            while (thinnest_idx + 1 < upper_bounds.size() && face_min_z_values_[triangle_index] <= upper_bounds[thinnest_idx + 1])
             {
-                // this is a reduced thickness layer, just search those triangles that intersected with the layer
-                // in the previous iteration
-                const std::vector<size_t> last_triangles_of_interest = triangles_of_interest;
-
-                triangles_of_interest.clear();
-
-                for (const auto& i : last_triangles_of_interest)
-                {
-                    if (face_min_z_values_[i] <= upper_bound)
-                    {
-                        triangles_of_interest.push_back(i);
-                    }
-                }
+                ++thinnest_idx;
             }
+            minimum_slopes[thinnest_idx] = std::min(minimum_slopes[thinnest_idx], face_slopes_[triangle_index]);
+        }
+        for (size_t height_idx = minimum_slopes.size() - 1; height_idx > 0; --height_idx)
+        {
+            minimum_slopes[height_idx - 1] = std::min(minimum_slopes[height_idx - 1], minimum_slopes[height_idx]);
+        }
+
+        // loop over all allowed layer heights starting with the largest
+        bool has_added_layer = false;
+        for (size_t height_idx = 0; height_idx < allowed_layer_heights_.size(); ++height_idx)
+        {
+            const coord_t layer_height = allowed_layer_heights_[height_idx];
+            const double minimum_slope = minimum_slopes[height_idx];
 
             // when there not interesting triangles in this potential layer go to the next one
-            if (triangles_of_interest.empty())
+            if (minimum_slope == no_triangles)
             {
                 break;
             }
 
-            // find the minimum slope of all the interesting triangles
-            double minimum_slope = std::numeric_limits<double>::max();
-            for (const size_t& triangle_index : triangles_of_interest)
-            {
-                const double slope = face_slopes_.at(triangle_index);
-                if (minimum_slope > slope)
-                {
-                    minimum_slope = slope;
-                }
-            }
-            if (global_min_slope > minimum_slope)
-            {
-                global_min_slope = minimum_slope;
-            }
-
             // check if the maximum step size has been exceeded depending on layer height direction
             bool has_exceeded_step_size = false;
             if (previous_layer_height > layer_height && previous_layer_height - layer_height > step_size_)
@@ -185,49 +205,55 @@ void AdaptiveLayerHeights::calculateLayers()
     }
 }
 
-void AdaptiveLayerHeights::calculateMeshTriangleSlopes()
+void AdaptiveLayerHeights::calculateMeshTriangleSlopes(const std::vector<CompactMesh>& mesh_geometries)
 {
     // loop over all mesh faces (triangles) and find their slopes
-    for (const Mesh& mesh : Application::getInstance().current_slice_->scene.current_mesh_group->meshes)
+    for (size_t mesh_idx = 0; mesh_idx < meshgroup_->meshes.size(); ++mesh_idx)
     {
         // Skip meshes that are not printable
+        const Mesh& mesh = meshgroup_->meshes[mesh_idx];
         if (mesh.settings_.get<bool>("infill_mesh") || mesh.settings_.get<bool>("cutting_mesh") || mesh.settings_.get<bool>("anti_overhang_mesh"))
         {
             continue;
         }
 
-        for (const MeshFace& face : mesh.faces_)
-        {
-            const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-            const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-            const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
-
-            const Point3D p0 = v0.p_;
-            const Point3D p1 = v1.p_;
-            const Point3D p2 = v2.p_;
-
-            double min_z = p0.z_;
-            min_z = std::min(min_z, p1.z_);
-            min_z = std::min(min_z, p2.z_);
-            double max_z = p0.z_;
-            max_z = std::max(max_z, p1.z_);
-            max_z = std::max(max_z, p2.z_);
-
-            // calculate the angle of this triangle in the z direction
-            const Point3D n = (p1 - p0).cross(p2 - p0);
-            const Point3D normal = n.normalized();
-            AngleRadians z_angle = std::acos(std::abs(normal.z_));
-
-            // prevent flat surfaces from influencing the algorithm
-            if (z_angle == 0)
+        // Every face is independent, so they are computed in parallel, each into its own place after the faces of the previous meshes.
+        const CompactMesh& geometry = mesh_geometries[mesh_idx];
+        const size_t first_face = face_slopes_.size();
+        face_min_z_values_.resize(first_face + geometry.faceCount());
+        face_max_z_values_.resize(first_face + geometry.faceCount());
+        face_slopes_.resize(first_face + geometry.faceCount());
+        cura::parallel_for<size_t>(
+            0,
+            geometry.faceCount(),
+            [&](const size_t face_idx)
             {
-                z_angle = std::numbers::pi;
-            }
+                const Point3D p0 = geometry.faceVertex(face_idx, 0);
+                const Point3D p1 = geometry.faceVertex(face_idx, 1);
+                const Point3D p2 = geometry.faceVertex(face_idx, 2);
 
-            face_min_z_values_.push_back(MM2INT(min_z));
-            face_max_z_values_.push_back(MM2INT(max_z));
-            face_slopes_.push_back(z_angle);
-        }
+                double min_z = p0.z_;
+                min_z = std::min(min_z, p1.z_);
+                min_z = std::min(min_z, p2.z_);
+                double max_z = p0.z_;
+                max_z = std::max(max_z, p1.z_);
+                max_z = std::max(max_z, p2.z_);
+
+                // calculate the angle of this triangle in the z direction
+                const Point3D n = (p1 - p0).cross(p2 - p0);
+                const Point3D normal = n.normalized();
+                AngleRadians z_angle = std::acos(std::abs(normal.z_));
+
+                // prevent flat surfaces from influencing the algorithm
+                if (z_angle == 0)
+                {
+                    z_angle = std::numbers::pi;
+                }
+
+                face_min_z_values_[first_face + face_idx] = MM2INT(min_z);
+                face_max_z_values_[first_face + face_idx] = MM2INT(max_z);
+                face_slopes_[first_face + face_idx] = z_angle;
+            });
     }
 }
 
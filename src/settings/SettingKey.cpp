@@ -0,0 +1,105 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "settings/SettingKey.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace cura
+{
+
+namespace
+{
+
+/*!
+ * The process-wide table of interned setting names.
+ */
+struct SettingNameTable
+{
+    std::shared_mutex mutex;
+    std::deque<std::string> names; //!< Indexed by key id. A deque never moves its elements, so references stay valid.
+    std::unordered_map<std::string_view, size_t> ids; //!< Views into names.
+};
+
+SettingNameTable& settingNameTable()
+{
+    static SettingNameTable table;
+    return table;
+}
+
+} // namespace
+
+SettingKey::SettingKey(std::string_view name)
+{
+    // Each thread remembers the keys it has seen, so the shared table is only locked for new names.
+    thread_local std::unordered_map<std::string_view, SettingKey> known_keys;
+
+    const auto known = known_keys.find(name);
+    if (known != known_keys.end())
+    {
+        *this = known->second;
+        return;
+    }
+
+    SettingNameTable& table = settingNameTable();
+    bool found = false;
+    {
+        std::shared_lock lock(table.mutex);
+        const auto it = table.ids.find(name);
+        if (it != table.ids.end())
+        {
+            id_ = it->second;
+            name_ = &table.names[id_];
+            found = true;
+        }
+    }
+    if (! found)
+    {
+        std::unique_lock lock(table.mutex);
+        const auto it = table.ids.find(name); // May have been added between the two locks.
+        if (it != table.ids.end())
+        {
+            id_ = it->second;
+        }
+        else
+        {
+            id_ = table.names.size();
+            table.names.emplace_back(name);
+            table.ids.emplace(table.names.back(), id_);
+        }
+        name_ = &table.names[id_];
+    }
+
+    known_keys.emplace(*name_, *this);
+}
+
+SettingKey SettingKey::fromLiteral(const char* name, const size_t capacity)
+{
+    struct RecentLiteral
+    {
+        const char* address = nullptr;
+        size_t id = 0;
+        const std::string* name = nullptr;
+    };
+    constexpr size_t recent_literal_count = 256;
+    thread_local std::array<RecentLiteral, recent_literal_count> recent_literals;
+
+    const size_t length = std::find(name, name + capacity, '\0') - name;
+    RecentLiteral& recent = recent_literals[reinterpret_cast<uintptr_t>(name) % recent_literal_count];
+    if (recent.address == name && recent.name->size() == length && std::memcmp(recent.name->data(), name, length) == 0)
+    {
+        return SettingKey(recent.id, recent.name);
+    }
+
+    const SettingKey key(std::string_view(name, length));
+    recent = RecentLiteral{ name, key.id_, key.name_ };
+    return key;
+}
+
+} // namespace cura
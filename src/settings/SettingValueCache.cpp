@@ -0,0 +1,63 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "settings/SettingValueCache.h"
+
+namespace cura
+{
+
+std::atomic<uint64_t> SettingValueCache::generation_{ 1 };
+
+SettingValueCache::SettingValueCache(const SettingValueCache&) noexcept
+{
+}
+
+SettingValueCache& SettingValueCache::operator=(const SettingValueCache&) noexcept
+{
+    invalidateAll();
+    return *this;
+}
+
+SettingValueCache::~SettingValueCache()
+{
+    for (std::atomic<Chunk*>& chunk : chunks_)
+    {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+void SettingValueCache::invalidateAll()
+{
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint32_t SettingValueCache::nextTypeId()
+{
+    static std::atomic<uint32_t> next_type_id{ 1 }; // Zero is never used, so an unwritten slot never matches.
+    return next_type_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+SettingValueCache::Slot* SettingValueCache::getSlot(const size_t key_id, const uint32_t type_id)
+{
+    if (key_id >= chunk_keys * max_chunks || type_id > max_type_id)
+    {
+        return nullptr;
+    }
+    std::atomic<Chunk*>& chunk_ptr = chunks_[key_id / chunk_keys];
+    Chunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (chunk == nullptr)
+    {
+        Chunk* new_chunk = new Chunk();
+        if (chunk_ptr.compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            chunk = new_chunk;
+        }
+        else // Another thread allocated it first. The CAS loaded its chunk.
+        {
+            delete new_chunk;
+        }
+    }
+    return &chunk->slots[(key_id % chunk_keys) * ways + type_id % ways];
+}
+
+} // namespace cura
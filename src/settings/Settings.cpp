@@ -51,10 +51,11 @@ void Settings::add(const std::string& key, const std::string value)
     {
         settings.emplace(key, value);
     }
+    invalidateCachedValues();
 }
 
 template<>
-std::string Settings::get<std::string>(const std::string& key) const
+std::string Settings::getUncached<std::string>(const std::string& key) const
 {
     // If this settings base has a setting value for it, look that up.
     if (settings.find(key) != settings.end())
@@ -78,25 +79,25 @@ std::string Settings::get<std::string>(const std::string& key) const
 }
 
 template<>
-double Settings::get<double>(const std::string& key) const
+double Settings::getUncached<double>(const std::string& key) const
 {
     return atof(get<std::string>(key).c_str());
 }
 
 template<>
-size_t Settings::get<size_t>(const std::string& key) const
+size_t Settings::getUncached<size_t>(const std::string& key) const
 {
     return std::stoul(get<std::string>(key).c_str());
 }
 
 template<>
-int Settings::get<int>(const std::string& key) const
+int Settings::getUncached<int>(const std::string& key) const
 {
     return atoi(get<std::string>(key).c_str());
 }
 
 template<>
-bool Settings::get<bool>(const std::string& key) const
+bool Settings::getUncached<bool>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     if (value == "on" || value == "yes" || value == "true" || value == "True")
@@ -108,7 +109,7 @@ bool Settings::get<bool>(const std::string& key) const
 }
 
 template<>
-ExtruderTrain& Settings::get<ExtruderTrain&>(const std::string& key) const
+ExtruderTrain& Settings::getUncached<ExtruderTrain&>(const std::string& key) const
 {
     int extruder_nr = std::atoi(get<std::string>(key).c_str());
     if (extruder_nr < 0)
@@ -119,7 +120,7 @@ ExtruderTrain& Settings::get<ExtruderTrain&>(const std::string& key) const
 }
 
 template<>
-std::vector<ExtruderTrain*> Settings::get<std::vector<ExtruderTrain*>>(const std::string& key) const
+std::vector<ExtruderTrain*> Settings::getUncached<std::vector<ExtruderTrain*>>(const std::string& key) const
 {
     int extruder_nr = std::atoi(get<std::string>(key).c_str());
     std::vector<ExtruderTrain*> ret;
@@ -138,62 +139,62 @@ std::vector<ExtruderTrain*> Settings::get<std::vector<ExtruderTrain*>>(const std
 }
 
 template<>
-LayerIndex Settings::get<LayerIndex>(const std::string& key) const
+LayerIndex Settings::getUncached<LayerIndex>(const std::string& key) const
 {
     // For the user we display layer numbers starting from 1, but we start counting from 0. Still it may be negative for Raft layers.
     return std::atoi(get<std::string>(key).c_str()) - 1;
 }
 
 template<>
-coord_t Settings::get<coord_t>(const std::string& key) const
+coord_t Settings::getUncached<coord_t>(const std::string& key) const
 {
-    return MM2INT(get<double>(key)); // The settings are all in millimetres, but we need to interpret them as microns.
+    return MM2INT(getUncached<double>(key)); // The settings are all in millimetres, but we need to interpret them as microns.
 }
 
 template<>
-AngleRadians Settings::get<AngleRadians>(const std::string& key) const
+AngleRadians Settings::getUncached<AngleRadians>(const std::string& key) const
 {
-    return get<double>(key) * std::numbers::pi / 180; // The settings are all in degrees, but we need to interpret them as radians.
+    return getUncached<double>(key) * std::numbers::pi / 180; // The settings are all in degrees, but we need to interpret them as radians.
 }
 
 template<>
-AngleDegrees Settings::get<AngleDegrees>(const std::string& key) const
+AngleDegrees Settings::getUncached<AngleDegrees>(const std::string& key) const
 {
-    return get<double>(key);
+    return getUncached<double>(key);
 }
 
 template<>
-Temperature Settings::get<Temperature>(const std::string& key) const
+Temperature Settings::getUncached<Temperature>(const std::string& key) const
 {
-    return get<double>(key);
+    return getUncached<double>(key);
 }
 
 template<>
-Velocity Settings::get<Velocity>(const std::string& key) const
+Velocity Settings::getUncached<Velocity>(const std::string& key) const
 {
-    return get<double>(key);
+    return getUncached<double>(key);
 }
 
 template<>
-Acceleration Settings::get<Acceleration>(const std::string& key) const
+Acceleration Settings::getUncached<Acceleration>(const std::string& key) const
 {
-    return get<double>(key);
+    return getUncached<double>(key);
 }
 
 template<>
-Ratio Settings::get<Ratio>(const std::string& key) const
+Ratio Settings::getUncached<Ratio>(const std::string& key) const
 {
-    return get<double>(key) / 100.0; // The settings are all in percentages, but we need to interpret them as radians.
+    return getUncached<double>(key) / 100.0; // The settings are all in percentages, but we need to interpret them as radians.
 }
 
 template<>
-Duration Settings::get<Duration>(const std::string& key) const
+Duration Settings::getUncached<Duration>(const std::string& key) const
 {
-    return get<double>(key);
+    return getUncached<double>(key);
 }
 
 template<>
-DraftShieldHeightLimitation Settings::get<DraftShieldHeightLimitation>(const std::string& key) const
+DraftShieldHeightLimitation Settings::getUncached<DraftShieldHeightLimitation>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -211,7 +212,7 @@ DraftShieldHeightLimitation Settings::get<DraftShieldHeightLimitation>(const std
 }
 
 template<>
-FlowTempGraph Settings::get<FlowTempGraph>(const std::string& key) const
+FlowTempGraph Settings::getUncached<FlowTempGraph>(const std::string& key) const
 {
     std::string value_string = get<std::string>(key);
 
@@ -259,7 +260,7 @@ FlowTempGraph Settings::get<FlowTempGraph>(const std::string& key) const
 }
 
 template<>
-Shape Settings::get<Shape>(const std::string& key) const
+Shape Settings::getUncached<Shape>(const std::string& key) const
 {
     std::string value_string = get<std::string>(key);
 
@@ -320,7 +321,7 @@ Shape Settings::get<Shape>(const std::string& key) const
 }
 
 template<>
-Matrix4x3D Settings::get<Matrix4x3D>(const std::string& key) const
+Matrix4x3D Settings::getUncached<Matrix4x3D>(const std::string& key) const
 {
     const std::string value_string = get<std::string>(key);
 
@@ -361,7 +362,7 @@ Matrix4x3D Settings::get<Matrix4x3D>(const std::string& key) const
 }
 
 template<>
-EGCodeFlavor Settings::get<EGCodeFlavor>(const std::string& key) const
+EGCodeFlavor Settings::getUncached<EGCodeFlavor>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -393,7 +394,7 @@ EGCodeFlavor Settings::get<EGCodeFlavor>(const std::string& key) const
 }
 
 template<>
-EFillMethod Settings::get<EFillMethod>(const std::string& key) const
+EFillMethod Settings::getUncached<EFillMethod>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -437,7 +438,7 @@ EFillMethod Settings::get<EFillMethod>(const std::string& key) const
 }
 
 template<>
-EPlatformAdhesion Settings::get<EPlatformAdhesion>(const std::string& key) const
+EPlatformAdhesion Settings::getUncached<EPlatformAdhesion>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -459,7 +460,7 @@ EPlatformAdhesion Settings::get<EPlatformAdhesion>(const std::string& key) const
 }
 
 template<>
-ESupportType Settings::get<ESupportType>(const std::string& key) const
+ESupportType Settings::getUncached<ESupportType>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -479,7 +480,7 @@ ESupportType Settings::get<ESupportType>(const std::string& key) const
 }
 
 template<>
-ESupportStructure Settings::get<ESupportStructure>(const std::string& key) const
+ESupportStructure Settings::getUncached<ESupportStructure>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -498,7 +499,7 @@ ESupportStructure Settings::get<ESupportStructure>(const std::string& key) const
 
 
 template<>
-EZSeamType Settings::get<EZSeamType>(const std::string& key) const
+EZSeamType Settings::getUncached<EZSeamType>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -520,7 +521,7 @@ EZSeamType Settings::get<EZSeamType>(const std::string& key) const
 }
 
 template<>
-EZSeamCornerPrefType Settings::get<EZSeamCornerPrefType>(const std::string& key) const
+EZSeamCornerPrefType Settings::getUncached<EZSeamCornerPrefType>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -544,7 +545,7 @@ EZSeamCornerPrefType Settings::get<EZSeamCornerPrefType>(const std::string& key)
 }
 
 template<>
-ESurfaceMode Settings::get<ESurfaceMode>(const std::string& key) const
+ESurfaceMode Settings::getUncached<ESurfaceMode>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -564,7 +565,7 @@ ESurfaceMode Settings::get<ESurfaceMode>(const std::string& key) const
 }
 
 template<>
-FillPerimeterGapMode Settings::get<FillPerimeterGapMode>(const std::string& key) const
+FillPerimeterGapMode Settings::getUncached<FillPerimeterGapMode>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -582,7 +583,7 @@ FillPerimeterGapMode Settings::get<FillPerimeterGapMode>(const std::string& key)
 }
 
 template<>
-BuildPlateShape Settings::get<BuildPlateShape>(const std::string& key) const
+BuildPlateShape Settings::getUncached<BuildPlateShape>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -600,7 +601,7 @@ BuildPlateShape Settings::get<BuildPlateShape>(const std::string& key) const
 }
 
 template<>
-CombingMode Settings::get<CombingMode>(const std::string& key) const
+CombingMode Settings::getUncached<CombingMode>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -624,7 +625,7 @@ CombingMode Settings::get<CombingMode>(const std::string& key) const
 }
 
 template<>
-SupportDistPriority Settings::get<SupportDistPriority>(const std::string& key) const
+SupportDistPriority Settings::getUncached<SupportDistPriority>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -642,7 +643,7 @@ SupportDistPriority Settings::get<SupportDistPriority>(const std::string& key) c
 }
 
 template<>
-SlicingTolerance Settings::get<SlicingTolerance>(const std::string& key) const
+SlicingTolerance Settings::getUncached<SlicingTolerance>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -662,7 +663,7 @@ SlicingTolerance Settings::get<SlicingTolerance>(const std::string& key) const
 }
 
 template<>
-InsetDirection Settings::get<InsetDirection>(const std::string& key) const
+InsetDirection Settings::getUncached<InsetDirection>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     using namespace cura::utils;
@@ -680,7 +681,7 @@ InsetDirection Settings::get<InsetDirection>(const std::string& key) const
 }
 
 template<>
-PrimeTowerMethod Settings::get<PrimeTowerMethod>(const std::string& key) const
+PrimeTowerMethod Settings::getUncached<PrimeTowerMethod>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     if (value == "interleaved")
@@ -692,7 +693,7 @@ PrimeTowerMethod Settings::get<PrimeTowerMethod>(const std::string& key) const
 }
 
 template<>
-BrimLocation Settings::get<BrimLocation>(const std::string& key) const
+BrimLocation Settings::getUncached<BrimLocation>(const std::string& key) const
 {
     const std::string& value = get<std::string>(key);
     if (value == "everywhere")
@@ -710,7 +711,7 @@ BrimLocation Settings::get<BrimLocation>(const std::string& key) const
 }
 
 template<>
-std::vector<double> Settings::get<std::vector<double>>(const std::string& key) const
+std::vector<double> Settings::getUncached<std::vector<double>>(const std::string& key) const
 {
     const std::string& value_string = get<std::string>(key);
 
@@ -752,7 +753,7 @@ std::vector<double> Settings::get<std::vector<double>>(const std::string& key) c
 }
 
 template<>
-std::vector<int> Settings::get<std::vector<int>>(const std::string& key) const
+std::vector<int> Settings::getUncached<std::vector<int>>(const std::string& key) const
 {
     std::vector<double> values_doubles = get<std::vector<double>>(key);
     std::vector<int> values_ints;
@@ -765,7 +766,7 @@ std::vector<int> Settings::get<std::vector<int>>(const std::string& key) const
 }
 
 template<>
-std::vector<AngleDegrees> Settings::get<std::vector<AngleDegrees>>(const std::string& key) const
+std::vector<AngleDegrees> Settings::getUncached<std::vector<AngleDegrees>>(const std::string& key) const
 {
     std::vector<double> values_doubles = get<std::vector<double>>(key);
     return std::vector<AngleDegrees>(values_doubles.begin(), values_doubles.end()); // Cast them to AngleDegrees.
@@ -791,6 +792,12 @@ bool Settings::has(const std::string& key) const
 void Settings::setParent(Settings* new_parent)
 {
     parent = new_parent;
+    invalidateCachedValues();
+}
+
+void Settings::invalidateCachedValues()
+{
+    SettingValueCache::invalidateAll();
 }
 
 std::string Settings::getWithoutLimiting(const std::string& key) const
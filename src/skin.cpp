@@ -14,7 +14,9 @@
 #include "settings/types/Angle.h" //For the infill support angle.
 #include "settings/types/Ratio.h"
 #include "sliceDataStorage.h"
+#include "utils/LayerWindowIntersection.h"
 #include "utils/Simplify.h"
+#include "utils/ThreadPool.h"
 #include "utils/math.h"
 #include "utils/polygonUtils.h"
 
@@ -34,7 +36,7 @@ coord_t SkinInfillAreaComputation::getSkinLineWidth(const SliceMeshStorage& mesh
     return skin_line_width;
 }
 
-SkinInfillAreaComputation::SkinInfillAreaComputation(const LayerIndex& layer_nr, SliceMeshStorage& mesh, bool process_infill)
+SkinInfillAreaComputation::SkinInfillAreaComputation(const LayerIndex& layer_nr, SliceMeshStorage& mesh, bool process_infill, const SkinSolidAreas* solid_areas)
     : layer_nr_(layer_nr)
     , mesh_(mesh)
     , bottom_layer_count_(mesh.settings.get<size_t>("bottom_layers"))
@@ -43,6 +45,7 @@ SkinInfillAreaComputation::SkinInfillAreaComputation(const LayerIndex& layer_nr,
     , skin_line_width_(getSkinLineWidth(mesh, layer_nr))
     , no_small_gaps_heuristic_(mesh.settings.get<bool>("skin_no_small_gaps_heuristic"))
     , process_infill_(process_infill)
+    , solid_areas_(solid_areas)
     , top_skin_preshrink_(mesh.settings.get<coord_t>("top_skin_preshrink"))
     , bottom_skin_preshrink_(mesh.settings.get<coord_t>("bottom_skin_preshrink"))
     , top_skin_expand_distance_(mesh.settings.get<coord_t>("top_skin_expand_distance"))
@@ -50,6 +53,80 @@ SkinInfillAreaComputation::SkinInfillAreaComputation(const LayerIndex& layer_nr,
 {
 }
 
+SkinSolidAreas SkinInfillAreaComputation::computeSolidAreas(const SliceMeshStorage& mesh)
+{
+    SkinSolidAreas solid_areas;
+    const size_t top_layer_count = mesh.settings.get<size_t>("top_layers");
+    const size_t bottom_layer_count = mesh.settings.get<size_t>("bottom_layers");
+    if (mesh.settings.get<bool>("skin_no_small_gaps_heuristic") || (top_layer_count < 2 && bottom_layer_count < 2))
+    {
+        return solid_areas; // Each part only needs to look at a single other layer.
+    }
+
+    // Using the outlines of all parts rather than only those near a part doesn't change its skin: any solid area that touches a part can only
+    // consist of parts that are near it.
+    const size_t layer_count = mesh.layers.size();
+    if (layer_count == 0)
+    {
+        return solid_areas; // There are no layers to compute skin for.
+    }
+    std::vector<Shape> layer_outlines(layer_count);
+    for (size_t layer_nr = 0; layer_nr < layer_count; ++layer_nr)
+    {
+        for (const SliceLayerPart& part : mesh.layers[layer_nr].parts)
+        {
+            layer_outlines[layer_nr].push_back(part.outline);
+        }
+    }
+
+    if (top_layer_count >= 2)
+    {
+        // The windows start at the layer itself, while the top skin looks at the layers above it.
+        solid_areas.above = intersectLayerWindows(layer_outlines, top_layer_count);
+        solid_areas.above.erase(solid_areas.above.begin());
+        solid_areas.above.emplace_back();
+    }
+    if (bottom_layer_count >= 2)
+    {
+        std::vector<Shape> windows = intersectLayerWindows(layer_outlines, bottom_layer_count);
+        solid_areas.below.resize(layer_count);
+        Shape solid_from_first_layer;
+        for (size_t layer_nr = 0; layer_nr < layer_count; ++layer_nr)
+        {
+            if (layer_nr >= bottom_layer_count)
+            {
+                solid_areas.below[layer_nr] = std::move(windows[layer_nr - bottom_layer_count]);
+            }
+            else if (layer_nr == 0)
+            {
+                solid_areas.below[layer_nr] = layer_outlines[0]; // Just like calculateBottomSkin, which looks at the layer itself here.
+            }
+            else
+            {
+                // Near the build plate there are fewer layers below to look at.
+                solid_from_first_layer = layer_nr == 1 ? layer_outlines[0] : solid_from_first_layer.intersection(layer_outlines[layer_nr - 1]);
+                solid_areas.below[layer_nr] = solid_from_first_layer;
+            }
+        }
+    }
+
+    const double min_infill_area = mesh.settings.get<double>("min_infill_area");
+    if (min_infill_area > 0.0)
+    {
+        for (std::vector<Shape>* areas : { &solid_areas.above, &solid_areas.below })
+        {
+            cura::parallel_for<size_t>(
+                0,
+                areas->size(),
+                [&](const size_t layer_nr)
+                {
+                    (*areas)[layer_nr].removeSmallAreas(min_infill_area);
+                });
+        }
+    }
+    return solid_areas;
+}
+
 /*
  * This function is executed in a parallel region based on layer_nr.
  * When modifying make sure any changes does not introduce data races.
@@ -182,6 +259,11 @@ void SkinInfillAreaComputation::calculateBottomSkin(const SliceLayerPart& part,
     {
         return; // don't subtract anything form the downskin
     }
+    if (solid_areas_ != nullptr && ! solid_areas_->below.empty())
+    {
+        downskin = downskin.difference(solid_areas_->below[layer_nr_]); // skin overlaps with the walls
+        return;
+    }
     LayerIndex bottom_check_start_layer_idx{ std::max(LayerIndex{ 0 }, LayerIndex{ layer_nr_ - bottom_layer_count_ }) };
     Shape not_air = getOutlineOnLayer(part, bottom_check_start_layer_idx);
     if (! no_small_gaps_heuristic_)
@@ -208,6 +290,12 @@ void SkinInfillAreaComputation::calculateTopSkin(const SliceLayerPart& part, Sha
         return;
     }
 
+    if (solid_areas_ != nullptr && ! solid_areas_->above.empty())
+    {
+        upskin = upskin.difference(solid_areas_->above[layer_nr_]); // skin overlaps with the walls
+        return;
+    }
+
     Shape not_air = getOutlineOnLayer(part, layer_nr_ + top_layer_count_);
     if (! no_small_gaps_heuristic_)
     {
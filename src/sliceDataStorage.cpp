@@ -275,6 +275,50 @@ Shape SliceDataStorage::getLayerOutlines(
     const bool external_polys_only,
     const int extruder_nr,
     const bool include_models) const
+{
+    const LayerOutlinesKey key{ layer_nr, include_support, include_prime_tower, external_polys_only, extruder_nr, include_models };
+    {
+        std::lock_guard<std::mutex> lock(layer_outlines_mutex_);
+        if (const std::shared_ptr<const Shape>* found = layer_outlines_cache_.find(key))
+        {
+            layer_outlines_hits_.fetch_add(1, std::memory_order_relaxed);
+            return **found;
+        }
+    }
+
+    // Compute outside of the lock, so that other layers can be processed meanwhile.
+    layer_outlines_misses_.fetch_add(1, std::memory_order_relaxed);
+    auto outlines = std::make_shared<const Shape>(computeLayerOutlines(layer_nr, include_support, include_prime_tower, external_polys_only, extruder_nr, include_models));
+    {
+        std::lock_guard<std::mutex> lock(layer_outlines_mutex_);
+        layer_outlines_cache_.insert(key, outlines);
+    }
+    return *outlines;
+}
+
+void SliceDataStorage::invalidateLayerOutlines()
+{
+    std::lock_guard<std::mutex> lock(layer_outlines_mutex_);
+    layer_outlines_cache_.clear();
+}
+
+size_t SliceDataStorage::getLayerOutlinesHits() const
+{
+    return layer_outlines_hits_.load(std::memory_order_relaxed);
+}
+
+size_t SliceDataStorage::getLayerOutlinesMisses() const
+{
+    return layer_outlines_misses_.load(std::memory_order_relaxed);
+}
+
+Shape SliceDataStorage::computeLayerOutlines(
+    const LayerIndex layer_nr,
+    const bool include_support,
+    const bool include_prime_tower,
+    const bool external_polys_only,
+    const int extruder_nr,
+    const bool include_models) const
 {
     const Settings& mesh_group_settings = Application::getInstance().current_slice_->scene.current_mesh_group->settings;
 
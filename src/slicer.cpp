@@ -11,6 +11,7 @@
 #include <spdlog/spdlog.h>
 
 #include "Application.h"
+#include "CompactMesh.h"
 #include "Slice.h"
 #include "geometry/OpenPolyline.h"
 #include "plugins/slots.h"
@@ -96,7 +97,7 @@ int SlicerLayer::getNextSegmentIdx(const SlicerSegment& segment, const size_t st
 {
     int next_segment_idx = -1;
 
-    const bool segment_ended_at_edge = segment.endVertex == nullptr;
+    const bool segment_ended_at_edge = segment.endVertexFaces.empty();
     if (segment_ended_at_edge)
     {
         const int face_to_try = segment.endOtherFaceIdx;
@@ -110,8 +111,7 @@ int SlicerLayer::getNextSegmentIdx(const SlicerSegment& segment, const size_t st
     {
         // segment ended at vertex
 
-        const std::vector<uint32_t>& faces_to_try = segment.endVertex->connected_faces_;
-        for (int face_to_try : faces_to_try)
+        for (int face_to_try : segment.endVertexFaces)
         {
             const int result_segment_idx = tryFaceNextSegmentIdx(segment, face_to_try, start_segment_idx);
             if (result_segment_idx == static_cast<int>(start_segment_idx))
@@ -798,6 +798,17 @@ void SlicerLayer::makePolygons(const Mesh* mesh)
 }
 
 Slicer::Slicer(Mesh* i_mesh, const coord_t thickness, const size_t slice_layer_count, bool use_variable_layer_heights, std::vector<AdaptiveLayer>* adaptive_layers)
+    : Slicer(i_mesh, CompactMesh(*i_mesh), thickness, slice_layer_count, use_variable_layer_heights, adaptive_layers)
+{
+}
+
+Slicer::Slicer(
+    Mesh* i_mesh,
+    const CompactMesh& geometry,
+    const coord_t thickness,
+    const size_t slice_layer_count,
+    bool use_variable_layer_heights,
+    std::vector<AdaptiveLayer>* adaptive_layers)
     : mesh(i_mesh)
 {
     const SlicingTolerance slicing_tolerance = mesh->settings_.get<SlicingTolerance>("slicing_tolerance");
@@ -820,9 +831,11 @@ Slicer::Slicer(Mesh* i_mesh, const coord_t thickness, const size_t slice_layer_c
         mesh->settings_.get<coord_t>("layer_0_z_overlap"),
         Raft::getFillerLayerCount());
 
-    std::vector<std::pair<int32_t, int32_t>> zbbox = buildZHeightsForFaces(*mesh);
+    std::vector<std::pair<int32_t, int32_t>> zbbox = buildZHeightsForFaces(geometry);
+
+    const LayerFaceIndex layer_faces = buildLayerFaceIndex(zbbox, layers);
 
-    buildSegments(*mesh, zbbox, slicing_tolerance, layers);
+    buildSegments(geometry, layer_faces, slicing_tolerance, layers);
 
     spdlog::info("Slice of mesh took {:03.3f} seconds", slice_timer.restart());
 
@@ -831,34 +844,97 @@ Slicer::Slicer(Mesh* i_mesh, const coord_t thickness, const size_t slice_layer_c
     spdlog::info("Make polygons took {:03.3f} seconds", slice_timer.restart());
 }
 
-void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t, int32_t>>& zbbox, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
+Slicer::LayerFaceIndex Slicer::buildLayerFaceIndex(const std::vector<std::pair<int32_t, int32_t>>& zbboxes, const std::vector<SlicerLayer>& layers)
 {
-    cura::parallel_for(
-        layers,
-        [&](auto layer_it)
+    // Layer heights are normally increasing, but don't rely on it: search in a sorted copy and map back to the layer index.
+    std::vector<std::pair<int32_t, size_t>> sorted_layer_z;
+    sorted_layer_z.reserve(layers.size());
+    for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx)
+    {
+        sorted_layer_z.emplace_back(layers[layer_idx].z_, layer_idx);
+    }
+    std::sort(sorted_layer_z.begin(), sorted_layer_z.end());
+
+    // For every face, the [first, last) range in sorted_layer_z of the layers it spans, i.e. where min_z <= layer z <= max_z.
+    std::vector<std::pair<uint32_t, uint32_t>> face_ranges(zbboxes.size());
+    cura::parallel_for<size_t>(
+        0,
+        zbboxes.size(),
+        [&](size_t face_idx)
+        {
+            const auto& [min_z, max_z] = zbboxes[face_idx];
+            const auto first = std::lower_bound(
+                sorted_layer_z.begin(),
+                sorted_layer_z.end(),
+                min_z,
+                [](const std::pair<int32_t, size_t>& layer_z, const int32_t z)
+                {
+                    return layer_z.first < z;
+                });
+            const auto last = std::upper_bound(
+                first,
+                sorted_layer_z.end(),
+                max_z,
+                [](const int32_t z, const std::pair<int32_t, size_t>& layer_z)
+                {
+                    return z < layer_z.first;
+                });
+            face_ranges[face_idx] = std::make_pair(first - sorted_layer_z.begin(), last - sorted_layer_z.begin());
+        },
+        1024);
+
+    // Count the faces per layer, then turn the counts into offsets.
+    LayerFaceIndex index;
+    index.layer_offsets.assign(layers.size() + 1, 0);
+    for (const auto& [first, last] : face_ranges)
+    {
+        for (uint32_t sorted_idx = first; sorted_idx < last; ++sorted_idx)
+        {
+            ++index.layer_offsets[sorted_layer_z[sorted_idx].second + 1];
+        }
+    }
+    for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx)
+    {
+        index.layer_offsets[layer_idx + 1] += index.layer_offsets[layer_idx];
+    }
+
+    // Fill in face order, so that each layer lists its faces (and thus creates its segments) in the same order as a full scan would.
+    index.face_indices.resize(index.layer_offsets.back());
+    std::vector<size_t> fill_position(index.layer_offsets.begin(), index.layer_offsets.end() - 1);
+    for (uint32_t face_idx = 0; face_idx < face_ranges.size(); ++face_idx)
+    {
+        const auto& [first, last] = face_ranges[face_idx];
+        for (uint32_t sorted_idx = first; sorted_idx < last; ++sorted_idx)
         {
-            SlicerLayer& layer = *layer_it;
+            index.face_indices[fill_position[sorted_layer_z[sorted_idx].second]++] = face_idx;
+        }
+    }
+
+    return index;
+}
+
+void Slicer::buildSegments(const CompactMesh& geometry, const LayerFaceIndex& layer_faces, const SlicingTolerance& slicing_tolerance, std::vector<SlicerLayer>& layers)
+{
+    cura::parallel_for<size_t>(
+        0,
+        layers.size(),
+        [&](size_t layer_idx)
+        {
+            SlicerLayer& layer = layers[layer_idx];
             const int32_t& z = layer.z_;
-            layer.segments_.reserve(100);
+            const size_t faces_begin = layer_faces.layer_offsets[layer_idx];
+            const size_t faces_end = layer_faces.layer_offsets[layer_idx + 1];
+            layer.segments_.reserve(faces_end - faces_begin);
 
-            // loop over all mesh faces
-            for (unsigned int mesh_idx = 0; mesh_idx < mesh.faces_.size(); mesh_idx++)
+            // loop over the mesh faces that span this layer
+            for (size_t face_list_idx = faces_begin; face_list_idx < faces_end; face_list_idx++)
             {
-                if ((z < zbbox[mesh_idx].first) || (z > zbbox[mesh_idx].second))
-                {
-                    continue;
-                }
+                const unsigned int mesh_idx = layer_faces.face_indices[face_list_idx];
 
-                // get all vertices per face
-                const MeshFace& face = mesh.faces_[mesh_idx];
-                const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-                const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-                const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
-
-                // get all vertices represented as 3D point
-                Point3LL p0 = v0.p_;
-                Point3LL p1 = v1.p_;
-                Point3LL p2 = v2.p_;
+                // get all vertices per face, represented as 3D point
+                Point3LL p0 = geometry.faceVertex(mesh_idx, 0);
+                Point3LL p1 = geometry.faceVertex(mesh_idx, 1);
+                Point3LL p2 = geometry.faceVertex(mesh_idx, 2);
 
                 // Compensate for points exactly on the slice-boundary, except for 'inclusive', which already handles this correctly.
                 if (slicing_tolerance != SlicingTolerance::INCLUSIVE)
@@ -869,7 +945,6 @@ void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t
                 }
 
                 SlicerSegment s;
-                s.endVertex = nullptr;
                 int end_edge_idx = -1;
 
                 /*
@@ -911,7 +986,7 @@ void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t
                     end_edge_idx = 2; //   /     \    .
                     if (p2.z_ == z) //  1_______2
                     {
-                        s.endVertex = &v2;
+                        s.endVertexFaces = geometry.connectedFaces(geometry.faceVertexIndex(mesh_idx, 2));
                     }
                 }
 
@@ -927,7 +1002,7 @@ void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t
                     end_edge_idx = 0; //   /     \    .
                     if (p0.z_ == z) //  0_______2
                     {
-                        s.endVertex = &v0;
+                        s.endVertexFaces = geometry.connectedFaces(geometry.faceVertexIndex(mesh_idx, 0));
                     }
                 }
 
@@ -943,7 +1018,7 @@ void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t
                     end_edge_idx = 1; //   /     \    .
                     if (p1.z_ == z) //  0_______1
                     {
-                        s.endVertex = &v1;
+                        s.endVertexFaces = geometry.connectedFaces(geometry.faceVertexIndex(mesh_idx, 1));
                     }
                 }
                 else
@@ -956,7 +1031,7 @@ void Slicer::buildSegments(const Mesh& mesh, const std::vector<std::pair<int32_t
                 // store the segments per layer
                 layer.face_idx_to_segment_idx_.insert(std::make_pair(mesh_idx, layer.segments_.size()));
                 s.faceIndex = mesh_idx;
-                s.endOtherFaceIdx = face.connected_face_index_[end_edge_idx];
+                s.endOtherFaceIdx = geometry.connectedFace(mesh_idx, end_edge_idx);
                 s.addedToPolygon = false;
                 layer.segments_.push_back(s);
             }
@@ -1104,41 +1179,36 @@ void Slicer::makePolygons(Mesh& mesh, SlicingTolerance slicing_tolerance, std::v
 }
 
 
-std::vector<std::pair<int32_t, int32_t>> Slicer::buildZHeightsForFaces(const Mesh& mesh)
+std::vector<std::pair<int32_t, int32_t>> Slicer::buildZHeightsForFaces(const CompactMesh& geometry)
 {
     std::vector<std::pair<int32_t, int32_t>> zHeights;
-    zHeights.reserve(mesh.faces_.size());
-    for (const auto& face : mesh.faces_)
+    zHeights.reserve(geometry.faceCount());
+    for (size_t face_idx = 0; face_idx < geometry.faceCount(); ++face_idx)
     {
-        // const MeshFace& face = mesh.faces[mesh_idx];
-        const MeshVertex& v0 = mesh.vertices_[face.vertex_index_[0]];
-        const MeshVertex& v1 = mesh.vertices_[face.vertex_index_[1]];
-        const MeshVertex& v2 = mesh.vertices_[face.vertex_index_[2]];
-
-        // get all vertices represented as 3D point
-        Point3LL p0 = v0.p_;
-        Point3LL p1 = v1.p_;
-        Point3LL p2 = v2.p_;
+        // only the heights of the vertices are needed
+        const coord_t z0 = geometry.vertexZ(geometry.faceVertexIndex(face_idx, 0));
+        const coord_t z1 = geometry.vertexZ(geometry.faceVertexIndex(face_idx, 1));
+        const coord_t z2 = geometry.vertexZ(geometry.faceVertexIndex(face_idx, 2));
 
         // find the minimum and maximum z point
-        int32_t minZ = p0.z_;
-        if (p1.z_ < minZ)
+        int32_t minZ = z0;
+        if (z1 < minZ)
         {
-            minZ = p1.z_;
+            minZ = z1;
         }
-        if (p2.z_ < minZ)
+        if (z2 < minZ)
         {
-            minZ = p2.z_;
+            minZ = z2;
         }
 
-        int32_t maxZ = p0.z_;
-        if (p1.z_ > maxZ)
+        int32_t maxZ = z0;
+        if (z1 > maxZ)
         {
-            maxZ = p1.z_;
+            maxZ = z1;
         }
-        if (p2.z_ > maxZ)
+        if (z2 > maxZ)
         {
-            maxZ = p2.z_;
+            maxZ = z2;
         }
 
         zHeights.emplace_back(std::make_pair(minZ, maxZ));
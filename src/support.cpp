@@ -563,7 +563,8 @@ Shape AreaSupport::join(const SliceDataStorage& storage, const Shape& supportLay
         const coord_t conical_smallest_breadth = infill_settings.get<coord_t>("support_conical_min_width");
         Shape insetted = supportLayer_up.offset(-conical_smallest_breadth / 2);
         Shape small_parts = supportLayer_up.difference(insetted.offset(conical_smallest_breadth / 2 + 20));
-        joined = supportLayer_this.unionPolygons(supportLayer_up.offset(conical_support_offset)).unionPolygons(small_parts).intersection(machine_volume_border);
+        const Shape support_up_offset = supportLayer_up.offset(conical_support_offset);
+        joined = Shape::unionAll({ &supportLayer_this, &support_up_offset, &small_parts }).intersection(machine_volume_border);
     }
     else
     {
@@ -0,0 +1,267 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/AreaSpillStore.h"
+
+#include <iterator>
+
+#include <spdlog/spdlog.h>
+
+#include "geometry/Polygon.h"
+
+namespace cura
+{
+
+namespace
+{
+
+/*!
+ * Seek with a 64-bit offset. A long is only 32 bits on Windows, which limits std::fseek to 2 GB.
+ */
+bool seekTo(std::FILE* file, const uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+void writeVarint(std::vector<uint8_t>& data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t readVarint(const std::vector<uint8_t>& data, size_t& position)
+{
+    uint64_t value = 0;
+    for (int shift = 0; position < data.size(); shift += 7)
+    {
+        const uint8_t byte = data[position++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (! (byte & 0x80))
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+// Zigzag encoding, so that small negative differences take few bytes as well.
+void writeSigned(std::vector<uint8_t>& data, const int64_t value)
+{
+    writeVarint(data, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+int64_t readSigned(const std::vector<uint8_t>& data, size_t& position)
+{
+    const uint64_t value = readVarint(data, position);
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace
+
+AreaSpillStore::AreaSpillStore(const bool to_file)
+{
+    if (to_file)
+    {
+        file_.reset(std::tmpfile());
+        if (! file_)
+        {
+            spdlog::warn("Could not create a temporary file to store areas in. Keeping them in memory instead.");
+        }
+    }
+}
+
+size_t AreaSpillStore::store(const Shape& area)
+{
+    std::vector<uint8_t> data = encode(area);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Record record{ {}, false, 0, data.size() };
+    if (file_)
+    {
+        const uint64_t offset = allocate(data.size());
+        if (seekTo(file_.get(), offset) && std::fwrite(data.data(), 1, data.size(), file_.get()) == data.size())
+        {
+            record.in_file = true;
+            record.offset = offset;
+        }
+        else
+        {
+            release(offset, data.size());
+        }
+    }
+    if (! record.in_file)
+    {
+        record.data = std::move(data);
+    }
+    bytes_ += record.size;
+    const size_t id = next_id_++;
+    records_.emplace(id, std::move(record));
+    return id;
+}
+
+Shape AreaSpillStore::load(const size_t id)
+{
+    std::vector<uint8_t> data;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = records_.find(id);
+        if (found == records_.end())
+        {
+            spdlog::error("Tried to load area {}, which isn't stored.", id);
+            return Shape();
+        }
+        Record& record = found->second;
+        if (! record.in_file)
+        {
+            data = std::move(record.data);
+        }
+        else
+        {
+            data.resize(record.size);
+            if (! seekTo(file_.get(), record.offset) || std::fread(data.data(), 1, data.size(), file_.get()) != data.size())
+            {
+                spdlog::error("Could not read area {} back from the temporary file.", id);
+                data.clear();
+            }
+            release(record.offset, record.size);
+        }
+        bytes_ -= record.size;
+        records_.erase(found);
+    }
+    return decode(data);
+}
+
+void AreaSpillStore::discard(const size_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = records_.find(id);
+    if (found != records_.end())
+    {
+        if (found->second.in_file)
+        {
+            release(found->second.offset, found->second.size);
+        }
+        bytes_ -= found->second.size;
+        records_.erase(found);
+    }
+}
+
+size_t AreaSpillStore::getBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+uint64_t AreaSpillStore::getFileSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_end_;
+}
+
+uint64_t AreaSpillStore::allocate(const size_t size)
+{
+    for (auto range = free_ranges_.begin(); range != free_ranges_.end(); ++range)
+    {
+        if (range->second < size)
+        {
+            continue;
+        }
+        const uint64_t offset = range->first;
+        const uint64_t remaining = range->second - size;
+        free_ranges_.erase(range);
+        if (remaining > 0)
+        {
+            free_ranges_.emplace(offset + size, remaining);
+        }
+        return offset;
+    }
+    const uint64_t offset = file_end_;
+    file_end_ += size;
+    return offset;
+}
+
+void AreaSpillStore::release(uint64_t offset, const size_t size)
+{
+    uint64_t end = offset + size;
+    // Merge with the free ranges right before and after, so that large areas can reuse the space of several small ones.
+    auto next = free_ranges_.lower_bound(offset);
+    if (next != free_ranges_.end() && next->first == end)
+    {
+        end += next->second;
+        next = free_ranges_.erase(next);
+    }
+    if (next != free_ranges_.begin())
+    {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            free_ranges_.erase(previous);
+        }
+    }
+    if (end == file_end_)
+    {
+        file_end_ = offset; // The end of the file is written over by the next area.
+    }
+    else
+    {
+        free_ranges_.emplace(offset, end - offset);
+    }
+}
+
+std::vector<uint8_t> AreaSpillStore::encode(const Shape& area)
+{
+    std::vector<uint8_t> data;
+    writeVarint(data, area.size());
+    Point2LL previous(0, 0);
+    for (const Polygon& polygon : area)
+    {
+        writeVarint(data, (polygon.size() << 1) | (polygon.isExplicitelyClosed() ? 1 : 0));
+        for (const Point2LL& point : polygon)
+        {
+            writeSigned(data, point.X - previous.X);
+            writeSigned(data, point.Y - previous.Y);
+            previous = point;
+        }
+    }
+    return data;
+}
+
+Shape AreaSpillStore::decode(const std::vector<uint8_t>& data)
+{
+    Shape area;
+    if (data.empty())
+    {
+        return area;
+    }
+    size_t position = 0;
+    const size_t polygon_count = readVarint(data, position);
+    area.reserve(polygon_count);
+    Point2LL previous(0, 0);
+    for (size_t polygon_idx = 0; polygon_idx < polygon_count; ++polygon_idx)
+    {
+        const uint64_t header = readVarint(data, position);
+        Polygon polygon(static_cast<bool>(header & 1));
+        const size_t point_count = header >> 1;
+        polygon.reserve(point_count);
+        for (size_t point_idx = 0; point_idx < point_count; ++point_idx)
+        {
+            const coord_t x = previous.X + readSigned(data, position);
+            const coord_t y = previous.Y + readSigned(data, position);
+            previous = Point2LL(x, y);
+            polygon.push_back(previous);
+        }
+        area.push_back(std::move(polygon));
+    }
+    return area;
+}
+
+} // namespace cura
@@ -0,0 +1,290 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/CompressedSink.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#ifdef ENABLE_GCODE_COMPRESSION
+#include <zlib.h>
+#include <zstd.h>
+#endif
+
+namespace cura
+{
+
+/*!
+ * The state of one of the compression libraries.
+ */
+class CompressedSink::Compressor
+{
+public:
+    virtual ~Compressor() = default;
+
+    /*!
+     * Compress data, writing the output to \p destination as far as it is available.
+     */
+    virtual void compress(const std::string_view data, GCodeSink& destination) = 0;
+
+    /*!
+     * Write all output for the data compressed so far to \p destination, without completing the member or frame.
+     */
+    virtual void flush(GCodeSink& destination) = 0;
+
+    /*!
+     * Complete the member or frame, writing all remaining output to \p destination.
+     */
+    virtual void end(GCodeSink& destination) = 0;
+
+    /*!
+     * Whether the compression library failed. The rest of the g-code is then dropped.
+     */
+    bool hasFailed() const
+    {
+        return failed_;
+    }
+
+protected:
+    static constexpr size_t output_chunk_size = 1 << 17;
+    std::vector<char> output_ = std::vector<char>(output_chunk_size); //!< Receives the compressed data before it is written to the destination.
+    bool failed_ = false; //!< Whether the compression library failed.
+};
+
+#ifdef ENABLE_GCODE_COMPRESSION
+
+class CompressedSink::GzipCompressor : public CompressedSink::Compressor
+{
+public:
+    GzipCompressor()
+    {
+        constexpr int gzip_window_bits = 15 + 16; // The largest window, with a gzip header and trailer rather than a zlib one.
+        constexpr int memory_level = 8;
+        const int result = deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzip_window_bits, memory_level, Z_DEFAULT_STRATEGY);
+        if (result != Z_OK)
+        {
+            spdlog::error("Failed to start gzip compression of the g-code: {}", stream_.msg != nullptr ? stream_.msg : std::to_string(result));
+            failed_ = true;
+        }
+    }
+
+    ~GzipCompressor() override
+    {
+        if (! failed_)
+        {
+            deflateEnd(&stream_);
+        }
+    }
+
+    void compress(const std::string_view data, GCodeSink& destination) override
+    {
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream_.avail_in = static_cast<uInt>(data.size());
+        deflateAll(Z_NO_FLUSH, destination);
+    }
+
+    void flush(GCodeSink& destination) override
+    {
+        stream_.next_in = nullptr;
+        stream_.avail_in = 0;
+        deflateAll(Z_SYNC_FLUSH, destination);
+    }
+
+    void end(GCodeSink& destination) override
+    {
+        stream_.next_in = nullptr;
+        stream_.avail_in = 0;
+        deflateAll(Z_FINISH, destination);
+    }
+
+private:
+    z_stream stream_{};
+
+    void deflateAll(const int flush_mode, GCodeSink& destination)
+    {
+        if (failed_)
+        {
+            return;
+        }
+        int result;
+        do
+        {
+            stream_.next_out = reinterpret_cast<Bytef*>(output_.data());
+            stream_.avail_out = static_cast<uInt>(output_.size());
+            result = deflate(&stream_, flush_mode);
+            if (result == Z_STREAM_ERROR)
+            {
+                spdlog::error("Failed to compress the g-code with gzip.");
+                failed_ = true;
+                return;
+            }
+            destination.write(std::string_view(output_.data(), output_.size() - stream_.avail_out));
+        } while (stream_.avail_in > 0 || stream_.avail_out == 0 || (flush_mode == Z_FINISH && result != Z_STREAM_END));
+    }
+};
+
+class CompressedSink::ZstdCompressor : public CompressedSink::Compressor
+{
+public:
+    ZstdCompressor()
+        : context_(ZSTD_createCCtx())
+    {
+        if (context_ == nullptr)
+        {
+            spdlog::error("Failed to start zstd compression of the g-code.");
+            failed_ = true;
+            return;
+        }
+        ZSTD_CCtx_setParameter(context_, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+    }
+
+    ~ZstdCompressor() override
+    {
+        ZSTD_freeCCtx(context_);
+    }
+
+    void compress(const std::string_view data, GCodeSink& destination) override
+    {
+        ZSTD_inBuffer input{ data.data(), data.size(), 0 };
+        while (! failed_ && input.pos < input.size)
+        {
+            compressStep(input, ZSTD_e_continue, destination);
+        }
+    }
+
+    void flush(GCodeSink& destination) override
+    {
+        ZSTD_inBuffer input{ nullptr, 0, 0 };
+        while (! failed_ && ! compressStep(input, ZSTD_e_flush, destination))
+        {
+        }
+    }
+
+    void end(GCodeSink& destination) override
+    {
+        ZSTD_inBuffer input{ nullptr, 0, 0 };
+        while (! failed_ && ! compressStep(input, ZSTD_e_end, destination))
+        {
+        }
+    }
+
+private:
+    ZSTD_CCtx* context_;
+
+    /*!
+     * Compress part of the input.
+     * \return Whether the compressor doesn't have any more output to write for a flush or end, or failed.
+     */
+    bool compressStep(ZSTD_inBuffer& input, const ZSTD_EndDirective directive, GCodeSink& destination)
+    {
+        if (failed_)
+        {
+            return true;
+        }
+        ZSTD_outBuffer output{ output_.data(), output_.size(), 0 };
+        const size_t remaining = ZSTD_compressStream2(context_, &output, &input, directive);
+        if (ZSTD_isError(remaining))
+        {
+            spdlog::error("Failed to compress the g-code with zstd: {}", ZSTD_getErrorName(remaining));
+            failed_ = true;
+            return true;
+        }
+        destination.write(std::string_view(output_.data(), output.pos));
+        return remaining == 0;
+    }
+};
+
+#endif // ENABLE_GCODE_COMPRESSION
+
+std::optional<CompressedSink::Format> CompressedSink::formatForFile(const std::string& filename)
+{
+    if (filename.ends_with(".gz"))
+    {
+        return Format::GZIP;
+    }
+    if (filename.ends_with(".zst"))
+    {
+        return Format::ZSTD;
+    }
+    return std::nullopt;
+}
+
+bool CompressedSink::isSupported([[maybe_unused]] const Format format)
+{
+#ifdef ENABLE_GCODE_COMPRESSION
+    return true;
+#else
+    return false;
+#endif
+}
+
+CompressedSink::CompressedSink([[maybe_unused]] const Format format, GCodeSink& destination)
+    : destination_(destination)
+{
+    assert(isSupported(format) && "Check whether the format is supported before compressing.");
+#ifdef ENABLE_GCODE_COMPRESSION
+    switch (format)
+    {
+    case Format::GZIP:
+        compressor_ = std::make_unique<GzipCompressor>();
+        break;
+    case Format::ZSTD:
+        compressor_ = std::make_unique<ZstdCompressor>();
+        break;
+    }
+#endif
+}
+
+CompressedSink::~CompressedSink()
+{
+    finish();
+}
+
+void CompressedSink::flush()
+{
+    if (compressor_ && has_unflushed_data_ && ! finished_)
+    {
+        compressor_->flush(destination_);
+        has_unflushed_data_ = false;
+    }
+    destination_.flush();
+}
+
+bool CompressedSink::finish()
+{
+    if (! finished_)
+    {
+        if (compressor_)
+        {
+            compressor_->end(destination_);
+        }
+        finished_ = true;
+        destination_.finish();
+    }
+    return ! hasFailed();
+}
+
+bool CompressedSink::hasFailed() const
+{
+    return GCodeSink::hasFailed() || (compressor_ && compressor_->hasFailed()) || destination_.hasFailed();
+}
+
+void CompressedSink::writeData(const std::string_view data)
+{
+    if (finished_)
+    {
+        spdlog::error("G-code was written after the compressed output was completed.");
+        markFailed();
+        return;
+    }
+    if (compressor_ && ! data.empty())
+    {
+        compressor_->compress(data, destination_);
+        has_unflushed_data_ = true;
+    }
+}
+
+} // namespace cura
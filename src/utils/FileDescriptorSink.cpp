@@ -0,0 +1,133 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/FileDescriptorSink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+namespace cura
+{
+
+FileDescriptorSink::FileDescriptorSink(const size_t buffer_size)
+    : buffer_(std::make_unique<char[]>(buffer_size))
+    , buffer_size_(buffer_size)
+{
+}
+
+FileDescriptorSink::~FileDescriptorSink()
+{
+    close();
+}
+
+bool FileDescriptorSink::open(const std::string& filename)
+{
+    close();
+#ifdef _WIN32
+    fd_ = ::_open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+#endif
+    return fd_ >= 0;
+}
+
+bool FileDescriptorSink::close()
+{
+    if (fd_ < 0)
+    {
+        return ! hasFailed();
+    }
+    flush();
+#ifdef _WIN32
+    const int result = ::_close(fd_);
+#else
+    const int result = ::close(fd_); // Some file systems only report write errors when closing.
+#endif
+    fd_ = -1;
+    if (result != 0)
+    {
+        spdlog::error("Failed to close the g-code file: {}", std::strerror(errno));
+        markFailed();
+    }
+    return ! hasFailed();
+}
+
+bool FileDescriptorSink::finish()
+{
+    return close();
+}
+
+void FileDescriptorSink::flush()
+{
+    writeToFile(buffer_.get(), buffered_);
+    buffered_ = 0;
+}
+
+void FileDescriptorSink::writeData(const std::string_view data)
+{
+    if (fd_ < 0)
+    {
+        writeToFile(data.data(), data.size()); // Reports the lost g-code, rather than keeping it in the buffer that is never written.
+        return;
+    }
+    if (buffered_ + data.size() <= buffer_size_)
+    {
+        std::memcpy(buffer_.get() + buffered_, data.data(), data.size());
+        buffered_ += data.size();
+        return;
+    }
+    flush();
+    if (data.size() >= buffer_size_)
+    { // Don't copy what fills the buffer on its own anyway.
+        writeToFile(data.data(), data.size());
+        return;
+    }
+    std::memcpy(buffer_.get(), data.data(), data.size());
+    buffered_ = data.size();
+}
+
+void FileDescriptorSink::writeToFile(const char* data, size_t size)
+{
+    if (size == 0 || hasFailed())
+    {
+        return;
+    }
+    if (fd_ < 0)
+    {
+        spdlog::error("G-code was written while no file was open, it is lost.");
+        markFailed();
+        return;
+    }
+    while (size > 0)
+    {
+#ifdef _WIN32
+        const auto written = ::_write(fd_, data, static_cast<unsigned int>(std::min<size_t>(size, 1u << 30)));
+#else
+        const auto written = ::write(fd_, data, size);
+#endif
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            spdlog::error("Failed to write g-code to file: {}", std::strerror(errno));
+            markFailed();
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace cura
@@ -0,0 +1,213 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/GCodeBuffer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace cura
+{
+
+GCodeBuffer::GCodeBuffer()
+    : stream_sink_(std::make_unique<StreamSink>(&std::cout))
+    , sink_(stream_sink_.get())
+{
+    fallback_stream_ << std::fixed;
+    line_.reserve(256);
+}
+
+void GCodeBuffer::setStream(std::ostream* stream)
+{
+    flush();
+    stream_sink_ = std::make_unique<StreamSink>(stream);
+    sink_ = stream_sink_.get();
+}
+
+void GCodeBuffer::setSink(GCodeSink* sink)
+{
+    flush();
+    sink_ = sink;
+    stream_sink_.reset();
+}
+
+void GCodeBuffer::startRecording()
+{
+    flush();
+    recording_ = true;
+}
+
+std::string GCodeBuffer::stopRecording()
+{
+    recording_ = false;
+    return std::exchange(recorded_, std::string());
+}
+
+std::string GCodeBuffer::render(const std::string_view recording)
+{
+    std::string text;
+    text.reserve(recording.size() * 2); // Formatted numbers mostly take more room than their recorded form.
+
+    size_t pos = 0;
+    const auto read = [&recording, &pos]<typename T>(T& value)
+    {
+        std::memcpy(&value, recording.data() + pos, sizeof(T));
+        pos += sizeof(T);
+    };
+    while (pos < recording.size())
+    {
+        const auto token = static_cast<Token>(recording[pos++]);
+        switch (token)
+        {
+        case Token::SHORT_TEXT:
+        {
+            uint8_t length;
+            read(length);
+            text.append(recording.substr(pos, length));
+            pos += length;
+            break;
+        }
+        case Token::TEXT:
+        {
+            uint32_t length;
+            read(length);
+            text.append(recording.substr(pos, length));
+            pos += length;
+            break;
+        }
+        case Token::SIGNED:
+        {
+            int64_t value;
+            read(value);
+            char buffer[24];
+            text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            break;
+        }
+        case Token::UNSIGNED:
+        {
+            uint64_t value;
+            read(value);
+            char buffer[24];
+            text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+            break;
+        }
+        case Token::DOUBLE:
+        {
+            double value;
+            read(value);
+            appendDouble(text, value);
+            break;
+        }
+        case Token::MM:
+        {
+            int32_t value;
+            read(value);
+            appendMM(text, value);
+            break;
+        }
+        case Token::PRECISIONED_DOUBLE:
+        {
+            uint8_t precision;
+            double value;
+            read(precision);
+            read(value);
+            appendPrecisionedDouble(text, precision, value);
+            break;
+        }
+        }
+    }
+    return text;
+}
+
+void GCodeBuffer::appendMM(std::string& text, const int32_t coord)
+{
+    char buffer[16];
+    const int char_count = static_cast<int>(std::to_chars(buffer, buffer + sizeof(buffer), coord).ptr - buffer);
+
+    int trailing_zeros = 0;
+    while (trailing_zeros < 3 && trailing_zeros < char_count && buffer[char_count - trailing_zeros - 1] == '0')
+    {
+        trailing_zeros++;
+    }
+    const int end_pos = char_count - trailing_zeros; // The first character not to write any more.
+    if (trailing_zeros == 3)
+    { // No need to write the decimal dot.
+        text.append(buffer, end_pos);
+        return;
+    }
+    if (char_count <= 3)
+    {
+        int start = 0; // Where to start writing from the buffer.
+        if (coord < 0)
+        {
+            text.push_back('-');
+            start = 1;
+        }
+        text.append("0.");
+        text.append(3 - (char_count - start), '0'); // Fill up to 3 decimals with zeros.
+        text.append(buffer + start, end_pos - start);
+    }
+    else
+    {
+        const int dot_pos = char_count - 3;
+        text.append(buffer, dot_pos);
+        text.push_back('.');
+        text.append(buffer + dot_pos, end_pos - dot_pos);
+    }
+}
+
+void GCodeBuffer::appendPrecisionedDouble(std::string& text, const uint8_t precision, const double value)
+{
+    constexpr size_t buffer_size = 400;
+    char buffer[buffer_size];
+    int char_count;
+    if (std::isfinite(value))
+    {
+        const std::to_chars_result result = std::to_chars(buffer, buffer + buffer_size, value, std::chars_format::fixed, precision);
+        if (result.ec != std::errc())
+        {
+            return; // Like writeDoubleToStream, which writes nothing if the number doesn't fit.
+        }
+        char_count = static_cast<int>(result.ptr - buffer);
+    }
+    else
+    { // Upper case INF and NAN, as the %F format of writeDoubleToStream writes them.
+        char format[5] = "%.xF";
+        format[2] = '0' + static_cast<char>(precision);
+        char_count = std::snprintf(buffer, buffer_size, format, value);
+    }
+    if (char_count <= 0)
+    {
+        return;
+    }
+    if (char_count - precision - 1 >= 0 && buffer[char_count - precision - 1] == '.')
+    { // Remove the trailing zeros, and the dot if nothing remains after it.
+        int non_nul_pos = char_count - 1;
+        while (buffer[non_nul_pos] == '0')
+        {
+            non_nul_pos--;
+        }
+        char_count = buffer[non_nul_pos] == '.' ? non_nul_pos : non_nul_pos + 1;
+    }
+    text.append(buffer, char_count);
+}
+
+void GCodeBuffer::appendDouble(std::string& text, const double value)
+{
+    constexpr size_t buffer_size = 400;
+    char buffer[buffer_size];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + buffer_size, value, std::chars_format::fixed, 6);
+    if (result.ec != std::errc())
+    {
+        std::ostringstream stream;
+        stream << std::fixed << value;
+        text.append(stream.view());
+        return;
+    }
+    text.append(buffer, result.ptr);
+}
+
+} // namespace cura
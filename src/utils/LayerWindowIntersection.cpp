@@ -0,0 +1,63 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/LayerWindowIntersection.h"
+
+#include <algorithm>
+
+#include "utils/ThreadPool.h"
+
+namespace cura
+{
+
+std::vector<Shape> intersectLayerWindows(const std::vector<Shape>& layer_areas, const size_t window_size)
+{
+    const size_t layer_count = layer_areas.size();
+    std::vector<Shape> windows(layer_count);
+    if (window_size == 0 || window_size > layer_count)
+    {
+        return windows;
+    }
+
+    std::vector<Shape> from_block_start(layer_count); // The intersection of the layers from the start of the block up to and including each layer.
+    std::vector<Shape> to_block_end(layer_count); // The intersection of the layers from each layer up to and including the end of the block.
+    const size_t block_count = (layer_count + window_size - 1) / window_size;
+    cura::parallel_for<size_t>(
+        0,
+        block_count,
+        [&](const size_t block_idx)
+        {
+            const size_t block_start = block_idx * window_size;
+            const size_t block_end = std::min(block_start + window_size, layer_count);
+            from_block_start[block_start] = layer_areas[block_start];
+            for (size_t layer_idx = block_start + 1; layer_idx < block_end; ++layer_idx)
+            {
+                from_block_start[layer_idx] = from_block_start[layer_idx - 1].intersection(layer_areas[layer_idx]);
+            }
+            to_block_end[block_end - 1] = layer_areas[block_end - 1];
+            for (size_t layer_idx = block_end - 1; layer_idx > block_start; --layer_idx)
+            {
+                to_block_end[layer_idx - 1] = to_block_end[layer_idx].intersection(layer_areas[layer_idx - 1]);
+            }
+        });
+
+    const size_t window_count = layer_count - window_size + 1;
+    cura::parallel_for<size_t>(
+        0,
+        window_count,
+        [&](const size_t window_start)
+        {
+            const size_t window_last = window_start + window_size - 1;
+            if (window_start % window_size == 0)
+            {
+                windows[window_start] = from_block_start[window_last]; // The window is exactly one block.
+            }
+            else
+            {
+                windows[window_start] = to_block_end[window_start].intersection(from_block_start[window_last]);
+            }
+        });
+    return windows;
+}
+
+} // namespace cura
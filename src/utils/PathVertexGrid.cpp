@@ -0,0 +1,130 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "utils/PathVertexGrid.h"
+
+#include <cmath>
+
+namespace cura
+{
+
+PathVertexGrid::PathVertexGrid(std::vector<Vertex> vertices, const size_t path_count)
+    : min_(std::numeric_limits<coord_t>::max(), std::numeric_limits<coord_t>::max())
+    , max_(std::numeric_limits<coord_t>::min(), std::numeric_limits<coord_t>::min())
+    , removed_(path_count, true) // Paths without vertices can't be found, as if they were removed already.
+{
+    for (const Vertex& vertex : vertices)
+    {
+        min_.X = std::min(min_.X, vertex.point.X);
+        min_.Y = std::min(min_.Y, vertex.point.Y);
+        max_.X = std::max(max_.X, vertex.point.X);
+        max_.Y = std::max(max_.Y, vertex.point.Y);
+        if (removed_[vertex.path])
+        {
+            removed_[vertex.path] = false;
+            ++remaining_paths_;
+        }
+    }
+    if (vertices.empty())
+    {
+        min_ = max_ = Point2LL(0, 0);
+    }
+
+    // Aim for about two vertices per cell, but never allocate much more cells than there are vertices, e.g. when they're all on a line.
+    const double width = static_cast<double>(max_.X - min_.X) + 1.0;
+    const double height = static_cast<double>(max_.Y - min_.Y) + 1.0;
+    constexpr double vertices_per_cell = 2.0;
+    cell_size_ = std::max(coord_t(1), static_cast<coord_t>(std::sqrt(width * height * vertices_per_cell / static_cast<double>(std::max(vertices.size(), size_t(1))))));
+    const size_t max_cell_count = 4 * vertices.size() + 16;
+    while (true)
+    {
+        column_count_ = (max_.X - min_.X) / cell_size_ + 1;
+        row_count_ = (max_.Y - min_.Y) / cell_size_ + 1;
+        if (static_cast<size_t>(column_count_) * static_cast<size_t>(row_count_) <= max_cell_count)
+        {
+            break;
+        }
+        cell_size_ *= 2;
+    }
+    const size_t cell_count = static_cast<size_t>(column_count_ * row_count_);
+
+    // Sort the vertices by cell, with a counting sort.
+    const auto cell_of = [this](const Point2LL& point)
+    {
+        return static_cast<size_t>(((point.Y - min_.Y) / cell_size_) * column_count_ + (point.X - min_.X) / cell_size_);
+    };
+    cell_begin_.assign(cell_count + 1, 0);
+    for (const Vertex& vertex : vertices)
+    {
+        ++cell_begin_[cell_of(vertex.point) + 1];
+    }
+    for (size_t cell = 0; cell < cell_count; ++cell)
+    {
+        cell_begin_[cell + 1] += cell_begin_[cell];
+    }
+    vertices_.resize(vertices.size());
+    std::vector<size_t> fill = cell_begin_;
+    for (const Vertex& vertex : vertices)
+    {
+        vertices_[fill[cell_of(vertex.point)]++] = vertex;
+    }
+
+    cell_size_left_.resize(cell_count);
+    non_empty_position_.resize(cell_count);
+    for (size_t cell = 0; cell < cell_count; ++cell)
+    {
+        cell_size_left_[cell] = cell_begin_[cell + 1] - cell_begin_[cell];
+        if (cell_size_left_[cell] > 0)
+        {
+            non_empty_position_[cell] = non_empty_cells_.size();
+            non_empty_cells_.push_back(cell);
+        }
+    }
+}
+
+void PathVertexGrid::remove(const size_t path)
+{
+    if (! removed_[path])
+    {
+        removed_[path] = true;
+        --remaining_paths_;
+    }
+}
+
+std::vector<size_t> PathVertexGrid::getNearbyPaths(const Point2LL& query_point, const coord_t radius)
+{
+    std::vector<size_t> paths;
+    const coord_t min_column = std::max(coord_t(0), (query_point.X - radius - min_.X) / cell_size_);
+    const coord_t max_column = std::min(column_count_ - 1, (query_point.X + radius - min_.X) / cell_size_);
+    const coord_t min_row = std::max(coord_t(0), (query_point.Y - radius - min_.Y) / cell_size_);
+    const coord_t max_row = std::min(row_count_ - 1, (query_point.Y + radius - min_.Y) / cell_size_);
+    for (coord_t row = min_row; row <= max_row; ++row)
+    {
+        for (coord_t column = min_column; column <= max_column; ++column)
+        {
+            forRemainingVertices(
+                static_cast<size_t>(row * column_count_ + column),
+                [&paths, &query_point, radius](const Vertex& vertex)
+                {
+                    if (vSize2(vertex.point - query_point) <= radius * radius)
+                    {
+                        paths.push_back(vertex.path);
+                    }
+                });
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+void PathVertexGrid::dropCell(const size_t cell)
+{
+    const size_t position = non_empty_position_[cell];
+    const size_t last_cell = non_empty_cells_.back();
+    non_empty_cells_[position] = last_cell;
+    non_empty_position_[last_cell] = position;
+    non_empty_cells_.pop_back();
+}
+
+} // namespace cura
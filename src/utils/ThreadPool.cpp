@@ -1,48 +1,220 @@
-//Copyright (c) 2022 Ultimaker B.V.
-//CuraEngine is released under the terms of the AGPLv3 or higher.
+// Copyright (c) 2022 Ultimaker B.V.
+// CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "utils/ThreadPool.h"
 
+#include <bit> // bit_ceil
+#include <chrono>
+
 namespace cura
 {
 
+namespace
+{
+
+//! Identifies the pool and the queue of the worker running on this thread, if any
+struct CurrentWorker
+{
+    const ThreadPool* pool = nullptr;
+    size_t queue_idx = 0;
+};
+
+thread_local CurrentWorker current_worker;
+
+//! The batch of the task running on this thread, if any. Becomes the parent of the batches created by that task.
+thread_local const TaskLatch* current_batch = nullptr;
+
+} // namespace
+
+TaskLatch::TaskLatch(size_t count)
+    : parent_(current_batch)
+    , remaining_(count)
+    , done_(count == 0)
+{
+}
+
 ThreadPool::ThreadPool(size_t nthreads)
-  : wait_for_new_tasks(true)
+    : queue_capacity(std::bit_ceil(std::max<size_t>(256, 32 * (nthreads + 1)))) // Room for all chunks of a parallel_for with up to 32 chunks per worker
+    , queues_count(nthreads + 1)
+    , queues(std::make_unique<TaskQueue[]>(nthreads + 1))
+    , wait_for_new_tasks(true)
 {
-    for (size_t i = 0 ; i < nthreads; i++)
+    for (size_t queue_idx = 0; queue_idx < queues_count; queue_idx++)
     {
-        threads.emplace_back(&ThreadPool::worker, this);
+        queues[queue_idx].ring = std::make_unique<Task[]>(queue_capacity);
+    }
+    for (size_t i = 0; i < nthreads; i++)
+    {
+        threads.emplace_back(&ThreadPool::worker, this, i);
     }
 }
 
-void ThreadPool::worker()
+void ThreadPool::push(task_fn_t function, void* context, size_t count, TaskLatch& latch)
 {
-    lock_t lock = get_lock();
-    work_while(lock, [this, &lock]()
+    TaskQueue& queue = queues[current_queue_idx()];
+    size_t pushed;
+    {
+        std::lock_guard lock(queue.mutex);
+        pushed = std::min(count, queue_capacity - (queue.tail - queue.head));
+        queued_tasks.fetch_add(pushed); // Before the tasks can be taken, so that the counter never underflows
+        for (size_t index = 0; index < pushed; index++)
+        {
+            queue.ring[queue.tail++ & (queue_capacity - 1)] = Task{ function, context, index, &latch };
+        }
+        queue.size.store(queue.tail - queue.head, std::memory_order_relaxed);
+    }
+
+    // Wake up idle workers. Paired with the check of queued_tasks in worker(), so that a worker never sleeps while there are tasks.
+    const size_t sleeping = sleeping_workers.load();
+    if (pushed > 0 && sleeping > 0)
+    {
+        std::lock_guard lock(idle_mutex);
+        if (pushed >= sleeping)
         {
-            while(tasks.empty() && wait_for_new_tasks)
-            {  // Wait for a task. Signaled by ThreadPool::push() and ThreadPool::join()
-               condition.wait(lock);
+            idle_condition.notify_all();
+        }
+        else
+        {
+            for (size_t i = 0; i < pushed; i++)
+            {
+                idle_condition.notify_one();
             }
-            // Returns false if the queue is empty and the pool is being disposed
-            return !tasks.empty() || wait_for_new_tasks;
-        });
+        }
+    }
+
+    // The queue is full: run the remaining tasks right away
+    for (size_t index = pushed; index < count; index++)
+    {
+        run(Task{ function, context, index, &latch });
+    }
+}
+
+bool ThreadPool::run_one()
+{
+    return run_one(nullptr);
+}
+
+bool ThreadPool::run_one(const TaskLatch* ancestor)
+{
+    const size_t own_queue_idx = current_queue_idx();
+    Task task;
+    bool found = take(queues[own_queue_idx], false, ancestor, task);
+    for (size_t offset = 1; ! found && offset < queues_count; offset++)
+    {
+        found = take(queues[(own_queue_idx + offset) % queues_count], true, ancestor, task);
+    }
+    if (! found)
+    {
+        return false;
+    }
+    queued_tasks.fetch_sub(1);
+    run(task);
+    return true;
+}
+
+void ThreadPool::run(const Task& task)
+{
+    const TaskLatch* const outer_batch = current_batch;
+    current_batch = task.latch;
+    task.function(task.context, task.index);
+    current_batch = outer_batch;
+}
+
+void ThreadPool::work_until(TaskLatch& latch)
+{
+    while (! latch.is_ready())
+    {
+        if (! run_one(&latch))
+        { // The remaining tasks of this batch are running on other threads. They may still push nested tasks that we can help with.
+            constexpr auto poll_interval = std::chrono::milliseconds(1);
+            latch.wait_for(poll_interval);
+        }
+    }
+    latch.wait();
+}
+
+bool ThreadPool::take(TaskQueue& queue, bool steal, const TaskLatch* ancestor, Task& task)
+{
+    if (queue.size.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+    std::lock_guard lock(queue.mutex);
+    if (queue.head == queue.tail)
+    {
+        return false;
+    }
+    // Oldest task when stealing: for a parallel_for, the chunks furthest away from the ones the owner is working on.
+    // Newest task otherwise: most likely to still be in cache.
+    const size_t position = steal ? queue.head : queue.tail - 1;
+    const Task& candidate = queue.ring[position & (queue_capacity - 1)];
+    if (ancestor != nullptr && ! candidate.latch->is_descendant_of(*ancestor))
+    {
+        return false;
+    }
+    task = candidate;
+    if (steal)
+    {
+        queue.head++;
+    }
+    else
+    {
+        queue.tail--;
+    }
+    queue.size.store(queue.tail - queue.head, std::memory_order_relaxed);
+    return true;
+}
+
+size_t ThreadPool::current_queue_idx() const
+{
+    if (current_worker.pool == this)
+    {
+        return current_worker.queue_idx;
+    }
+    return queues_count - 1; // Shared by all threads that are not part of the pool
+}
+
+void ThreadPool::worker(size_t queue_idx)
+{
+    current_worker = CurrentWorker{ this, queue_idx };
+    while (true)
+    {
+        if (run_one())
+        {
+            continue;
+        }
+
+        std::unique_lock lock(idle_mutex);
+        sleeping_workers.fetch_add(1);
+        while (queued_tasks.load() == 0 && wait_for_new_tasks)
+        { // Wait for a task. Signaled by ThreadPool::push() and ThreadPool::join()
+            idle_condition.wait(lock);
+        }
+        sleeping_workers.fetch_sub(1);
+        if (queued_tasks.load() == 0 && ! wait_for_new_tasks)
+        { // The queues are empty and the pool is being disposed
+            return;
+        }
+    }
 }
 
 void ThreadPool::join()
 {
-    { // Joinning thread becomes a worker while there is remaining tasks
-        lock_t lock = get_lock();
+    {
+        std::lock_guard lock(idle_mutex);
         wait_for_new_tasks = false;
-        condition.notify_all();
-        work_while(lock, []{ return true; });
+        idle_condition.notify_all();
+    }
+    // Joining thread becomes a worker while there are remaining tasks
+    while (run_one())
+    {
     }
-    assert(tasks.empty());
     for (auto& thread : threads)
     {
         thread.join();
     }
     threads.clear();
+    assert(queued_tasks.load() == 0);
 }
 
-} //Cura namespace.
+} // namespace cura
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher
+
+#include "BeadingStrategy/CachingBeadingStrategy.h" //Unit under test.
+
+#include <gtest/gtest.h>
+
+#include "BeadingStrategy/BeadingStrategyFactory.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+void expectSameBeading(const BeadingStrategy::Beading& expected, const BeadingStrategy::Beading& actual)
+{
+    EXPECT_EQ(actual.total_thickness, expected.total_thickness);
+    EXPECT_EQ(actual.bead_widths, expected.bead_widths);
+    EXPECT_EQ(actual.toolpath_locations, expected.toolpath_locations);
+    EXPECT_EQ(actual.left_over, expected.left_over);
+}
+
+/*!
+ * Cached beadings must be the same as the ones computed by the parent strategy.
+ */
+TEST(CachingBeadingStrategyTest, SameAsParent)
+{
+    const BeadingStrategyPtr reference = BeadingStrategyFactory::makeStrategy(400, 350, 400, 0.5, false, 200, 100, 0.5_r, 0.5_r, 6, 20);
+    CachingBeadingStrategy cache(BeadingStrategyFactory::makeStrategy(400, 350, 400, 0.5, false, 200, 100, 0.5_r, 0.5_r, 6, 20));
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (coord_t thickness = 50; thickness < 3000; thickness += 37)
+        {
+            const coord_t bead_count = reference->getOptimalBeadCount(thickness);
+            EXPECT_EQ(cache.getOptimalBeadCount(thickness), bead_count);
+            expectSameBeading(reference->compute(thickness, bead_count), cache.compute(thickness, bead_count));
+        }
+    }
+    EXPECT_EQ(cache.getHits(), cache.getMisses()) << "The second pass must only find cached beadings.";
+}
+
+TEST(CachingBeadingStrategyTest, LimitedSize)
+{
+    CachingBeadingStrategy cache(BeadingStrategyFactory::makeStrategy(400, 400, 400, 0.5, false, 0, 0, 0.5_r, 0.5_r, 4), 16);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (coord_t thickness = 100; thickness < 2100; thickness += 10)
+        {
+            cache.compute(thickness, cache.getOptimalBeadCount(thickness));
+        }
+    }
+    EXPECT_LE(cache.getHits(), 16);
+    EXPECT_EQ(cache.getHits() + cache.getMisses(), 400);
+}
+
+TEST(CachingBeadingStrategyTest, SharedStrategies)
+{
+    const auto make_strategy = [](const coord_t inner_width)
+    {
+        return BeadingStrategyFactory::makeSharedStrategy(400, inner_width, 400, 0.5, false, 0, 0, 0.5_r, 0.5_r, 4);
+    };
+    const auto strategy = make_strategy(350);
+    EXPECT_EQ(make_strategy(350), strategy) << "The same settings must give the same strategy.";
+    EXPECT_NE(make_strategy(400), strategy);
+
+    BeadingStrategyFactory::clearSharedStrategies();
+    EXPECT_NE(make_strategy(350), strategy) << "After clearing, a new strategy must be made.";
+    EXPECT_EQ(strategy->compute(800, 2).bead_widths.size(), 2) << "A strategy in use must stay usable after clearing.";
+    BeadingStrategyFactory::clearSharedStrategies();
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
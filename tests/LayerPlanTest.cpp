@@ -229,6 +229,26 @@ public:
     }
 };
 
+TEST_F(LayerPlanTest, LayerOutlinesCached)
+{
+    const size_t hits_before = storage->getLayerOutlinesHits();
+    const size_t misses_before = storage->getLayerOutlinesMisses();
+
+    const Shape outlines = storage->getLayerOutlines(3, false, false);
+    EXPECT_EQ(storage->getLayerOutlinesMisses(), misses_before + 1);
+    EXPECT_EQ(storage->getLayerOutlines(3, false, false).size(), outlines.size());
+    EXPECT_EQ(storage->getLayerOutlinesHits(), hits_before + 1) << "Asking for the same outlines again must reuse them.";
+
+    storage->getLayerOutlines(3, true, false);
+    storage->getLayerOutlines(3, false, false, true);
+    EXPECT_EQ(storage->getLayerOutlinesMisses(), misses_before + 3) << "Outlines with different parameters must be computed separately.";
+
+    storage->invalidateLayerOutlines();
+    storage->getLayerOutlines(3, false, false);
+    EXPECT_EQ(storage->getLayerOutlinesMisses(), misses_before + 4) << "After invalidating, the outlines must be computed again.";
+    EXPECT_EQ(storage->getLayerOutlinesHits(), hits_before + 1);
+}
+
 // Test all combinations of these settings in parameterised tests.
 std::vector<std::string> retraction_enable = { "false", "true" };
 std::vector<std::string> hop_enable = { "false", "true" };
@@ -73,5 +73,30 @@ TEST_F(PathOrderOptimizerTest, ThreeTrianglesShortestOrder)
     EXPECT_EQ(optimizer.paths_[2].vertices_->front(), Point2LL(1000, 1000)) << "Far triangle last.";
 }
 
+/*!
+ * Two triangles are equally far away from the start in a straight line, but
+ * the travel to the one that was added first has to comb around a hole in
+ * the combing boundary. The tie must be settled on the travel distance, so
+ * the other triangle goes first.
+ */
+TEST_F(PathOrderOptimizerTest, CombingSettlesTie)
+{
+    Shape combing_boundary;
+    combing_boundary.push_back(Polygon({ { -1000, -1000 }, { 1000, -1000 }, { 1000, 1000 }, { -1000, 1000 } }, false));
+    combing_boundary.push_back(Polygon({ { -200, 200 }, { -200, 300 }, { 200, 300 }, { 200, 200 } }, false)); // A hole between the start and the blocked triangle.
+
+    Polygon blocked({ { 0, 500 }, { 50, 550 }, { -50, 550 } }, false);
+    Polygon clear({ { 500, 0 }, { 550, 50 }, { 550, -50 } }, false);
+
+    PathOrderOptimizer<const Polygon*> combing_optimizer(Point2LL(0, 0), ZSeamConfig(), false, &combing_boundary);
+    combing_optimizer.addPolygon(&blocked);
+    combing_optimizer.addPolygon(&clear);
+    combing_optimizer.optimize();
+
+    ASSERT_EQ(combing_optimizer.paths_.size(), 2);
+    EXPECT_EQ(combing_optimizer.paths_[0].vertices_, &clear) << "The triangle that can be reached without combing around the hole comes first.";
+    EXPECT_EQ(combing_optimizer.paths_[1].vertices_, &blocked);
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
@@ -10,7 +10,9 @@
 
 #include <gtest/gtest.h>
 
+#include "Application.h" //To run the walls of the parts on the thread pool.
 #include "InsetOrderOptimizer.h" //Unit also under test.
+#include "WallToolPathsCache.h" //Unit also under test.
 #include "geometry/OpenPolyline.h"
 #include "geometry/Polygon.h" //To create example polygons.
 #include "settings/Settings.h" //Settings to generate walls with.
@@ -97,6 +99,12 @@ public:
         settings.add("wall_x_extruder_nr", "0");
         settings.add("wall_distribution_count", "2");
     }
+
+    void SetUp() override
+    {
+        // The walls of the parts of a layer are generated with parallel_for, as they are when slicing.
+        Application::getInstance().startThreadPool();
+    }
 };
 
 /*!
@@ -227,5 +235,47 @@ TEST_F(WallsComputationTest, WallToolPathsGetWeakOrder)
     EXPECT_EQ(has_order_info.size(), n_paths) << "Every path should have order information.";
 }
 
+/*!
+ * Layers with the same outline at another position must get the same walls, shifted along.
+ */
+TEST_F(WallsComputationTest, ReuseWallsOfShiftedOutline)
+{
+    WallToolPathsCache walls_cache(settings);
+    const Point2LL shift(MM2INT(7), MM2INT(-3));
+    Shape shifted_holes = ff_holes;
+    shifted_holes.translate(shift);
+
+    SliceLayer layer;
+    layer.parts.emplace_back();
+    layer.parts.back().outline.push_back(ff_holes);
+    WallsComputation(settings, LayerIndex(100), &walls_cache).generateWalls(&layer, SectionType::WALL);
+    SliceLayer shifted_layer;
+    shifted_layer.parts.emplace_back();
+    shifted_layer.parts.back().outline.push_back(shifted_holes);
+    WallsComputation(settings, LayerIndex(101), &walls_cache).generateWalls(&shifted_layer, SectionType::WALL);
+
+    EXPECT_EQ(walls_cache.getMisses(), 1);
+    EXPECT_EQ(walls_cache.getHits(), 1) << "The walls of the shifted outline must be reused.";
+    const SliceLayerPart& part = layer.parts.back();
+    const SliceLayerPart& shifted_part = shifted_layer.parts.back();
+    ASSERT_EQ(shifted_part.wall_toolpaths.size(), part.wall_toolpaths.size());
+    for (size_t inset_idx = 0; inset_idx < part.wall_toolpaths.size(); ++inset_idx)
+    {
+        ASSERT_EQ(shifted_part.wall_toolpaths[inset_idx].size(), part.wall_toolpaths[inset_idx].size());
+        for (size_t line_idx = 0; line_idx < part.wall_toolpaths[inset_idx].size(); ++line_idx)
+        {
+            const ExtrusionLine& line = part.wall_toolpaths[inset_idx][line_idx];
+            const ExtrusionLine& shifted_line = shifted_part.wall_toolpaths[inset_idx][line_idx];
+            ASSERT_EQ(shifted_line.size(), line.size());
+            for (size_t junction_idx = 0; junction_idx < line.size(); ++junction_idx)
+            {
+                EXPECT_EQ(shifted_line.junctions_[junction_idx].p_, line.junctions_[junction_idx].p_ + shift);
+                EXPECT_EQ(shifted_line.junctions_[junction_idx].w_, line.junctions_[junction_idx].w_);
+            }
+        }
+    }
+    EXPECT_EQ(shifted_part.inner_area.area(), part.inner_area.area());
+}
+
 } // namespace cura
 // NOLINTEND(*-magic-numbers)
@@ -99,7 +99,7 @@ TEST_F(ArcusCommunicationTest, FlushGCodeTest)
     // Multi-line to see flushing behaviour.
     const std::string test_gcode = "This Fibonacci joke is as bad as the last two you heard combined.\n"
                                    "It's pretty cool how the Chinese made a language entirely out of tattoos.";
-    ac->private_data->gcode_output_stream.write(test_gcode.c_str(), test_gcode.size());
+    ac->private_data->gcode_output.write(test_gcode);
 
     // Call the function we're testing. This time it should give us a message.
     ac->flushGCode();
@@ -4,6 +4,7 @@
 #include "settings/Settings.h" //The class under test.
 
 #include <cmath>
+#include <cstring>
 #include <memory> //For shared_ptr.
 #include <numbers>
 
@@ -237,6 +238,52 @@ TEST_F(SettingsTest, Inheritance)
     EXPECT_EQ(override_value, settings.get<std::string>("test_setting")) << "The new value overrides the one from the parent.";
 }
 
+TEST_F(SettingsTest, InheritanceCachedValue)
+{
+    std::shared_ptr<Slice> current_slice = std::make_shared<Slice>(0);
+    Application::getInstance().current_slice_ = current_slice.get();
+
+    Settings parent;
+    parent.add("test_setting", "1.5");
+    settings.setParent(&parent);
+    EXPECT_EQ(MM2INT(1.5), settings.get<coord_t>("test_setting"));
+
+    parent.add("test_setting", "2.5");
+    EXPECT_EQ(MM2INT(2.5), settings.get<coord_t>("test_setting")) << "Changing the parent must invalidate the value cached by the child.";
+
+    Settings other_parent;
+    other_parent.add("test_setting", "3.5");
+    settings.setParent(&other_parent);
+    EXPECT_EQ(MM2INT(3.5), settings.get<coord_t>("test_setting"));
+    EXPECT_DOUBLE_EQ(3.5, settings.get<double>("test_setting")) << "The same setting can be cached as different types.";
+    EXPECT_EQ(MM2INT(3.5), settings.get<coord_t>("test_setting"));
+}
+
+TEST_F(SettingsTest, SettingKeyHandle)
+{
+    settings.add("test_setting", "42");
+    EXPECT_EQ(size_t(42), settings.get<size_t>(setting_key<"test_setting">()));
+    EXPECT_EQ(&setting_key<"test_setting">(), &setting_key<"test_setting">());
+    EXPECT_EQ(setting_key<"test_setting">().id(), SettingKey("test_setting").id());
+    EXPECT_EQ("test_setting", setting_key<"test_setting">().name());
+
+    settings.add("test_setting", "43");
+    EXPECT_EQ(size_t(43), settings.get<size_t>(setting_key<"test_setting">()));
+}
+
+TEST_F(SettingsTest, SettingKeyFromArray)
+{
+    settings.add("test_setting", "42");
+    settings.add("test_other", "43");
+    EXPECT_EQ(SettingKey::fromLiteral("test_setting", sizeof("test_setting")).id(), SettingKey("test_setting").id());
+
+    char name[16] = "test_setting";
+    EXPECT_EQ(size_t(42), settings.get<size_t>(name));
+    std::strcpy(name, "test_other");
+    EXPECT_EQ(size_t(43), settings.get<size_t>(name)) << "The same array with another name must resolve to the other setting.";
+    EXPECT_EQ("test_other", SettingKey::fromLiteral(name, sizeof(name)).name()) << "The name ends at the null character, not at the end of the array.";
+}
+
 TEST_F(SettingsTest, LimitToExtruder)
 {
     std::shared_ptr<Slice> current_slice = std::make_shared<Slice>(0);
@@ -0,0 +1,105 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/AreaSpillStore.h" // The file under test.
+
+#include <gtest/gtest.h>
+
+#include "geometry/Polygon.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class AreaSpillStoreTest : public testing::Test
+{
+public:
+    Shape area;
+
+    void SetUp() override
+    {
+        Polygon outline;
+        outline.emplace_back(-100000, -100000);
+        outline.emplace_back(100000, -100000);
+        outline.emplace_back(100000, 100000);
+        outline.emplace_back(-100000, 100000);
+        area.push_back(outline);
+
+        Polygon hole(true); // Explicitly closed, which must survive the round trip.
+        hole.emplace_back(10, 10);
+        hole.emplace_back(10, 20);
+        hole.emplace_back(20, 20);
+        hole.emplace_back(10, 10);
+        area.push_back(hole);
+    }
+
+    void expectSameArea(const Shape& actual) const
+    {
+        ASSERT_EQ(actual.size(), area.size());
+        for (size_t polygon_idx = 0; polygon_idx < area.size(); ++polygon_idx)
+        {
+            EXPECT_EQ(actual[polygon_idx].getPoints(), area[polygon_idx].getPoints());
+            EXPECT_EQ(actual[polygon_idx].isExplicitelyClosed(), area[polygon_idx].isExplicitelyClosed());
+        }
+    }
+};
+
+TEST_F(AreaSpillStoreTest, EncodeDecode)
+{
+    const std::vector<uint8_t> data = AreaSpillStore::encode(area);
+    EXPECT_LT(data.size(), 8 * sizeof(Point2LL)) << "The serialised area must be smaller than its points.";
+    expectSameArea(AreaSpillStore::decode(data));
+
+    EXPECT_TRUE(AreaSpillStore::decode(AreaSpillStore::encode(Shape())).empty());
+}
+
+TEST_F(AreaSpillStoreTest, StoreInMemory)
+{
+    AreaSpillStore store(false);
+    const size_t id = store.store(area);
+    const size_t other_id = store.store(area);
+    EXPECT_NE(id, other_id);
+    EXPECT_EQ(store.getBytes(), 2 * AreaSpillStore::encode(area).size());
+
+    expectSameArea(store.load(id));
+    store.discard(other_id);
+    EXPECT_EQ(store.getBytes(), 0);
+}
+
+TEST_F(AreaSpillStoreTest, StoreInFile)
+{
+    AreaSpillStore store(true);
+    std::vector<size_t> ids;
+    for (int i = 0; i < 10; ++i)
+    {
+        ids.push_back(store.store(area));
+    }
+    for (const size_t id : ids)
+    {
+        expectSameArea(store.load(id));
+    }
+    EXPECT_EQ(store.getBytes(), 0);
+    EXPECT_EQ(store.getFileSize(), 0) << "The file must not grow once all areas are loaded back.";
+}
+
+TEST_F(AreaSpillStoreTest, ReuseFileSpace)
+{
+    AreaSpillStore store(true);
+    const uint64_t area_size = AreaSpillStore::encode(area).size();
+    const size_t first = store.store(area);
+    const size_t second = store.store(area);
+    const size_t third = store.store(area);
+    ASSERT_EQ(store.getFileSize(), 3 * area_size);
+
+    store.discard(first);
+    expectSameArea(store.load(second));
+    const size_t reused = store.store(area);
+    EXPECT_EQ(store.getFileSize(), 3 * area_size) << "A new area must reuse the space of removed ones.";
+
+    expectSameArea(store.load(third));
+    expectSameArea(store.load(reused));
+    EXPECT_EQ(store.getFileSize(), 0);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
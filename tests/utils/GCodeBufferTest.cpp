@@ -0,0 +1,131 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/GCodeBuffer.h" // The file under test.
+
+#include <limits>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "utils/string.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Fixture to allow parameterized tests for the millimetre output of the buffer.
+ */
+class GCodeBufferMMTest : public testing::TestWithParam<int>
+{
+};
+
+/*
+ * The buffer must write coordinates exactly like writeInt2mm does.
+ */
+TEST_P(GCodeBufferMMTest, SameAsWriteInt2mm)
+{
+    const int in = GetParam();
+
+    std::ostringstream expected;
+    writeInt2mm(in, expected);
+
+    std::ostringstream output;
+    GCodeBuffer buffer;
+    buffer.setStream(&output);
+    buffer << MMtoStream{ in };
+    buffer.flush();
+
+    EXPECT_EQ(expected.str(), output.str());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GCodeBufferMMTestInstantiation,
+    GCodeBufferMMTest,
+    testing::Values(-10000, -1230, -1000, -123, -100, -10, -1, 0, 1, 10, 100, 120, 1000, 1001, 1230, 10000, 123456789, std::numeric_limits<int32_t>::max()));
+
+/*
+ * Fixture to allow parameterized tests for the double output of the buffer.
+ */
+class GCodeBufferDoubleTest : public testing::TestWithParam<double>
+{
+};
+
+/*
+ * The buffer must write doubles exactly like writeDoubleToStream does, for any
+ * precision.
+ */
+TEST_P(GCodeBufferDoubleTest, SameAsWriteDoubleToStream)
+{
+    const double in = GetParam();
+
+    for (uint8_t precision = 0; precision <= 6; precision++)
+    {
+        std::ostringstream expected;
+        writeDoubleToStream(precision, in, expected);
+
+        std::ostringstream output;
+        GCodeBuffer buffer;
+        buffer.setStream(&output);
+        buffer << PrecisionedDouble{ precision, in };
+        buffer.flush();
+
+        EXPECT_EQ(expected.str(), output.str()) << "With precision " << static_cast<int>(precision) << ".";
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GCodeBufferDoubleTestInstantiation,
+    GCodeBufferDoubleTest,
+    testing::Values(-1000.5, -10.0, -1.0, -0.5, -0.001, -0.0, 0.0, 0.0004, 0.001, 0.05, 0.1, 1.0, 2.675, 10.0, 123.456789, 1e20, std::numeric_limits<double>::infinity()));
+
+/*
+ * Complete lines are written to the stream as soon as they end, so that the
+ * output can be read back right away.
+ */
+TEST(GCodeBufferTest, WritesCompleteLines)
+{
+    std::ostringstream output;
+    GCodeBuffer buffer;
+    buffer.setStream(&output);
+
+    buffer << "G1 X" << MMtoStream{ 1500 } << " F" << PrecisionedDouble{ 1, 1800.0 } << " S" << 255 << " T" << 1.5;
+    EXPECT_EQ("", output.str()) << "An incomplete line must not be written yet.";
+
+    buffer << "\n";
+    EXPECT_EQ("G1 X1.5 F1800 S255 T1.500000\n", output.str());
+}
+
+/*
+ * Rendering recorded output must give the same text as writing it directly.
+ */
+TEST(GCodeBufferTest, RenderRecording)
+{
+    const auto write_layer = [](GCodeBuffer& buffer)
+    {
+        buffer << ";LAYER:" << 3 << "\n";
+        buffer << "G1 F" << PrecisionedDouble{ 1, 1800.0 } << " X" << MMtoStream{ 1500 } << " Y" << MMtoStream{ -123 } << " E" << PrecisionedDouble{ 5, 0.123456 } << '\n';
+        buffer << ";TIME_ELAPSED:" << 42.5 << "\n";
+        buffer << "M106 S" << size_t(255) << "\n" << std::string(300, ';') << "\n";
+    };
+
+    std::ostringstream expected;
+    GCodeBuffer direct_buffer;
+    direct_buffer.setStream(&expected);
+    write_layer(direct_buffer);
+
+    std::ostringstream output;
+    GCodeBuffer recording_buffer;
+    recording_buffer.setStream(&output);
+    recording_buffer.startRecording();
+    write_layer(recording_buffer);
+    const std::string recording = recording_buffer.stopRecording();
+    EXPECT_EQ("", output.str()) << "Recorded output must not be written.";
+
+    recording_buffer.write(GCodeBuffer::render(recording));
+    EXPECT_EQ(expected.str(), output.str());
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
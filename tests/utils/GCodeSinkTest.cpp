@@ -0,0 +1,162 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/GCodeSink.h" // The file under test.
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "utils/CompressedSink.h"
+#include "utils/FileDescriptorSink.h"
+
+#ifdef ENABLE_GCODE_COMPRESSION
+#include <zlib.h>
+#endif
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/*
+ * Some g-code to write, long enough to overflow small buffers.
+ */
+std::string testGCode()
+{
+    std::string gcode;
+    for (int i = 0; i < 10000; ++i)
+    {
+        gcode += "G1 X" + std::to_string(i % 200) + " Y" + std::to_string(i % 170) + " E" + std::to_string(i) + "\n";
+    }
+    return gcode;
+}
+
+TEST(GCodeSinkTest, MemorySinkClear)
+{
+    MemorySink sink;
+    sink.write("G28\n");
+    sink.write("G1 X10\n");
+    EXPECT_EQ(sink.view(), "G28\nG1 X10\n");
+
+    sink.clear();
+    EXPECT_TRUE(sink.view().empty());
+    sink.write("M104 S0\n");
+    EXPECT_EQ(sink.view(), "M104 S0\n");
+    EXPECT_EQ(sink.getBytesWritten(), 19) << "Clearing the collected g-code must not reset the count of written bytes.";
+}
+
+/*
+ * Writes through a small buffer, with chunks both smaller and larger than the buffer.
+ */
+TEST(GCodeSinkTest, FileDescriptorSinkWritesFile)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "curaengine_gcode_sink_test.gcode";
+    const std::string gcode = testGCode();
+    {
+        FileDescriptorSink sink(64);
+        ASSERT_TRUE(sink.open(path.string()));
+        sink.write(std::string_view(gcode).substr(0, 10));
+        sink.write(std::string_view(gcode).substr(10, 1000));
+        sink.write(std::string_view(gcode).substr(1010));
+        EXPECT_EQ(sink.getBytesWritten(), gcode.size());
+    }
+    EXPECT_EQ(readFile(path), gcode);
+    std::filesystem::remove(path);
+}
+
+#ifdef __linux__
+/*
+ * A full disk must be reported when the output is finished, instead of silently truncating the g-code.
+ */
+TEST(GCodeSinkTest, FileDescriptorSinkReportsFailure)
+{
+    FileDescriptorSink sink(64);
+    ASSERT_TRUE(sink.open("/dev/full"));
+    sink.write(testGCode());
+    EXPECT_TRUE(sink.hasFailed());
+    EXPECT_FALSE(sink.finish());
+}
+#endif
+
+/*
+ * G-code written after the file is closed, or when it could not be opened, is lost, which must be reported.
+ */
+TEST(GCodeSinkTest, FileDescriptorSinkReportsWriteWithoutFile)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "curaengine_gcode_sink_test_closed.gcode";
+    FileDescriptorSink sink;
+    ASSERT_TRUE(sink.open(path.string()));
+    sink.write("G28\n");
+    EXPECT_TRUE(sink.finish());
+    sink.write("G1 X10\n");
+    EXPECT_TRUE(sink.hasFailed());
+    EXPECT_FALSE(sink.finish());
+    std::filesystem::remove(path);
+
+    FileDescriptorSink never_opened;
+    never_opened.write("G28\n");
+    EXPECT_FALSE(never_opened.finish());
+}
+
+TEST(GCodeSinkTest, FormatForFile)
+{
+    EXPECT_EQ(CompressedSink::formatForFile("print.gcode.gz"), CompressedSink::Format::GZIP);
+    EXPECT_EQ(CompressedSink::formatForFile("print.gcode.zst"), CompressedSink::Format::ZSTD);
+    EXPECT_FALSE(CompressedSink::formatForFile("print.gcode").has_value());
+    EXPECT_FALSE(CompressedSink::formatForFile("print.gz.gcode").has_value());
+}
+
+#ifdef ENABLE_GCODE_COMPRESSION
+/*
+ * Flushing halfway must not end the gzip member: the output is a single member, completed once.
+ */
+TEST(GCodeSinkTest, GzipRoundTrip)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "curaengine_gcode_sink_test.gcode.gz";
+    const std::string gcode = testGCode();
+    {
+        FileDescriptorSink file;
+        ASSERT_TRUE(file.open(path.string()));
+        CompressedSink sink(CompressedSink::Format::GZIP, file);
+        ASSERT_FALSE(sink.hasFailed());
+        sink.write(std::string_view(gcode).substr(0, gcode.size() / 2));
+        sink.flush();
+        sink.write(std::string_view(gcode).substr(gcode.size() / 2));
+        sink.flush();
+        sink.flush();
+        EXPECT_EQ(sink.getBytesWritten(), gcode.size());
+        EXPECT_TRUE(sink.finish());
+        EXPECT_TRUE(sink.finish()) << "Finishing again must not add anything.";
+    }
+
+    std::string compressed = readFile(path);
+    z_stream stream{};
+    ASSERT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+    std::string decompressed(gcode.size() + 1, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    stream.next_out = reinterpret_cast<Bytef*>(decompressed.data());
+    stream.avail_out = static_cast<uInt>(decompressed.size());
+    const int result = inflate(&stream, Z_FINISH);
+    decompressed.resize(stream.total_out);
+    const uInt trailing = stream.avail_in;
+    inflateEnd(&stream);
+    EXPECT_EQ(result, Z_STREAM_END);
+    EXPECT_EQ(trailing, 0) << "All g-code must be in a single gzip member.";
+    EXPECT_EQ(decompressed, gcode);
+    std::filesystem::remove(path);
+}
+#endif
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -0,0 +1,51 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/LRUCache.h" // The file under test.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+TEST(LRUCacheTest, FindInserted)
+{
+    LRUCache<int, std::string> cache(4);
+    EXPECT_EQ(cache.find(1), nullptr);
+
+    cache.insert(1, "one");
+    cache.insert(2, "two");
+    ASSERT_NE(cache.find(1), nullptr);
+    EXPECT_EQ(*cache.find(1), "one");
+    EXPECT_EQ(*cache.find(2), "two");
+
+    cache.insert(1, "uno");
+    EXPECT_EQ(*cache.find(1), "uno") << "Inserting an existing key must replace its value.";
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(LRUCacheTest, EvictLeastRecentlyUsed)
+{
+    LRUCache<int, int> cache(3);
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    cache.insert(3, 30);
+    EXPECT_NE(cache.find(1), nullptr); // Now 2 is the least recently used.
+
+    cache.insert(4, 40);
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_EQ(cache.find(2), nullptr) << "The least recently used entry must be evicted.";
+    EXPECT_NE(cache.find(1), nullptr);
+    EXPECT_NE(cache.find(3), nullptr);
+    EXPECT_NE(cache.find(4), nullptr);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.find(1), nullptr);
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
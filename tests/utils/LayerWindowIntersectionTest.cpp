@@ -0,0 +1,77 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/LayerWindowIntersection.h" // The file under test.
+
+#include <gtest/gtest.h>
+
+#include "Application.h"
+#include "geometry/Polygon.h"
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+class LayerWindowIntersectionTest : public testing::Test
+{
+public:
+    std::vector<Shape> layers;
+
+    void SetUp() override
+    {
+        Application::getInstance().startThreadPool();
+
+        // Rectangles that move around a bit from layer to layer, so that every window intersects to a different area.
+        for (coord_t layer_nr = 0; layer_nr < 23; ++layer_nr)
+        {
+            const coord_t shift = (layer_nr * 37) % 50;
+            Shape layer;
+            layer.push_back(Polygon({ { shift, 0 }, { shift + 1000, 0 }, { shift + 1000, 1000 - layer_nr * 10 }, { shift, 1000 - layer_nr * 10 } }, false));
+            layers.push_back(layer);
+        }
+    }
+
+    Shape intersectWindow(const size_t start, const size_t window_size) const
+    {
+        if (start + window_size > layers.size())
+        {
+            return {};
+        }
+        Shape result = layers[start];
+        for (size_t layer_nr = start + 1; layer_nr < start + window_size; ++layer_nr)
+        {
+            result = result.intersection(layers[layer_nr]);
+        }
+        return result;
+    }
+};
+
+TEST_F(LayerWindowIntersectionTest, SameAsSeparateIntersections)
+{
+    for (const size_t window_size : { 1, 2, 3, 5, 8, 23 })
+    {
+        const std::vector<Shape> windows = intersectLayerWindows(layers, window_size);
+        ASSERT_EQ(windows.size(), layers.size());
+        for (size_t start = 0; start < layers.size(); ++start)
+        {
+            EXPECT_EQ(windows[start].area(), intersectWindow(start, window_size).area()) << "Window of " << window_size << " layers from layer " << start << ".";
+        }
+    }
+}
+
+TEST_F(LayerWindowIntersectionTest, WindowsPastTheEnd)
+{
+    for (const size_t window_size : { 0, 24 })
+    {
+        const std::vector<Shape> windows = intersectLayerWindows(layers, window_size);
+        ASSERT_EQ(windows.size(), layers.size());
+        for (const Shape& window : windows)
+        {
+            EXPECT_TRUE(window.empty());
+        }
+    }
+    EXPECT_TRUE(intersectLayerWindows({}, 3).empty());
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
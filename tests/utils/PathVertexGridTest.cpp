@@ -0,0 +1,92 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/PathVertexGrid.h" // The file under test.
+
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+/*
+ * Find the path nearest to a point in the grid, by its vertices.
+ */
+size_t findNearestPath(PathVertexGrid& grid, const Point2LL& query_point)
+{
+    size_t best_path = std::numeric_limits<size_t>::max();
+    coord_t best_distance2 = std::numeric_limits<coord_t>::max();
+    grid.visitNearestFirst(
+        query_point,
+        [&](const PathVertexGrid::Vertex& vertex)
+        {
+            const coord_t distance2 = vSize2(vertex.point - query_point);
+            if (distance2 < best_distance2 || (distance2 == best_distance2 && vertex.path < best_path))
+            {
+                best_path = vertex.path;
+                best_distance2 = distance2;
+            }
+            return best_distance2;
+        });
+    return best_path;
+}
+
+TEST(PathVertexGridTest, NearbyPaths)
+{
+    PathVertexGrid grid({ { Point2LL(0, 0), 0 }, { Point2LL(100, 0), 0 }, { Point2LL(5, 5), 1 }, { Point2LL(1000, 1000), 2 }, { Point2LL(10, 0), 3 } }, 5);
+
+    EXPECT_EQ(grid.getNearbyPaths(Point2LL(0, 0), 10), std::vector<size_t>({ 0, 1, 3 }));
+    EXPECT_EQ(grid.getNearbyPaths(Point2LL(100, 0), 10), std::vector<size_t>({ 0 }));
+
+    grid.remove(1);
+    EXPECT_EQ(grid.getNearbyPaths(Point2LL(0, 0), 10), std::vector<size_t>({ 0, 3 })) << "Removed paths must not be found anymore.";
+}
+
+/*
+ * Removing the nearest path one by one must give the same sequence as a linear search would.
+ */
+TEST(PathVertexGridTest, NearestFirstMatchesLinearSearch)
+{
+    std::vector<PathVertexGrid::Vertex> vertices;
+    constexpr size_t path_count = 200;
+    for (size_t path = 0; path < path_count; ++path)
+    {
+        const coord_t x = static_cast<coord_t>((path * 7919) % 1000);
+        const coord_t y = static_cast<coord_t>((path * 104729) % 700);
+        vertices.push_back({ Point2LL(x, y), path });
+        vertices.push_back({ Point2LL(x + 30, y - 40), path });
+    }
+    PathVertexGrid grid(vertices, path_count + 1); // The last path has no vertices, so it is never found.
+
+    std::vector<bool> removed(path_count, false);
+    Point2LL position(-500, 300); // Starts outside of the grid.
+    for (size_t step = 0; step < path_count; ++step)
+    {
+        ASSERT_FALSE(grid.empty());
+
+        size_t expected_path = std::numeric_limits<size_t>::max();
+        coord_t expected_distance2 = std::numeric_limits<coord_t>::max();
+        for (const PathVertexGrid::Vertex& vertex : vertices)
+        {
+            const coord_t distance2 = vSize2(vertex.point - position);
+            if (! removed[vertex.path] && (distance2 < expected_distance2 || (distance2 == expected_distance2 && vertex.path < expected_path)))
+            {
+                expected_path = vertex.path;
+                expected_distance2 = distance2;
+            }
+        }
+
+        const size_t path = findNearestPath(grid, position);
+        ASSERT_EQ(path, expected_path) << "Step " << step;
+        grid.remove(path);
+        removed[path] = true;
+        position = vertices[path * 2 + 1].point;
+    }
+    EXPECT_TRUE(grid.empty());
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)
@@ -4,6 +4,7 @@
 #include "geometry/Polygon.h" // The class under test.
 
 #include <numbers>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -242,6 +243,180 @@ TEST_F(PolygonTest, differenceClockwiseTest)
     EXPECT_GT(area, 0) << "Inner polygon should be clockwise.";
 }
 
+TEST_F(PolygonTest, booleanDisjointTest)
+{
+    Shape square;
+    square.push_back(test_square);
+    Shape far_away;
+    far_away.push_back(small_area);
+    far_away.translate(Point2LL(1000, 1000));
+
+    EXPECT_EQ(square.difference(far_away).area(), square.area()) << "Subtracting a shape far away must leave the shape as it is.";
+    EXPECT_TRUE(square.intersection(far_away).empty()) << "Shapes that are far apart don't intersect.";
+
+    const Shape united = square.unionPolygons(far_away);
+    EXPECT_EQ(united.size(), 2);
+    EXPECT_EQ(united.area(), square.area() + far_away.area());
+}
+
+TEST_F(PolygonTest, booleanInsideRectangleTest)
+{
+    Shape pointy;
+    pointy.push_back(pointy_square);
+    Shape rectangle;
+    rectangle.push_back(Polygon({ { -10, -10 }, { 110, -10 }, { 110, 190 }, { -10, 190 } }, false));
+
+    EXPECT_EQ(pointy.intersection(rectangle).area(), pointy.area()) << "A rectangle around the shape must keep all of the shape.";
+    EXPECT_EQ(rectangle.intersection(pointy).area(), pointy.area());
+    EXPECT_TRUE(pointy.difference(rectangle).empty()) << "A rectangle around the shape must remove all of the shape.";
+
+    Shape triangle_around;
+    triangle_around.push_back(Polygon({ { -10, -10 }, { 1000, -10 }, { -10, 1000 } }, false));
+    Shape small;
+    small.push_back(small_area);
+    EXPECT_EQ(small.intersection(triangle_around).area(), small.area()) << "Only a rectangle covers its whole bounding box, but this triangle covers the shape.";
+    EXPECT_EQ(pointy.intersection(triangle_around).area(), pointy.area() - pointy.difference(triangle_around).area());
+}
+
+TEST_F(PolygonTest, unionAllTest)
+{
+    std::vector<Shape> squares;
+    for (coord_t offset = 0; offset <= 200; offset += 50)
+    {
+        Shape square;
+        square.push_back(test_square);
+        square.translate(Point2LL(offset, 0));
+        squares.push_back(square);
+    }
+    const Shape united = Shape::unionAll(squares);
+    EXPECT_EQ(united.size(), 1) << "Overlapping squares must be merged into one polygon.";
+    EXPECT_EQ(united.area(), 300 * 100);
+
+    Shape sequential;
+    for (const Shape& square : squares)
+    {
+        sequential = sequential.unionPolygons(square);
+    }
+    EXPECT_EQ(united.area(), sequential.area());
+
+    EXPECT_TRUE(Shape::unionAll(std::vector<Shape>{}).empty());
+    EXPECT_EQ(Shape::unionAll({ &squares[0] }).area(), squares[0].area());
+}
+
+TEST_F(PolygonTest, differenceAllTest)
+{
+    Shape square;
+    square.push_back(test_square);
+
+    Shape left;
+    left.push_back(Polygon({ { -10, -10 }, { 30, -10 }, { 30, 110 }, { -10, 110 } }, false));
+    Shape right;
+    right.push_back(Polygon({ { 20, -10 }, { 110, -10 }, { 110, 50 }, { 20, 50 } }, false));
+    Shape far_away;
+    far_away.push_back(small_area);
+    far_away.translate(Point2LL(1000, 1000));
+    Shape donut; // Subtracting this removes a frame of 10 wide around the middle, and the overlapping inner polygon must be read as a hole.
+    donut.push_back(Polygon({ { 40, 40 }, { 90, 40 }, { 90, 90 }, { 40, 90 } }, false));
+    donut.push_back(Polygon({ { 50, 50 }, { 80, 50 }, { 80, 80 }, { 50, 80 } }, false));
+
+    Shape clockwise; // Overlaps with the left shape, which must not cancel it out.
+    clockwise.push_back(Polygon({ { 0, 60 }, { 0, 100 }, { 40, 100 }, { 40, 60 } }, false));
+
+    const std::vector<Shape> others{ left, right, far_away, donut, clockwise };
+    Shape sequential = square;
+    for (const Shape& other : others)
+    {
+        sequential = sequential.difference(other);
+    }
+    const Shape batched = square.differenceAll(others);
+    EXPECT_EQ(batched.area(), sequential.area());
+    EXPECT_EQ(batched.area(), 70 * 50 - (50 * 40 - 30 * 30) - 10 * 40);
+    EXPECT_EQ(square.differenceAll(std::vector<Shape>{ far_away }).area(), square.area());
+
+    // The lobes of a figure-8 wind in opposite directions, which must not cancel out the shape it overlaps with either.
+    Shape figure_eight;
+    figure_eight.push_back(Polygon({ { 10, 60 }, { 50, 100 }, { 50, 60 }, { 10, 100 } }, false));
+    Shape figure_eight_reversed = figure_eight;
+    figure_eight_reversed.front().reverse();
+    for (const Shape& eight : { figure_eight, figure_eight_reversed })
+    {
+        EXPECT_EQ(square.differenceAll(std::vector<Shape>{ left, eight }).area(), square.difference(left).difference(eight).area());
+        EXPECT_EQ(square.differenceAll(std::vector<Shape>{ left, eight }).area(), 70 * 100 - 20 * 40 / 2);
+    }
+
+    Shape clockwise_square = square;
+    clockwise_square.front().reverse();
+    EXPECT_EQ(clockwise_square.differenceAll(std::vector<Shape>{ far_away }).area(), clockwise_square.difference(far_away).area())
+        << "Like difference(), the shape must be cleaned up even if nothing overlaps with it.";
+    EXPECT_EQ(clockwise_square.differenceAll(std::vector<Shape>{ Shape() }).area(), clockwise_square.area()) << "Without anything to subtract, the shape stays as it is.";
+}
+
+/*
+ * The shortcuts that skip Clipper must give the same result as Clipper, also for input that Clipper would clean up.
+ */
+TEST_F(PolygonTest, booleanShortcutsMatchClipperTest)
+{
+    const auto clip = [](const Shape& subject, const Shape& clip, const ClipperLib::ClipType clip_type, const ClipperLib::PolyFillType fill_type)
+    {
+        ClipperLib::Clipper clipper(clipper_init);
+        for (const Polygon& polygon : subject)
+        {
+            clipper.AddPath(polygon.getPoints(), ClipperLib::ptSubject, true);
+        }
+        for (const Polygon& polygon : clip)
+        {
+            clipper.AddPath(polygon.getPoints(), ClipperLib::ptClip, true);
+        }
+        ClipperLib::Paths result;
+        clipper.Execute(clip_type, result, fill_type, fill_type);
+        return Shape(std::move(result));
+    };
+    const auto expect_same = [](const Shape& result, const Shape& expected, const std::string& description)
+    {
+        EXPECT_EQ(result.size(), expected.size()) << description;
+        EXPECT_EQ(result.area(), expected.area()) << description;
+    };
+
+    Shape clockwise;
+    clockwise.push_back(test_square);
+    clockwise.front().reverse();
+    Shape self_overlapping; // Goes around the square twice, which covers nothing with the even-odd fill rule.
+    self_overlapping.push_back(test_square);
+    self_overlapping.front().insert(self_overlapping.front().end(), test_square.begin(), test_square.end());
+    Shape rectangle;
+    rectangle.push_back(Polygon({ { -10, -10 }, { 110, -10 }, { 110, 110 }, { -10, 110 } }, false));
+    Shape far_away;
+    far_away.push_back(small_area);
+    far_away.translate(Point2LL(1000, 1000));
+
+    for (const auto& [shape, name] : { std::make_pair(clockwise, "clockwise"), std::make_pair(self_overlapping, "self-overlapping") })
+    {
+        const std::string description(name);
+        expect_same(shape.intersection(rectangle), clip(shape, rectangle, ClipperLib::ctIntersection, ClipperLib::pftEvenOdd), description + " inside rectangle");
+        expect_same(rectangle.intersection(shape), clip(rectangle, shape, ClipperLib::ctIntersection, ClipperLib::pftEvenOdd), description + " around rectangle");
+        expect_same(shape.difference(rectangle), clip(shape, rectangle, ClipperLib::ctDifference, ClipperLib::pftEvenOdd), description + " minus rectangle");
+        expect_same(shape.difference(far_away), clip(shape, far_away, ClipperLib::ctDifference, ClipperLib::pftEvenOdd), description + " minus far away");
+        expect_same(shape.unionPolygons(far_away), clip(shape, far_away, ClipperLib::ctUnion, ClipperLib::pftNonZero), description + " union far away");
+    }
+}
+
+TEST_F(PolygonTest, booleanPartlyOverlappingTest)
+{
+    Shape squares;
+    squares.push_back(test_square);
+    Shape far_square;
+    far_square.push_back(test_square);
+    far_square.translate(Point2LL(1000, 0));
+    squares.push_back(far_square);
+
+    Shape clip;
+    clip.push_back(small_area);
+    clip.translate(Point2LL(95, 45));
+
+    EXPECT_EQ(squares.intersection(clip).area(), 5 * 10) << "Only the overlapping part of the nearby square must remain.";
+    EXPECT_EQ(squares.difference(clip).area(), squares.area() - 5 * 10);
+}
+
 /*
  * The convex hull of a cube should still be a cube
  */
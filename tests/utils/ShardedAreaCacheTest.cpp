@@ -0,0 +1,175 @@
+// Copyright (c) 2024 UltiMaker
+// CuraEngine is released under the terms of the AGPLv3 or higher.
+
+#include "utils/ShardedAreaCache.h" // The file under test.
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// NOLINTBEGIN(*-magic-numbers)
+namespace cura
+{
+
+Shape makeSquare(const coord_t size)
+{
+    Polygon polygon;
+    polygon.emplace_back(0, 0);
+    polygon.emplace_back(size, 0);
+    polygon.emplace_back(size, size);
+    polygon.emplace_back(0, size);
+    return Shape(std::vector<Polygon>{ polygon });
+}
+
+TEST(ShardedAreaCacheTest, FindInserted)
+{
+    ShardedAreaCache<int> cache;
+    EXPECT_FALSE(cache.find(1));
+
+    std::vector<std::pair<int, Shape>> areas{ { 1, makeSquare(10) }, { 2, makeSquare(20) } };
+    cache.insert(areas.begin(), areas.end());
+    ASSERT_TRUE(cache.find(1));
+    EXPECT_EQ(cache.find(1)->get()[0][1].X, 10);
+    EXPECT_EQ(cache.find(2)->get()[0][1].X, 20);
+    EXPECT_FALSE(cache.contains(3));
+
+    cache.insert(1, makeSquare(30));
+    EXPECT_EQ(cache.find(1)->get()[0][1].X, 10) << "Inserting an existing key must keep its area.";
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.getMemoryUsage(), 2 * (sizeof(Shape) + sizeof(Polygon) + 4 * sizeof(Point2LL)));
+}
+
+TEST(ShardedAreaCacheTest, InsertAfterFreeze)
+{
+    ShardedAreaCache<int> cache;
+    cache.insert(1, makeSquare(10));
+    const Shape& frozen_area = cache.find(1)->get();
+    cache.freeze();
+
+    cache.insert(2, makeSquare(20));
+    cache.insert(1, makeSquare(30));
+    EXPECT_EQ(&cache.find(1)->get(), &frozen_area) << "Freezing must keep the areas in place.";
+    EXPECT_EQ(cache.find(1)->get()[0][1].X, 10);
+    ASSERT_TRUE(cache.find(2));
+    EXPECT_EQ(cache.find(2)->get()[0][1].X, 20);
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(ShardedAreaCacheTest, SpillAndReload)
+{
+    AreaSpillStore store(false);
+    ShardedAreaCache<int> cache;
+    cache.enableSpilling(&store);
+    for (int key = 0; key < 10; ++key)
+    {
+        cache.insert(key, makeSquare(key + 1));
+    }
+    cache.freeze();
+    const size_t bytes_before = cache.getMemoryUsage();
+
+    const size_t freed = cache.spill(
+        [](const int key)
+        {
+            return key >= 5;
+        });
+    EXPECT_EQ(freed, bytes_before / 2);
+    EXPECT_EQ(cache.getMemoryUsage(), bytes_before / 2);
+    EXPECT_EQ(cache.size(), 5);
+    EXPECT_EQ(cache.getSpilledCount(), 5);
+    EXPECT_GT(store.getBytes(), 0);
+
+    for (int key = 0; key < 10; ++key)
+    {
+        EXPECT_TRUE(cache.contains(key));
+    }
+    EXPECT_FALSE(cache.contains(10));
+    EXPECT_EQ(cache.getReloads(), 0) << "Checking whether a key has an area must not load it back.";
+    EXPECT_EQ(cache.getSpilledCount(), 5);
+
+    for (int key = 0; key < 10; ++key)
+    {
+        ASSERT_TRUE(cache.find(key)) << "Spilled areas must be loaded back when looked up.";
+        EXPECT_EQ(cache.find(key)->get()[0][2], Point2LL(key + 1, key + 1));
+    }
+    EXPECT_EQ(cache.getReloads(), 5);
+    EXPECT_EQ(cache.getSpilledCount(), 0);
+    EXPECT_EQ(cache.getMemoryUsage(), bytes_before);
+    EXPECT_EQ(store.getBytes(), 0);
+    EXPECT_FALSE(cache.find(10));
+    EXPECT_EQ(cache.getMisses(), 1);
+}
+
+TEST(ShardedAreaCacheTest, ConcurrentInsertAndFind)
+{
+    ShardedAreaCache<int> cache;
+    constexpr int thread_count = 8;
+    constexpr int keys_per_thread = 500;
+
+    std::vector<std::thread> threads;
+    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx)
+    {
+        threads.emplace_back(
+            [&cache, thread_idx]()
+            {
+                for (int key = thread_idx * keys_per_thread; key < (thread_idx + 1) * keys_per_thread; ++key)
+                {
+                    cache.insert(key, makeSquare(key + 1));
+                    EXPECT_TRUE(cache.contains(key));
+                    cache.contains(key / 2); // Read what other threads may be writing.
+                }
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(cache.size(), thread_count * keys_per_thread);
+    for (int key = 0; key < thread_count * keys_per_thread; ++key)
+    {
+        ASSERT_TRUE(cache.find(key));
+        EXPECT_EQ(cache.find(key)->get()[0][1].X, key + 1);
+    }
+}
+
+TEST(ShardedAreaCacheTest, ConcurrentReload)
+{
+    AreaSpillStore store(false);
+    ShardedAreaCache<int> cache;
+    cache.enableSpilling(&store);
+    constexpr int key_count = 200;
+    for (int key = 0; key < key_count; ++key)
+    {
+        cache.insert(key, makeSquare(key + 1));
+    }
+    cache.freeze();
+    cache.spill(
+        [](const int)
+        {
+            return true;
+        });
+
+    std::vector<std::thread> threads;
+    for (int thread_idx = 0; thread_idx < 8; ++thread_idx)
+    {
+        threads.emplace_back(
+            [&cache]()
+            {
+                for (int key = 0; key < key_count; ++key)
+                {
+                    const auto area = cache.find(key);
+                    ASSERT_TRUE(area);
+                    EXPECT_EQ(area->get()[0][1].X, key + 1);
+                }
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(cache.getReloads(), key_count) << "Each spilled area must be loaded back only once.";
+}
+
+} // namespace cura
+// NOLINTEND(*-magic-numbers)